@@ -0,0 +1,260 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Batch link budget of the scenarios of one or more scenario files.
+ *
+ * For every satellite and ground station pair of the files it computes the
+ * pass list and the link budget of each time step of the observation and
+ * writes them as CSV tables. It runs without a flowgraph and all the
+ * scenarios share the same parameter sweep, so the geometry and the
+ * attenuation of the scenarios that agree on them are computed once. See
+ * gr::leo::scenario::load() for the format of the files.
+ */
+
+#include <gnuradio/leo/scenario.h>
+#include <gnuradio/leo/sweep.h>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace gr::leo;
+
+namespace {
+
+const double RAD_TO_DEG = 180.0 / 3.14159265358979323846;
+
+void
+usage(const char *prog)
+{
+  fprintf(stderr,
+          "Usage: %s [options] SCENARIO_FILE...\n"
+          "  --threads N            number of threads, 0 for all (default 0)\n"
+          "  --output-dir DIR       write NAME.passes.csv and NAME.budget.csv\n"
+          "                         per scenario, instead of two tables on\n"
+          "                         stdout\n"
+          "  --pass-step S          step of the pass search in seconds\n"
+          "                         (default 60)\n"
+          "  --threshold DB         link margin of the outage (default 0)\n"
+          "  --all-steps            write the time steps without visibility\n"
+          "  --quiet                do not print the summary on stderr\n",
+          prog);
+}
+
+/* Keep the scenario names usable as file names */
+std::string
+file_name(const std::string &name)
+{
+  std::string f(name);
+  for (char &c : f) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '.') {
+      c = '_';
+    }
+  }
+  return f;
+}
+
+class output_file {
+public:
+  output_file(const std::string &path) :
+    d_file(path.empty() ? stdout : std::fopen(path.c_str(), "w"))
+  {
+    if (!d_file) {
+      throw std::runtime_error("Cannot open " + path);
+    }
+  }
+
+  ~output_file()
+  {
+    if (d_file != stdout) {
+      std::fclose(d_file);
+    }
+  }
+
+  FILE *
+  get() const
+  {
+    return d_file;
+  }
+
+private:
+  FILE *d_file;
+};
+
+void
+write_passes_header(FILE *f)
+{
+  fprintf(f, "scenario,aos_us,los_us,max_elevation_time_us,"
+          "max_elevation_deg,aos_azimuth_deg,los_azimuth_deg\n");
+}
+
+void
+write_passes(FILE *f, const std::string &name,
+             const std::vector<pass_info_t> &passes)
+{
+  for (const pass_info_t &p : passes) {
+    fprintf(f, "%s,%lld,%lld,%lld,%.4f,%.4f,%.4f\n", name.c_str(),
+            static_cast<long long>(p.aos), static_cast<long long>(p.los),
+            static_cast<long long>(p.max_elevation_time),
+            p.max_elevation * RAD_TO_DEG, p.aos_azimuth * RAD_TO_DEG,
+            p.los_azimuth * RAD_TO_DEG);
+  }
+}
+
+void
+write_budget_header(FILE *f)
+{
+  fprintf(f, "scenario,time_us,azimuth_deg,elevation_deg,slant_range_km,"
+          "doppler_hz,attenuation_db,link_margin_db\n");
+}
+
+void
+write_budget(FILE *f, const std::string &name, const link_timeline_t &t)
+{
+  for (size_t k = 0; k < t.time.size(); k++) {
+    fprintf(f, "%s,%lld,%.4f,%.4f,%.4f,%.3f,%.4f,%.4f\n", name.c_str(),
+            static_cast<long long>(t.time[k]), t.azimuth[k], t.elevation[k],
+            t.slant_range[k], t.doppler_shift[k], t.attenuation[k],
+            t.link_margin[k]);
+  }
+}
+
+} // namespace
+
+int
+main(int argc, char **argv)
+{
+  size_t nthreads = 0;
+  std::string output_dir;
+  int pass_step = 60;
+  double threshold = 0;
+  bool visible_only = true;
+  bool quiet = false;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string opt(argv[i]);
+    if (opt == "--all-steps") {
+      visible_only = false;
+    }
+    else if (opt == "--quiet") {
+      quiet = true;
+    }
+    else if (opt.compare(0, 2, "--") != 0) {
+      files.push_back(opt);
+    }
+    else if (i + 1 >= argc) {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    else if (opt == "--threads") {
+      const char *arg = argv[++i];
+      char *end;
+      nthreads = std::strtoul(arg, &end, 10);
+      if (end == arg || *end != '\0' || arg[0] == '-') {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+    else if (opt == "--output-dir") {
+      output_dir = argv[++i];
+    }
+    else if (opt == "--pass-step") {
+      pass_step = std::atoi(argv[++i]);
+    }
+    else if (opt == "--threshold") {
+      threshold = std::atof(argv[++i]);
+    }
+    else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (files.empty() || pass_step <= 0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  try {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<scenario_t> scenarios;
+    for (const std::string &f : files) {
+      const std::vector<scenario_t> s = scenario::load(f);
+      scenarios.insert(scenarios.end(), s.begin(), s.end());
+    }
+
+    sweep::sweep_sptr sw = sweep::make(scenarios, threshold);
+    sw->run(nthreads);
+    const std::vector<std::vector<pass_info_t>> passes =
+      sw->get_passes(pass_step, nthreads);
+
+    if (output_dir.empty()) {
+      write_passes_header(stdout);
+      for (size_t i = 0; i < scenarios.size(); i++) {
+        write_passes(stdout, scenarios[i].name, passes[i]);
+      }
+      fprintf(stdout, "\n");
+      write_budget_header(stdout);
+      for (size_t i = 0; i < scenarios.size(); i++) {
+        write_budget(stdout, scenarios[i].name,
+                     sw->get_timeline(i, visible_only));
+      }
+    }
+    else {
+      for (size_t i = 0; i < scenarios.size(); i++) {
+        const std::string base = output_dir + "/"
+                                 + file_name(scenarios[i].name);
+        output_file p(base + ".passes.csv");
+        write_passes_header(p.get());
+        write_passes(p.get(), scenarios[i].name, passes[i]);
+        output_file b(base + ".budget.csv");
+        write_budget_header(b.get());
+        write_budget(b.get(), scenarios[i].name,
+                     sw->get_timeline(i, visible_only));
+      }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    if (!quiet) {
+      const std::vector<sweep_result_t> results = sw->get_results();
+      for (size_t i = 0; i < scenarios.size(); i++) {
+        fprintf(stderr, "%-30s passes=%zu visible_steps=%llu "
+                "min_margin=%.2f mean_margin=%.2f outage=%.4f\n",
+                scenarios[i].name.c_str(), passes[i].size(),
+                static_cast<unsigned long long>(results[i].visible_steps),
+                results[i].min_link_margin, results[i].mean_link_margin,
+                results[i].outage_fraction);
+      }
+      fprintf(stderr, "scenarios=%zu geometries=%zu attenuations=%zu "
+              "wall_time_s=%.3f\n", scenarios.size(),
+              sw->get_geometry_count(), sw->get_attenuation_count(),
+              std::chrono::duration<double>(end - start).count());
+    }
+  }
+  catch (const std::exception &e) {
+    fprintf(stderr, "%s: %s\n", argv[0], e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Monte-Carlo simulation of the link margin of a LEO pass.
+ *
+ * It runs many realizations of each scenario of a scenario file, like
+ * examples/upsat_leo.ini, perturbing the rainfall rate, the pointing error
+ * of the ground station antenna and the TLE epoch, and reports the
+ * statistics of the link margin and of the outages. See
+ * gr::leo::scenario::load() for the format of the file.
+ */
+
+#include <gnuradio/leo/monte_carlo.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <vector>
+
+using namespace gr::leo;
+
+namespace {
+
+void
+usage(const char *prog)
+{
+  fprintf(stderr,
+          "Usage: %s [options] SCENARIO_FILE\n"
+          "  --realizations N       number of realizations (default 1000)\n"
+          "  --threads N            number of threads, 0 for all (default 0)\n"
+          "  --seed N               seed of the simulation (default 0)\n"
+          "  --threshold DB         link margin of the outage (default 0)\n"
+          "  --rain-sigma S         spread of the log of the rainfall rate\n"
+          "  --pointing-sigma DEG   spread of the pointing error\n"
+          "  --epoch-sigma SEC      spread of the TLE epoch\n",
+          prog);
+}
+
+void
+print_statistics(const char *name, const link_statistics_t &s)
+{
+  printf("%-22s n=%llu mean=%.3f std=%.3f min=%.3f p5=%.3f p50=%.3f "
+         "p95=%.3f max=%.3f\n", name, static_cast<unsigned long long>(s.count),
+         s.mean, s.stddev, s.min, s.percentiles[0], s.percentiles[1],
+         s.percentiles[2], s.max);
+}
+
+} // namespace
+
+int
+main(int argc, char **argv)
+{
+  perturbation_t p;
+  size_t realizations = 1000;
+  size_t nthreads = 0;
+  unsigned int seed = 0;
+  double threshold = 0;
+  std::string filename;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string opt(argv[i]);
+    if (opt.compare(0, 2, "--") != 0) {
+      if (!filename.empty()) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      filename = opt;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    const double val = std::atof(argv[++i]);
+    if (opt == "--realizations") {
+      realizations = static_cast<size_t>(val);
+    }
+    else if (opt == "--threads") {
+      nthreads = static_cast<size_t>(val);
+    }
+    else if (opt == "--seed") {
+      seed = static_cast<unsigned int>(val);
+    }
+    else if (opt == "--threshold") {
+      threshold = val;
+    }
+    else if (opt == "--rain-sigma") {
+      p.rainfall_rate_sigma = val;
+    }
+    else if (opt == "--pointing-sigma") {
+      p.pointing_error_sigma = val;
+    }
+    else if (opt == "--epoch-sigma") {
+      p.tle_epoch_sigma = val;
+    }
+    else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (filename.empty()) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  try {
+    for (const scenario_t &s : scenario::load(filename)) {
+      monte_carlo::monte_carlo_sptr mc = monte_carlo::make(s, p, realizations,
+                                         threshold, seed);
+      const auto start = std::chrono::steady_clock::now();
+      mc->run(nthreads);
+      const auto end = std::chrono::steady_clock::now();
+
+      printf("scenario:              %s\n", s.name.c_str());
+      printf("realizations:          %zu\n", realizations);
+      printf("passes:                %zu\n", mc->get_passes());
+      printf("wall time (s):         %.3f\n",
+             std::chrono::duration<double>(end - start).count());
+      print_statistics("link margin (dB):", mc->get_link_margin());
+      print_statistics("min link margin (dB):", mc->get_min_link_margin());
+      print_statistics("outage fraction:", mc->get_outage_fraction());
+      printf("outage probability:    %.4f\n", mc->get_outage_probability());
+    }
+  }
+  catch (const std::exception &e) {
+    fprintf(stderr, "%s: %s\n", argv[0], e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,240 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * End-to-end throughput harness of the channel model block.
+ *
+ * It runs a null_source -> channel_model -> head -> null_sink flowgraph
+ * for a fixed number of samples and reports the throughput, the
+ * percentiles of the work() execution time and the consumed CPU time.
+ * The presets mirror the examples/upsat_leo flowgraph, so results are
+ * comparable across releases and machines.
+ */
+
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/leo/channel_model.h>
+#include <gnuradio/leo/dipole_antenna.h>
+#include <gnuradio/leo/leo_model.h>
+#include <gnuradio/leo/satellite.h>
+#include <gnuradio/leo/tracker.h>
+#include <gnuradio/leo/yagi_antenna.h>
+#include <gnuradio/top_block.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace gr::leo;
+
+namespace {
+
+typedef struct {
+  const char *name;
+  double samp_rate;
+  double time_resolution_us;
+  impairment_enum_t fspl;
+  impairment_enum_t pointing;
+  impairment_enum_t doppler;
+  impairment_enum_t atmo;
+  impairment_enum_t precipitation;
+  bool link_margin;
+  noise_t noise;
+} config_t;
+
+/*
+ * upsat: the examples/upsat_leo flowgraph
+ * upsat_itu: the same with the ITU atmospheric and precipitation models
+ * minimal: path loss and Doppler only, the lower bound of the block cost
+ */
+const config_t presets[] = {
+  {
+    "upsat", 48e3, 1000, FREE_SPACE_PATH_LOSS, IMPAIRMENT_NONE, DOPPLER_SHIFT,
+    ATMO_GASES_REGRESSION, PRECIPITATION_CUSTOM, true, WHITE_GAUSSIAN
+  },
+  {
+    "upsat_itu", 48e3, 1000, FREE_SPACE_PATH_LOSS, ANTENNA_POINTING_LOSS,
+    DOPPLER_SHIFT, ATMO_GASES_ITU, PRECIPITATION_ITU, true, WHITE_GAUSSIAN
+  },
+  {
+    "minimal", 48e3, 1000, FREE_SPACE_PATH_LOSS, IMPAIRMENT_NONE, DOPPLER_SHIFT,
+    IMPAIRMENT_NONE, IMPAIRMENT_NONE, false, NOISE_NONE
+  }
+};
+
+void
+usage(const char *prog)
+{
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  --preset NAME          upsat (default), upsat_itu or minimal\n"
+          "  --samples N            number of samples to process (default 10e6)\n"
+          "  --samp-rate SPS        sampling rate of the channel model\n"
+          "  --time-res-us US       time resolution of the tracker\n"
+          "  --atmo ENUM            atmospheric gases impairment (0, 1, 2, 9)\n"
+          "  --precipitation ENUM   precipitation impairment (0, 3, 4, 10)\n"
+          "  --pointing ENUM        antenna pointing loss (0, 6, 11)\n"
+          "  --doppler ENUM         Doppler shift (0, 7)\n"
+          "  --noise ENUM           noise type (0, 1)\n"
+          "  --precompute N         number of precomputed time windows\n",
+          prog);
+}
+
+const config_t *
+find_preset(const std::string &name)
+{
+  for (const config_t &c : presets) {
+    if (name == c.name) {
+      return &c;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+int
+main(int argc, char **argv)
+{
+  config_t cfg = presets[0];
+  double nsamples = 10e6;
+  size_t precompute = 0;
+
+  /* The preset is applied first, so the rest of the options override it */
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::string(argv[i]) == "--preset") {
+      const config_t *p = find_preset(argv[i + 1]);
+      if (!p) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      cfg = *p;
+    }
+  }
+  for (int i = 1; i < argc; i += 2) {
+    const std::string opt(argv[i]);
+    if (i + 1 >= argc) {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    const double val = std::atof(argv[i + 1]);
+    if (opt == "--preset") {
+      continue;
+    }
+    else if (opt == "--samples") {
+      nsamples = val;
+    }
+    else if (opt == "--samp-rate") {
+      cfg.samp_rate = val;
+    }
+    else if (opt == "--time-res-us") {
+      cfg.time_resolution_us = val;
+    }
+    else if (opt == "--atmo") {
+      cfg.atmo = static_cast<impairment_enum_t>(val);
+    }
+    else if (opt == "--precipitation") {
+      cfg.precipitation = static_cast<impairment_enum_t>(val);
+    }
+    else if (opt == "--pointing") {
+      cfg.pointing = static_cast<impairment_enum_t>(val);
+    }
+    else if (opt == "--doppler") {
+      cfg.doppler = static_cast<impairment_enum_t>(val);
+    }
+    else if (opt == "--noise") {
+      cfg.noise = static_cast<noise_t>(val);
+    }
+    else if (opt == "--precompute") {
+      precompute = static_cast<size_t>(val);
+    }
+    else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* The UPSAT example: ISS TLE, ground station at Chania */
+  const double freq = 435e6;
+  generic_antenna::generic_antenna_sptr sat_ant =
+    antenna::dipole_antenna::make(DIPOLE, freq, LINEAR_VERTICAL, 0);
+  generic_antenna::generic_antenna_sptr gs_ant =
+    antenna::yagi_antenna::make(YAGI, freq, RHCP, 0, 2.35);
+  satellite::satellite_sptr sat = satellite::make("UPSAT",
+                                  "1 25544U 98067A   18268.52547184  .00016717  00000-0  10270-3 0  9019",
+                                  "2 25544  51.6373 238.6885 0003885 206.9748 153.1203 15.53729445 14114",
+                                  freq, freq, 30, sat_ant, sat_ant, 5, 290, cfg.samp_rate);
+  tracker::tracker_sptr trk = tracker::make(sat, 35.3333, 25.1833, 0.1,
+                              "2018-09-25T15:48:25", "2018-09-25T15:58:35",
+                              cfg.time_resolution_us, freq, freq, 30,
+                              gs_ant, gs_ant, 1, 290, cfg.samp_rate);
+  generic_model::generic_model_sptr model = model::leo_model::make(trk,
+      DOWNLINK, cfg.fspl, cfg.pointing, cfg.doppler, cfg.atmo,
+      cfg.precipitation, cfg.link_margin, 7.5, 20, 90);
+
+  gr::top_block_sptr tb = gr::make_top_block("bench_channel_model");
+  gr::blocks::null_source::sptr src = gr::blocks::null_source::make(
+                                        sizeof(gr_complex));
+  channel_model::sptr chan = channel_model::make(cfg.samp_rate, model,
+                             cfg.noise, false, "", LOS_SIMULATE, 1.0,
+                             TIME_SIMULATED, precompute);
+  gr::blocks::head::sptr head = gr::blocks::head::make(sizeof(gr_complex),
+                                static_cast<uint64_t>(nsamples));
+  gr::blocks::null_sink::sptr sink = gr::blocks::null_sink::make(
+                                       sizeof(gr_complex));
+  tb->connect(src, 0, chan, 0);
+  tb->connect(chan, 0, head, 0);
+  tb->connect(head, 0, sink, 0);
+
+  const std::clock_t cpu_start = std::clock();
+  const auto start = std::chrono::steady_clock::now();
+  tb->run();
+  const auto end = std::chrono::steady_clock::now();
+  const std::clock_t cpu_end = std::clock();
+
+  const double wall_s = std::chrono::duration<double>(end - start).count();
+  const double cpu_s = static_cast<double>(cpu_end - cpu_start) /
+                       CLOCKS_PER_SEC;
+  const double produced = static_cast<double>(chan->nitems_written(0));
+
+  printf("preset:              %s\n", cfg.name);
+  printf("samples:             %.0f\n", produced);
+  printf("wall time (s):       %.3f\n", wall_s);
+  printf("cpu time (s):        %.3f\n", cpu_s);
+  printf("throughput (MS/s):   %.3f\n", produced / wall_s / 1e6);
+  if (chan->work_latency_count() == 0) {
+    printf("work() latency:      not measured, build with ENABLE_PROFILING\n");
+    return EXIT_SUCCESS;
+  }
+  const std::vector<double> pct =
+    chan->work_latency_percentiles({50, 90, 99, 99.9, 100});
+  printf("work() calls:        %llu\n",
+         static_cast<unsigned long long>(chan->work_latency_count()));
+  printf("work() p50 (us):     %.1f\n", pct[0]);
+  printf("work() p90 (us):     %.1f\n", pct[1]);
+  printf("work() p99 (us):     %.1f\n", pct[2]);
+  printf("work() p99.9 (us):   %.1f\n", pct[3]);
+  printf("work() max (us):     %.1f\n", pct[4]);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,348 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gnuradio/leo/antenna_pointing_loss.h>
+#include <gnuradio/leo/atmospheric_gases_itu.h>
+#include <gnuradio/leo/atmospheric_gases_regression.h>
+#include <gnuradio/leo/atmospheric_gases_itu_annex2.h>
+#include <gnuradio/leo/custom_antenna.h>
+#include <gnuradio/leo/dipole_antenna.h>
+#include <gnuradio/leo/free_space_path_loss.h>
+#include <gnuradio/leo/generic_attenuation.h>
+#include <gnuradio/leo/helix_antenna.h>
+#include <gnuradio/leo/leo_model.h>
+#include <gnuradio/leo/monopole_antenna.h>
+#include <gnuradio/leo/parabolic_reflector_antenna.h>
+#include <gnuradio/leo/precipitation_itu.h>
+#include <gnuradio/leo/quadrifilar_helix_antenna.h>
+#include <gnuradio/leo/satellite.h>
+#include <gnuradio/leo/tracker.h>
+#include <gnuradio/leo/white_gaussian_noise.h>
+#include <gnuradio/leo/yagi_antenna.h>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace gr::leo;
+
+namespace {
+
+/*
+ * A 10 minutes ISS pass over Chania, the same scenario with the UPSAT
+ * example flowgraph
+ */
+const char *tle_title = "ISS";
+const char *tle_1 =
+  "1 25544U 98067A   18268.52547184  .00016717  00000-0  10270-3 0  9019";
+const char *tle_2 =
+  "2 25544  51.6373 238.6885 0003885 206.9748 153.1203 15.53729445 14114";
+const char *obs_start = "2018-09-25T15:48:25";
+const char *obs_end = "2018-09-25T15:58:35";
+const double freq = 435e6;
+
+tracker::tracker_sptr
+make_tracker(double time_resolution_us = 1000)
+{
+  generic_antenna::generic_antenna_sptr sat_ant =
+    antenna::dipole_antenna::make(DIPOLE, freq, LINEAR_VERTICAL, 0);
+  generic_antenna::generic_antenna_sptr gs_ant =
+    antenna::yagi_antenna::make(YAGI, freq, RHCP, 0, 2.35);
+  satellite::satellite_sptr sat = satellite::make(tle_title, tle_1, tle_2,
+                                  freq, freq, 30, sat_ant, sat_ant,
+                                  5, 290, 10e3);
+  return tracker::make(sat, 35.3333, 25.1833, 0.1, obs_start, obs_end,
+                       time_resolution_us, freq, freq, 30, gs_ant, gs_ant,
+                       1, 290, 10e3);
+}
+
+/* A typical mid-pass geometry for the attenuation models */
+void
+set_geometry()
+{
+  generic_attenuation::set_frequency(freq);
+  generic_attenuation::set_elevation_angle(0.52);
+  generic_attenuation::set_slant_range(800);
+  generic_attenuation::set_polarization(RHCP);
+}
+
+void
+run_attenuation(benchmark::State &state,
+                generic_attenuation::generic_attenuation_sptr att)
+{
+  set_geometry();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(att->get_attenuation());
+  }
+}
+
+void
+run_rolloff(benchmark::State &state, generic_antenna::generic_antenna_sptr ant)
+{
+  ant->set_pointing_error(0.1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ant->get_gain_rolloff());
+  }
+}
+
+} // namespace
+
+/*
+ * Attenuation models
+ */
+static void
+BM_atmospheric_gases_itu(benchmark::State &state)
+{
+  run_attenuation(state, attenuation::atmospheric_gases_itu::make(7.5));
+}
+BENCHMARK(BM_atmospheric_gases_itu);
+
+static void
+BM_atmospheric_gases_regression(benchmark::State &state)
+{
+  run_attenuation(state,
+                  attenuation::atmospheric_gases_regression::make(7.5, 20));
+}
+BENCHMARK(BM_atmospheric_gases_regression);
+
+static void
+BM_atmospheric_gases_itu_annex2(benchmark::State &state)
+{
+  run_attenuation(state,
+                  attenuation::atmospheric_gases_itu_annex2::make(7.5, 20));
+}
+BENCHMARK(BM_atmospheric_gases_itu_annex2);
+
+static void
+BM_precipitation_itu(benchmark::State &state)
+{
+  run_attenuation(state, attenuation::precipitation_itu::make(
+                    25, 25.1833, 35.3333, 0.1, PRECIPITATION_ITU));
+}
+BENCHMARK(BM_precipitation_itu);
+
+static void
+BM_precipitation_custom(benchmark::State &state)
+{
+  run_attenuation(state, attenuation::precipitation_itu::make(
+                    25, 25.1833, 35.3333, 0.1, PRECIPITATION_CUSTOM));
+}
+BENCHMARK(BM_precipitation_custom);
+
+static void
+BM_free_space_path_loss(benchmark::State &state)
+{
+  run_attenuation(state, attenuation::free_space_path_loss::make());
+}
+BENCHMARK(BM_free_space_path_loss);
+
+static void
+BM_antenna_pointing_loss(benchmark::State &state)
+{
+  run_attenuation(state, attenuation::antenna_pointing_loss::make(
+                    antenna::yagi_antenna::make(YAGI, freq, RHCP, 0.1, 2.35),
+                    antenna::dipole_antenna::make(DIPOLE, freq, LINEAR_VERTICAL,
+                        0.1)));
+}
+BENCHMARK(BM_antenna_pointing_loss);
+
+/*
+ * Antenna gain rolloff
+ */
+static void
+BM_rolloff_yagi(benchmark::State &state)
+{
+  run_rolloff(state, antenna::yagi_antenna::make(YAGI, freq, RHCP, 0, 2.35));
+}
+BENCHMARK(BM_rolloff_yagi);
+
+static void
+BM_rolloff_helix(benchmark::State &state)
+{
+  run_rolloff(state, antenna::helix_antenna::make(HELIX, freq, RHCP, 0, 10,
+              0.25, 1.0));
+}
+BENCHMARK(BM_rolloff_helix);
+
+static void
+BM_rolloff_parabolic_reflector(benchmark::State &state)
+{
+  run_rolloff(state, antenna::parabolic_reflector_antenna::make(
+                PARABOLIC_REFLECTOR, freq, RHCP, 0, 3, 0.55));
+}
+BENCHMARK(BM_rolloff_parabolic_reflector);
+
+static void
+BM_rolloff_custom(benchmark::State &state)
+{
+  run_rolloff(state, antenna::custom_antenna::make(CUSTOM, freq, RHCP, 0, 12,
+              30, 3));
+}
+BENCHMARK(BM_rolloff_custom);
+
+static void
+BM_rolloff_monopole(benchmark::State &state)
+{
+  run_rolloff(state, antenna::monopole_antenna::make(MONOPOLE, freq,
+              LINEAR_VERTICAL, 0));
+}
+BENCHMARK(BM_rolloff_monopole);
+
+static void
+BM_rolloff_dipole(benchmark::State &state)
+{
+  run_rolloff(state, antenna::dipole_antenna::make(DIPOLE, freq,
+              LINEAR_VERTICAL, 0));
+}
+BENCHMARK(BM_rolloff_dipole);
+
+static void
+BM_rolloff_quadrifilar_helix(benchmark::State &state)
+{
+  run_rolloff(state, antenna::quadrifilar_helix_antenna::make(
+                QUADRIFILAR_HELIX, freq, RHCP, 0, 0.5));
+}
+BENCHMARK(BM_rolloff_quadrifilar_helix);
+
+/*
+ * Orbit propagation. Every iteration moves the tracker to a new time step,
+ * so the cached look angle of the previous step is never reused.
+ */
+static void
+step_tracker(const tracker::tracker_sptr &t, const libsgp4::DateTime &start)
+{
+  t->advance_time(1000);
+  if (t->is_observation_over()) {
+    t->set_elapsed_time(start);
+  }
+}
+
+static void
+BM_tracker_slant_range(benchmark::State &state)
+{
+  tracker::tracker_sptr t = make_tracker();
+  const libsgp4::DateTime start = t->get_elapsed_time();
+  for (auto _ : state) {
+    step_tracker(t, start);
+    benchmark::DoNotOptimize(t->get_slant_range());
+  }
+}
+BENCHMARK(BM_tracker_slant_range);
+
+static void
+BM_tracker_elevation(benchmark::State &state)
+{
+  tracker::tracker_sptr t = make_tracker();
+  const libsgp4::DateTime start = t->get_elapsed_time();
+  for (auto _ : state) {
+    step_tracker(t, start);
+    benchmark::DoNotOptimize(t->get_elevation_radians());
+  }
+}
+BENCHMARK(BM_tracker_elevation);
+
+static void
+BM_tracker_velocity(benchmark::State &state)
+{
+  tracker::tracker_sptr t = make_tracker();
+  const libsgp4::DateTime start = t->get_elapsed_time();
+  for (auto _ : state) {
+    step_tracker(t, start);
+    benchmark::DoNotOptimize(t->get_velocity());
+  }
+}
+BENCHMARK(BM_tracker_velocity);
+
+/* A whole time step, as the model performs it */
+static void
+BM_tracker_step(benchmark::State &state)
+{
+  tracker::tracker_sptr t = make_tracker();
+  const libsgp4::DateTime start = t->get_elapsed_time();
+  for (auto _ : state) {
+    step_tracker(t, start);
+    benchmark::DoNotOptimize(t->get_slant_range());
+    benchmark::DoNotOptimize(t->get_elevation_radians());
+    benchmark::DoNotOptimize(t->get_velocity());
+  }
+}
+BENCHMARK(BM_tracker_step);
+
+/*
+ * Noise
+ */
+static void
+BM_white_gaussian_noise(benchmark::State &state)
+{
+  const size_t n = state.range(0);
+  std::vector<gr_complex> in(n, gr_complex(1.0, 0.0));
+  std::vector<gr_complex> out(n);
+  generic_noise::generic_noise_sptr noise = noise::white_gaussian_noise::make();
+  for (auto _ : state) {
+    noise->add_noise(out.data(), in.data(), n, -120);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_white_gaussian_noise)->RangeMultiplier(8)->Range(1024, 65536);
+
+/*
+ * The whole LEO model
+ */
+static generic_model::generic_model_sptr
+make_leo_model(impairment_enum_t atmo)
+{
+  generic_model::generic_model_sptr m = model::leo_model::make(make_tracker(),
+                                        DOWNLINK, FREE_SPACE_PATH_LOSS,
+                                        ANTENNA_POINTING_LOSS, DOPPLER_SHIFT,
+                                        atmo, PRECIPITATION_ITU, true);
+  /* Move in the middle of the pass, to have AOS */
+  m->advance_time(300e6);
+  return m;
+}
+
+static void
+BM_leo_model_generic_work(benchmark::State &state)
+{
+  const size_t n = state.range(0);
+  std::vector<gr_complex> in(n, gr_complex(1.0, 0.0));
+  std::vector<gr_complex> out(n);
+  generic_model::generic_model_sptr m = make_leo_model(ATMO_GASES_REGRESSION);
+  for (auto _ : state) {
+    m->generic_work(in.data(), out.data(), n, 48e3);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_leo_model_generic_work)->RangeMultiplier(8)->Range(1024, 65536);
+
+static void
+BM_leo_model_advance_time(benchmark::State &state)
+{
+  generic_model::generic_model_sptr m = make_leo_model(
+                                          static_cast<impairment_enum_t>(state.range(0)));
+  for (auto _ : state) {
+    m->advance_time(0);
+  }
+}
+BENCHMARK(BM_leo_model_advance_time)
+->Arg(ATMO_GASES_REGRESSION)
+->Arg(ATMO_GASES_ITU)
+->Arg(ATMO_GASES_ITU_ANNEX2);
+
+BENCHMARK_MAIN();
@@ -22,6 +22,8 @@
 #define INCLUDED_LEO_ANTENNA_POINTING_LOSS_H
 
 #include <gnuradio/leo/api.h>
+#include <gnuradio/leo/attitude.h>
+#include <gnuradio/leo/rotator.h>
 #include <gnuradio/leo/tracker.h>
 #include <gnuradio/leo/generic_attenuation.h>
 
@@ -29,7 +31,27 @@ namespace gr {
 namespace leo {
 namespace attenuation {
 /*!
- * \brief
+ * \brief The gain roll-off of the antennas due to their pointing.
+ *
+ * \details
+ * With ANTENNA_POINTING_LOSS only the roll-off of the satellite antenna
+ * due to its pointing error is taken into account.
+ *
+ * With ANTENNA_POINTING_LOSS_GEOMETRIC the satellite antenna is considered
+ * nadir pointing, so it is evaluated at the actual angle between the nadir
+ * and the ground station, that follows from the slant range and the
+ * elevation, plus its pointing error. The ground station antenna tracks the
+ * satellite, so it is evaluated at its pointing error.
+ *
+ * If a rotator is given, in both modes the ground station antenna is
+ * evaluated at its pointing error plus the pointing error of the rotator.
+ * The rotator must be updated by the owner of the attenuation, e.g. the
+ * channel model, at each time step.
+ *
+ * If an attitude is given, in both modes the satellite antenna is evaluated
+ * at the direction of the ground station in the body frame of the
+ * satellite, plus its pointing error. The attitude must also be updated by
+ * the owner of the attenuation.
  *
  * \ingroup attenuation
  */
@@ -41,12 +63,18 @@ public:
    *
    * \param tracker_antenna a boost::shared_ptr to the tracker's antenna
    * \param satellite_antenna a boost::shared_ptr to the satellite's antenna
+   * \param mode ANTENNA_POINTING_LOSS or ANTENNA_POINTING_LOSS_GEOMETRIC
+   * \param rotator the rotator of the ground station antenna, or nullptr
+   * \param attitude the attitude of the satellite, or nullptr
    *
    * \return a boost::shared_ptr<generic_attenuation> pointer
    */
   static generic_attenuation::generic_attenuation_sptr
   make(generic_antenna::generic_antenna_sptr tracker_antenna,
-       generic_antenna::generic_antenna_sptr satellite_antenna);
+       generic_antenna::generic_antenna_sptr satellite_antenna,
+       impairment_enum_t mode = ANTENNA_POINTING_LOSS,
+       rotator::rotator_sptr rotator = nullptr,
+       attitude::attitude_sptr attitude = nullptr);
 
 };
 } // namespace attenuation
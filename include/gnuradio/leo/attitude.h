@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_ATTITUDE_H
+#define INCLUDED_LEO_ATTITUDE_H
+
+#include <gnuradio/leo/api.h>
+#include <gnuradio/leo/leo_types.h>
+#include <cstddef>
+#include <memory>
+
+namespace gr {
+namespace leo {
+
+/**
+ * \brief Attitude describes the orientation of the satellite body, that
+ * carries the satellite antenna.
+ * \ingroup satellite
+ *
+ * The boresight of the satellite antenna is the +Z axis of the body frame.
+ * The attitude gives the direction of the ground station in the body
+ * frame, as the angle from the boresight and the azimuth around it from
+ * the +X axis, from the Earth-centered inertial (ECI) state that SGP4
+ * produces for each time step.
+ *
+ * - ATTITUDE_NADIR: +Z points to the nadir and +X along the velocity
+ *   (local vertical, local horizontal frame).
+ * - ATTITUDE_SPIN: the body spins around +Z, that is fixed in inertial
+ *   space towards the given right ascension and declination.
+ * - ATTITUDE_TUMBLING: the body rotates with a constant rate around a
+ *   random axis, from a random initial orientation.
+ *
+ * The spinning and tumbling orientations are quaternions. The batch
+ * method evaluates a whole window, or many satellites, at once over
+ * structure of arrays inputs with a branch free loop.
+ */
+class LEO_API attitude {
+
+public:
+  using attitude_sptr = std::shared_ptr<attitude>;
+
+  /*!
+   * \param mode the attitude mode
+   * \param rate the spin or tumbling rate in degrees/sec
+   * \param axis_ra the right ascension of the spin axis in degrees
+   * \param axis_dec the declination of the spin axis in degrees
+   * \param seed the seed of the random tumbling axis and initial
+   *        orientation
+   *
+   * \return a std::shared_ptr to the constructed attitude object.
+   */
+  static attitude_sptr
+  make(attitude_mode_t mode, double rate = 0, double axis_ra = 0,
+       double axis_dec = 90, unsigned int seed = 0);
+
+  attitude(attitude_mode_t mode, double rate, double axis_ra,
+           double axis_dec, unsigned int seed);
+
+  ~attitude();
+
+  /*!
+   * Computes the direction of the ground station in the body frame.
+   * @param time the time in seconds
+   * @param state the ECI state of the satellite and the ground station
+   */
+  void
+  update(double time, const eci_state_t &state);
+
+  /*!
+   * Computes the direction of the ground station in the body frame for
+   * \p n time instances or satellites. The vectors are given as three
+   * consecutive arrays of \p n elements, one for each coordinate.
+   * @param n the number of elements
+   * @param time the times in seconds
+   * @param sat_position the ECI positions of the satellite in km
+   * @param sat_velocity the ECI velocities of the satellite in km/s
+   * @param gs_position the ECI positions of the ground station in km
+   * @param theta the angles from the boresight in radians
+   * @param phi the azimuths around the boresight in radians
+   */
+  void
+  off_boresight_batch(size_t n, const double *time,
+                      const double *sat_position,
+                      const double *sat_velocity,
+                      const double *gs_position, double *theta,
+                      double *phi) const;
+
+  /*!
+   * Returns the angle between the boresight and the ground station, at the
+   * last update.
+   * @return the angle in radians.
+   */
+  double
+  get_off_boresight() const;
+
+  /*!
+   * Returns the azimuth of the ground station around the boresight, at the
+   * last update.
+   * @return the azimuth in radians.
+   */
+  double
+  get_azimuth() const;
+
+  attitude_mode_t
+  get_mode() const;
+
+private:
+  const attitude_mode_t d_mode;
+  const double d_rate;
+
+  /* The orientation at time zero and the rotation axis in the body frame */
+  double d_q0[4];
+  double d_axis[3];
+
+  double d_theta;
+  double d_phi;
+};
+
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_ATTITUDE_H */
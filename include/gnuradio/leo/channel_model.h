@@ -24,9 +24,11 @@
 #include <gnuradio/leo/api.h>
 #include <gnuradio/leo/generic_model.h>
 #include <gnuradio/leo/leo_types.h>
-#include <gnuradio/sync_block.h>
+#include <gnuradio/block.h>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace gr {
 namespace leo {
@@ -42,8 +44,12 @@ namespace leo {
  * flowgraph. The model variable takes the incoming signal and
  * applies the appropriate signal effects and attenuation according
  * to the described channel.
+ *
+ * The block is not a synchronous one, as models that apply the time
+ * compression of the signal produce a different number of samples than
+ * the ones they consume.
  */
-class LEO_API channel_model : virtual public gr::sync_block {
+class LEO_API channel_model : virtual public gr::block {
 public:
 
   using sptr = std::shared_ptr<channel_model>;
@@ -53,10 +59,70 @@ public:
    *
    * \param sample_rate The sampling rate of the block
    * \param model An LEO_API model object (See gr::leo::generic_model)
+   * \param los_mode How the parts of the observation without visibility of
+   * the satellite are handled (See gr::leo::los_mode_t). In LOS_SKIP mode
+   * the observation jumps to the next AOS and a \p los_skip_us tag with the
+   * skipped duration is attached to the first sample after the jump.
+   * \param time_scale The orbital time represented by one second of
+   * samples. Values greater than 1 accelerate the observation, while the
+   * sampling rate seen by the rest of the flowgraph remains the same.
+   * \param time_source The clock that drives the observation
+   * (See gr::leo::time_source_t). With TIME_WALL_CLOCK or TIME_RX_TAGS the
+   * model is updated from a separate thread at every time step of the
+   * tracker and the signal processing never waits for it. In these modes the
+   * time scale and the LOS handling options do not apply.
+   * \param precompute_windows If non-zero, the model states of up to this
+   * number of upcoming time windows are computed ahead in a separate
+   * thread, so the signal processing only applies them. Valid only with
+   * TIME_SIMULATED. The LOS windows of LOS_ZEROS and the skips of LOS_SKIP
+   * are determined by the same thread.
    */
   static sptr
   make(const double sample_rate, generic_model::generic_model_sptr model,
-       const noise_t noise_type, const bool store_csv, const char *filename);
+       const noise_t noise_type, const bool store_csv, const char *filename,
+       const los_mode_t los_mode = LOS_SIMULATE,
+       const double time_scale = 1.0,
+       const time_source_t time_source = TIME_SIMULATED,
+       const size_t precompute_windows = 0);
+
+  /*!
+   * \brief Estimate percentiles of the execution time of the work of the
+   * block, since its creation or the last reset_work_latency(). The work is
+   * timed only if the module has been built with the ENABLE_PROFILING
+   * option.
+   * \param percentiles the requested percentiles in the range [0, 100]
+   * \return the execution time in microseconds for each percentile
+   */
+  virtual std::vector<double>
+  work_latency_percentiles(const std::vector<double> &percentiles) = 0;
+
+  /*!
+   * \brief Get the number of work invocations measured so far
+   */
+  virtual uint64_t
+  work_latency_count() = 0;
+
+  /*!
+   * \brief Clear the execution time statistics of the work
+   */
+  virtual void
+  reset_work_latency() = 0;
+
+  /*!
+   * \brief Get the time spent in each processing stage of the block and its
+   * model, e.g. the SGP4 propagation, each attenuation, the noise
+   * generation and the tag emission. The statistics are available only if
+   * the module has been built with the ENABLE_PROFILING option.
+   * \return a map from the stage name to its statistics
+   */
+  virtual std::map<std::string, stage_stats_t>
+  get_stats() = 0;
+
+  /*!
+   * \brief Clear the statistics of the processing stages
+   */
+  virtual void
+  reset_stats() = 0;
 
 };
 
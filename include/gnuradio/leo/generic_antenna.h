@@ -23,6 +23,7 @@
 
 #include <gnuradio/leo/api.h>
 #include <gnuradio/leo/leo_types.h>
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -40,7 +41,7 @@ namespace leo {
 class LEO_API generic_antenna {
 
 public:
-  static int base_unique_id;
+  static std::atomic<int> base_unique_id;
 
   antenna_t d_type;
 
@@ -61,7 +62,8 @@ public:
   get_frequency();
 
   /*!
-   * \brief Set the pointing error of the antenna.
+   * \brief Set the pointing error of the antenna. The gain roll-off at the
+   * new pointing error is computed once here.
    * \param error the pointing error in degrees.
    */
   void
@@ -111,6 +113,22 @@ public:
   virtual double
   get_gain_rolloff() = 0;
 
+  /*!
+   * \brief Get the gain roll-off of the antenna towards a direction.
+   *
+   * The antennas of the module implement their roll-off formula here. The
+   * default implementation assumes a pattern that is symmetric around
+   * the boresight and approximates its main lobe with a Gaussian beam of
+   * the beamwidth of the antenna, 12 (theta / beamwidth)^2 dB. It does not
+   * modify the antenna, so it can be called concurrently.
+   *
+   * \param theta the angle from the boresight in radians.
+   * \param phi the azimuth around the boresight in radians.
+   * \return the gain roll-off in dB.
+   */
+  virtual double
+  get_gain_rolloff(double theta, double phi);
+
   using generic_antenna_sptr = std::shared_ptr<generic_antenna>;
 
   virtual
@@ -130,6 +148,20 @@ public:
                   double pointing_error);
 
   generic_antenna(void) {};
+
+protected:
+  /*!
+   * \brief The gain roll-off at the pointing error, in dB
+   */
+  double d_gain_rolloff;
+
+  /*!
+   * \brief Compute the gain roll-off at the pointing error. Derived
+   * antennas call it at the end of their constructor, when the parameters
+   * of their roll-off formula are known.
+   */
+  void
+  update_gain_rolloff();
 };
 } // namespace leo
 } // namespace gr
@@ -26,6 +26,7 @@
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 namespace gr {
 namespace leo {
@@ -43,6 +44,8 @@ namespace leo {
  * according to the attenuation it describes, using the static variables of the
  * parent class.
  *
+ * The static variables are thread local, so models that run on different
+ * threads, e.g. the channel models of a flowgraph, do not share them.
  */
 class LEO_API generic_attenuation {
 
@@ -56,6 +59,67 @@ public:
   virtual double
   get_attenuation() = 0;
 
+  /*!
+   * \brief Get the estimated attenuation for a series of elevation angles,
+   * keeping the rest of the static variables fixed.
+   *
+   * The default implementation evaluates get_attenuation() for each angle.
+   * Derived classes may override it to share the elevation independent
+   * terms across the whole series.
+   *
+   * \param out the attenuations in dB
+   * \param elevation the elevation angles in radians
+   * \param n the number of elevation angles
+   */
+  virtual void
+  get_attenuation_batch(double *out, const double *elevation, size_t n);
+
+  /*!
+   * \brief Get the estimated attenuation for a series of elevation angles
+   * \param elevation the elevation angles in radians
+   * \return the attenuations in dB
+   */
+  std::vector<double>
+  get_attenuation_batch(const std::vector<double> &elevation);
+
+  /*!
+   * \brief Get the estimated attenuation for a series of arbitrary
+   * geometries, keeping the polarization and the time fixed.
+   *
+   * The points are grouped by frequency, so the frequency dependent terms
+   * are computed once per distinct frequency. If the model supports it, the
+   * points of each frequency are evaluated by several threads. The static
+   * variables of the calling thread are left unchanged.
+   *
+   * \param out the attenuations in dB
+   * \param frequency the frequencies in Hz
+   * \param elevation the elevation angles in radians
+   * \param slant_range the slant ranges in km
+   * \param n the number of points
+   * \param nthreads the maximum number of threads, 0 for the number of
+   * hardware threads
+   */
+  void
+  get_attenuation_batch(double *out, const double *frequency,
+                        const double *elevation, const double *slant_range,
+                        size_t n, size_t nthreads = 0);
+
+  /*!
+   * \brief Get the estimated attenuation for a series of arbitrary
+   * geometries
+   * \param frequency the frequencies in Hz
+   * \param elevation the elevation angles in radians
+   * \param slant_range the slant ranges in km
+   * \param nthreads the maximum number of threads, 0 for the number of
+   * hardware threads
+   * \return the attenuations in dB
+   */
+  std::vector<double>
+  get_attenuation_batch(const std::vector<double> &frequency,
+                        const std::vector<double> &elevation,
+                        const std::vector<double> &slant_range,
+                        size_t nthreads = 0);
+
   /*!
    * \brief Set frequency static variable
    * \param freq The frequency in Hz
@@ -84,6 +148,14 @@ public:
   static void
   set_elevation_angle(double elev_angle);
 
+  /*!
+   * \brief Set time static variable
+   * \param t The time of the evaluation in seconds. Only the differences
+   * between successive times are meaningful.
+   */
+  static void
+  set_time(double t);
+
   using generic_attenuation_sptr = std::shared_ptr<generic_attenuation>;
 
   static generic_attenuation::generic_attenuation_sptr
@@ -95,10 +167,21 @@ public:
   ~generic_attenuation();
 
 protected:
-  static double frequency;
-  static double elevation_angle;
-  static double slant_range;
-  static polarization_t polarization;
+  static thread_local double frequency;
+  static thread_local double elevation_angle;
+  static thread_local double slant_range;
+  static thread_local polarization_t polarization;
+  static thread_local double time;
+
+  /*!
+   * \brief Whether get_attenuation() can run concurrently on several
+   * threads, for a frequency that it has already been evaluated at.
+   *
+   * The default is false. Derived classes that modify no member once their
+   * frequency dependent terms are computed may return true.
+   */
+  virtual bool
+  is_reentrant() const;
 };
 
 } // namespace leo
@@ -29,6 +29,8 @@
 #include <gnuradio/leo/link_margin.h>
 #include <gnuradio/runtime_types.h>
 #include <boost/format.hpp>
+#include <atomic>
+#include <map>
 #include <memory>
 
 namespace gr {
@@ -71,14 +73,66 @@ public:
   generic_work(const gr_complex *inbuffer, gr_complex *outbuffer,
                int noutput_items, double samp_rate) = 0;
 
+  /*!
+   * \brief Apply the channel to the input signal, for models that alter the
+   * timing of the signal and may consume a different number of input
+   * samples than the output samples they produce. The default
+   * implementation processes the signal one to one through generic_work.
+   *
+   * \param inbuffer Pointer to the complex input signal
+   * \param ninput_items The number of available input samples
+   * \param consumed The number of input samples consumed
+   * \param outbuffer Pointer to the complex output signal
+   * \param noutput_items The maximum number of output samples to produce
+   * \param samp_rate The sampling rate of the signal
+   *
+   * \return the number of output samples produced
+   */
+  virtual int
+  generic_general_work(const gr_complex *inbuffer, int ninput_items,
+                       int &consumed, gr_complex *outbuffer,
+                       int noutput_items, double samp_rate);
+
+  /*!
+   * \brief Estimate the number of input samples that the model needs in
+   * order to produce \p noutput_items output samples.
+   * \return the number of input samples
+   */
+  virtual int
+  forecast(int noutput_items);
+
   /**
-   * Advances the time of the simulation
+   * Advances the time of the simulation and applies the state of the model
+   * at the new time instant.
    * @param us the time window to advance, expressed in microseconds
    */
   virtual void
   advance_time(double us);
 
-  static int base_unique_id;
+  /*!
+   * \brief Computes the state of the model at the current time of the
+   * tracker, without applying it to the signal. This is where all the
+   * orbit and attenuation calculations take place.
+   */
+  virtual void
+  update_state() = 0;
+
+  /*!
+   * \brief Get the last state computed by update_state()
+   * \return a snapshot of the model state
+   */
+  model_state_t
+  get_state() const;
+
+  /*!
+   * \brief Apply a previously computed state. Subsequent calls to
+   * generic_work(), get_tags_vector() and get_csv_log() use this state.
+   * \param state the state to apply
+   */
+  virtual void
+  set_state(const model_state_t &state);
+
+  static std::atomic<int> base_unique_id;
 
   std::string d_name;
 
@@ -107,7 +161,7 @@ public:
   generic_model(std::string name, tracker::tracker_sptr tracker,
                 const link_mode_t mode);
 
-  generic_model(void) {};
+  generic_model(void) : d_time_scale(1.0), d_state(), d_computed_state() {};
 
   /*!
    * \brief Get the tracker object
@@ -201,6 +255,37 @@ public:
   virtual std::vector<std::pair<pmt::pmt_t, pmt::pmt_t>>
       get_tags_vector() = 0;
 
+  /*!
+   * \brief Set the ratio between the orbital time and the time represented
+   * by the samples of the signal. A value of K means that one second of
+   * samples spans K seconds of the observation.
+   * \param time_scale the time-scale factor
+   */
+  void
+  set_time_scale(double time_scale);
+
+  /*!
+   * \brief Get the time-scale factor of the simulation
+   * \return the ratio between orbital time and signal time
+   */
+  double
+  get_time_scale() const;
+
+  /*!
+   * \brief Get the time spent in each processing stage of the model. The
+   * statistics are available only if the module has been built with the
+   * ENABLE_PROFILING option.
+   * \return a map from the stage name to its statistics
+   */
+  virtual std::map<std::string, stage_stats_t>
+  get_stats();
+
+  /*!
+   * \brief Clear the statistics of the processing stages
+   */
+  virtual void
+  reset_stats();
+
   /*!
    * \brief Get the model's noise-floor.
    * \return the noise-floor in dBm
@@ -208,6 +293,10 @@ public:
   double
   get_noise_floor();
 
+  /*!
+   * \brief Check if the satellite is visible, based on the applied state.
+   * \return true if the satellite is visible, false otherwise
+   */
   bool
   aos();
 
@@ -244,6 +333,21 @@ protected:
 
   double d_link_margin_db;
 
+  /*!
+   * \brief Orbital time per unit of signal time
+   */
+  double d_time_scale;
+
+  /*!
+   * \brief The state applied on the signal
+   */
+  model_state_t d_state;
+
+  /*!
+   * \brief The state computed by the last call of update_state()
+   */
+  model_state_t d_computed_state;
+
 };
 
 } // namespace leo
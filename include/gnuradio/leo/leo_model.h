@@ -22,8 +22,10 @@
 #define INCLUDED_LEO_LEO_MODEL_H
 
 #include <gnuradio/leo/api.h>
+#include <gnuradio/leo/attitude.h>
 #include <gnuradio/leo/generic_model.h>
 #include <gnuradio/leo/leo_types.h>
+#include <gnuradio/leo/rotator.h>
 
 namespace gr {
 namespace leo {
@@ -37,6 +39,28 @@ namespace model {
  * applies free-space path-loss attenuation, Doppler frequency shift
  * and atmospheric/ionosperic attenation.
  *
+ * Optionally, the time compression of the signal due to the range rate
+ * of the satellite (code Doppler) can be applied. In this case the signal
+ * is resampled by a ratio of 1 - Vr / c, that follows the range rate
+ * continuously, so the number of output samples differs from the number of
+ * input samples.
+ *
+ * Optionally, the ground station antenna can be pointed by a simulated
+ * rotator, that follows the satellite with a finite slew rate. Its pointing
+ * error is added to the antenna pointing loss.
+ *
+ * Optionally, the satellite antenna can be pointed by the attitude of the
+ * satellite, that gives the direction of the ground station in the body
+ * frame for the antenna pointing loss.
+ *
+ * The seed initializes the random processes of the model, like the
+ * statistical rain fade, so independent instances of the same scenario can
+ * be simulated with different realizations. The rain probability, in
+ * percent of the time, and the fade dynamics, in 1/s, shape the statistical
+ * rain fade, see attenuation::precipitation_itu. If topographic_altitude
+ * is set, the rain attenuation takes the altitude of the ground station
+ * from the topography of the ITU-R P.1511 recommendation, instead of the
+ * altitude of the tracker.
  */
 class LEO_API leo_model : virtual public generic_model {
 
@@ -50,7 +74,13 @@ public:
        const impairment_enum_t precipitation_attenuation,
        const bool enable_link_margin,
        const double surface_watervap_density = 7.5,
-       const double temperature = 0, const double rainfall_rate = 25);
+       const double temperature = 0, const double rainfall_rate = 25,
+       const impairment_enum_t time_compression_enum = IMPAIRMENT_NONE,
+       rotator::rotator_sptr rotator = nullptr,
+       attitude::attitude_sptr attitude = nullptr, unsigned int seed = 0,
+       const double rain_probability = 5.0,
+       const double fade_dynamics = 2e-4,
+       const bool topographic_altitude = false);
 
   leo_model()
   {
@@ -11,6 +11,7 @@
 #define INCLUDED_LEO_TYPES_H
 
 #include <gnuradio/leo/api.h>
+#include <cstdint>
 #include <string>
 
 namespace gr {
@@ -26,6 +27,62 @@ typedef struct {
   double max_elevation;
 } pass_details_t;
 
+/*!
+ * The numeric form of a satellite pass. The times are in microseconds since
+ * the Unix epoch and the angles in radians, the azimuths clockwise from the
+ * north.
+ */
+typedef struct {
+  int64_t aos;
+  int64_t los;
+  int64_t max_elevation_time;
+  double max_elevation;
+  double aos_azimuth;
+  double los_azimuth;
+} pass_info_t;
+
+/*!
+ * A snapshot of the state of a channel model at a specific time instant of
+ * the observation. It is trivially copyable, so it can be safely exchanged
+ * between the thread that computes it and the thread that applies it
+ * on the signal.
+ */
+typedef struct {
+  bool aos;
+  int64_t elapsed_ticks;
+  double slant_range;
+  double elevation;
+  double velocity;
+  double doppler_shift;
+  double pathloss_attenuation;
+  double atmo_attenuation;
+  double rainfall_attenuation;
+  double pointing_attenuation;
+  double total_attenuation;
+  double link_margin_db;
+  double noise_floor;
+  double time_compression_ratio;
+} model_state_t;
+
+/*!
+ * The Earth-centered inertial (ECI) state of the satellite and the ground
+ * station at a specific time instant of the observation, in km and km/s.
+ */
+typedef struct {
+  double sat_position[3];
+  double sat_velocity[3];
+  double gs_position[3];
+} eci_state_t;
+
+/*!
+ * The accumulated cost of a processing stage, as it is reported by the
+ * instrumentation of the hot paths.
+ */
+typedef struct {
+  uint64_t calls;
+  double total_us;
+} stage_stats_t;
+
 enum impairment_enum_t {
   IMPAIRMENT_NONE = 0,
   ATMO_GASES_ITU,
@@ -34,7 +91,11 @@ enum impairment_enum_t {
   PRECIPITATION_CUSTOM,
   FREE_SPACE_PATH_LOSS,
   ANTENNA_POINTING_LOSS,
-  DOPPLER_SHIFT
+  DOPPLER_SHIFT,
+  TIME_COMPRESSION,
+  ATMO_GASES_ITU_ANNEX2,
+  PRECIPITATION_STATISTICAL,
+  ANTENNA_POINTING_LOSS_GEOMETRIC
 };
 
 enum noise_t {
@@ -54,7 +115,17 @@ enum antenna_t {
   CUSTOM,
   MONOPOLE,
   DIPOLE,
-  QUADRIFILAR_HELIX
+  QUADRIFILAR_HELIX,
+  PATTERN
+};
+
+/*!
+ * The orientation of the satellite body, see gr::leo::attitude.
+ */
+enum attitude_mode_t {
+  ATTITUDE_NADIR = 0,
+  ATTITUDE_SPIN,
+  ATTITUDE_TUMBLING
 };
 
 enum link_mode_t {
@@ -62,6 +133,64 @@ enum link_mode_t {
   DOWNLINK
 };
 
+/*!
+ * How the channel model handles the parts of the observation where the
+ * satellite is not visible from the ground station.
+ * LOS_SIMULATE runs the model normally, LOS_ZEROS outputs zeros
+ * without any model update and LOS_SKIP jumps directly to the next AOS.
+ */
+enum los_mode_t {
+  LOS_SIMULATE = 0,
+  LOS_ZEROS,
+  LOS_SKIP
+};
+
+/*!
+ * The clock that drives the time of the observation.
+ * TIME_SIMULATED advances the observation with the processed samples,
+ * TIME_WALL_CLOCK follows the UTC time of the host and TIME_RX_TAGS follows
+ * the rx_time stream tags of the input signal.
+ */
+enum time_source_t {
+  TIME_SIMULATED = 0,
+  TIME_WALL_CLOCK,
+  TIME_RX_TAGS
+};
+
+/*!
+ * The severity of a log message. Messages below the level set with
+ * logging::set_level() are discarded without formatting their arguments.
+ */
+enum log_level_t {
+  LOG_LEVEL_TRACE = 0,
+  LOG_LEVEL_DEBUG,
+  LOG_LEVEL_INFO,
+  LOG_LEVEL_WARN,
+  LOG_LEVEL_ERROR,
+  LOG_LEVEL_OFF
+};
+
+/*!
+ * A parameter of a scenario that a parameter sweep varies, see
+ * gr::leo::sweep. The antenna parameters set the first parameter of the
+ * antenna description, e.g. the boom length of a Yagi or the diameter of a
+ * parabolic reflector. The noise figure is the one of the receiver of the
+ * link.
+ */
+enum sweep_param_t {
+  SWEEP_SAT_TX_POWER = 0,
+  SWEEP_GS_TX_POWER,
+  SWEEP_SAT_ANTENNA,
+  SWEEP_GS_ANTENNA,
+  SWEEP_GS_POINTING_ERROR,
+  SWEEP_NOISE_FIGURE,
+  SWEEP_FREQUENCY,
+  SWEEP_RAINFALL_RATE,
+  SWEEP_GS_LATITUDE,
+  SWEEP_GS_LONGITUDE,
+  SWEEP_GS_ALTITUDE
+};
+
 
 } // namespace leo
 } // namespace gr
@@ -23,48 +23,155 @@
 #ifndef INCLUDE_LEO_LOG_H_
 #define INCLUDE_LEO_LOG_H_
 
+#include <gnuradio/leo/api.h>
+#include <gnuradio/leo/leo_types.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
 
-#include <stdio.h>
-#include <errno.h>
-#include <string.h>
+#if defined(__GNUC__)
+#define LEO_PRINTF_FORMAT(FMT, ARGS) __attribute__((format(printf, FMT, ARGS)))
+#else
+#define LEO_PRINTF_FORMAT(FMT, ARGS)
+#endif
 
-#define LEO_MESSAGES 0
-#define LEO_DEBUG_MESSAGES 0
+namespace gr {
+namespace leo {
 
-#if LEO_MESSAGES
-#define LEO_LOG_CLASS_INFO(CLASS_DEBUG_ENABLE, M, ...)                               \
-        do {                                                                            \
-                if(CLASS_DEBUG_ENABLE) {                                                \
-                                fprintf(stderr, "[INFO]: " M " \n", ##__VA_ARGS__);     \
-                }                                                                       \
-        } while(0)
+/*!
+ * \brief Runtime levelled logging of the gr-leo module.
+ *
+ * \details
+ * Messages are forwarded to the "gr-leo" GNU Radio logger and optionally
+ * recorded into an in-memory ring buffer of fixed size binary records, that
+ * can be dumped after a failure. A record keeps the format pointer and the
+ * raw arguments, so the text is only formatted when the buffer is dumped.
+ * A string argument is cut to the space left in the record, and any other
+ * argument that does not fit is dropped. Either way the record is marked as
+ * truncated. The logging macros check the level before evaluating any
+ * argument, so a disabled message costs a single relaxed atomic load. Each
+ * call site is rate limited independently and reports how many messages it
+ * has suppressed.
+ */
+class LEO_API logging {
+public:
+  /*!
+   * \brief Per call site token bucket with a window of one second
+   */
+  class LEO_API rate_limiter {
+  public:
+    rate_limiter();
 
-#else
-#define LEO_LOG_CLASS_INFO(CLASS, M, ...)
-#endif
+    /*!
+     * \brief Check if the call site may emit another message
+     */
+    bool
+    allow();
 
-#if LEO_MESSAGES
-#define LEO_LOG_INFO(M, ...)                                                         \
-                fprintf(stderr, "[INFO]: " M " \n", ##__VA_ARGS__)
+    /*!
+     * \brief Get and clear the number of the suppressed messages
+     */
+    uint64_t
+    take_suppressed();
 
-#else
-#define LEO_LOG_INFO(M, ...)
-#endif
+  private:
+    std::atomic<int64_t> d_window;
+    std::atomic<uint32_t> d_count;
+    std::atomic<uint64_t> d_suppressed;
+  };
 
-#define LEO_ERROR(M, ...)                                                    \
-        fprintf(stderr, "[ERROR] %s:%d: " M "\n", __FILE__, __LINE__, ##__VA_ARGS__)
+  static bool
+  enabled(log_level_t level)
+  {
+    return level >= s_level.load(std::memory_order_relaxed);
+  }
 
-#define LEO_WARN(M, ...)                                                             \
-        fprintf(stderr, "[WARNING] %s:%d: " M "\n", __FILE__, __LINE__, ##__VA_ARGS__)
+  /*!
+   * \brief Set the minimum level of the emitted messages. The level of the
+   * "gr-leo" GNU Radio logger is adjusted too.
+   */
+  static void
+  set_level(log_level_t level);
 
-#if LEO_DEBUG_MESSAGES
-#define LEO_DEBUG(M, ...)                                                    \
-        fprintf(stderr, "[DEBUG]: " M "\n", ##__VA_ARGS__)
-#else
-#define LEO_DEBUG(M, ...)
-#endif
+  static log_level_t
+  get_level();
 
+  /*!
+   * \brief Set the maximum number of messages per second of each call site
+   * \param messages_per_sec the limit. 0 disables the rate limiting.
+   */
+  static void
+  set_rate_limit(size_t messages_per_sec);
 
+  static size_t
+  get_rate_limit();
 
-#endif /* INCLUDE_LEO_LOG_H_ */
+  /*!
+   * \brief Enable or disable the forwarding to the GNU Radio logger
+   */
+  static void
+  set_forward(bool forward);
+
+  /*!
+   * \brief Resize the ring buffer of the log records
+   * \param nrecords the number of the most recent records to keep.
+   * 0 disables the ring buffer.
+   */
+  static void
+  set_ring_buffer(size_t nrecords);
 
+  /*!
+   * \brief Write the records of the ring buffer, oldest first, as text
+   * \param filename the output file. If empty, the records are written
+   * at the standard error.
+   */
+  static void
+  dump_ring_buffer(const std::string &filename = "");
+
+  /*!
+   * \brief Record and emit a message. Use the LEO_* macros instead, which
+   * check the level and the rate limit first.
+   * \param fmt the printf format. It must be a string literal, as the ring
+   * buffer keeps its pointer until the records are dumped.
+   */
+  static void
+  write(log_level_t level, const char *file, int line, uint64_t suppressed,
+        const char *fmt, ...) LEO_PRINTF_FORMAT(5, 6);
+
+private:
+  static std::atomic<int> s_level;
+};
+
+} // namespace leo
+} // namespace gr
+
+#define LEO_LOG_AT(LEVEL, M, ...)                                              \
+  do {                                                                         \
+    if (gr::leo::logging::enabled(LEVEL)) {                                    \
+      static gr::leo::logging::rate_limiter leo_log_limiter_;                  \
+      if (leo_log_limiter_.allow()) {                                          \
+        gr::leo::logging::write(LEVEL, __FILE__, __LINE__,                     \
+                                leo_log_limiter_.take_suppressed(),            \
+                                M, ##__VA_ARGS__);                             \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+#define LEO_LOG_CLASS_INFO(CLASS_DEBUG_ENABLE, M, ...)                         \
+  do {                                                                         \
+    if (CLASS_DEBUG_ENABLE) {                                                  \
+      LEO_LOG_AT(gr::leo::LOG_LEVEL_INFO, M, ##__VA_ARGS__);                   \
+    }                                                                          \
+  } while (0)
+
+#define LEO_LOG_INFO(M, ...) LEO_LOG_AT(gr::leo::LOG_LEVEL_INFO, M, ##__VA_ARGS__)
+
+#define LEO_ERROR(M, ...) LEO_LOG_AT(gr::leo::LOG_LEVEL_ERROR, M, ##__VA_ARGS__)
+
+#define LEO_WARN(M, ...) LEO_LOG_AT(gr::leo::LOG_LEVEL_WARN, M, ##__VA_ARGS__)
+
+#define LEO_DEBUG(M, ...) LEO_LOG_AT(gr::leo::LOG_LEVEL_DEBUG, M, ##__VA_ARGS__)
+
+#define LEO_TRACE(M, ...) LEO_LOG_AT(gr::leo::LOG_LEVEL_TRACE, M, ##__VA_ARGS__)
+
+#endif /* INCLUDE_LEO_LOG_H_ */
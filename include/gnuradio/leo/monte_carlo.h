@@ -0,0 +1,170 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_MONTE_CARLO_H
+#define INCLUDED_LEO_MONTE_CARLO_H
+
+#include <gnuradio/leo/api.h>
+#include <gnuradio/leo/scenario.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+/*!
+ * \brief The random perturbations of the scenario between the realizations
+ * of a Monte-Carlo simulation. A zero spread keeps the parameter fixed.
+ */
+struct perturbation_t {
+  /*!
+   * \brief The standard deviation of the natural logarithm of the rainfall
+   * rate. The rate is log-normal with the mean of the scenario.
+   */
+  double rainfall_rate_sigma = 0;
+  /*!
+   * \brief The standard deviation in degrees of the ground station antenna
+   * pointing error, that is added to the one of the scenario. The error of
+   * each realization is the magnitude of a zero mean normal deviate.
+   */
+  double pointing_error_sigma = 0;
+  /*!
+   * \brief The standard deviation in seconds of the error of the TLE epoch,
+   * that shifts the satellite along its orbit.
+   */
+  double tle_epoch_sigma = 0;
+};
+
+/*!
+ * \brief The summary of a statistic of a Monte-Carlo simulation
+ */
+struct link_statistics_t {
+  uint64_t count = 0;
+  double mean = 0;
+  double stddev = 0;
+  double min = 0;
+  double max = 0;
+  /*!
+   * \brief The values at the requested percentiles
+   */
+  std::vector<double> percentiles;
+};
+
+/*!
+ * \brief Monte-Carlo simulation of the link budget of a scenario.
+ * \ingroup model
+ *
+ * \details
+ * Each realization perturbs the scenario, builds its own tracker and LEO
+ * model with a different seed and steps through the observation window,
+ * recording the link margin while the satellite is visible. The
+ * realizations are distributed to a pool of threads in blocks of
+ * consecutive realizations. The statistics of the blocks are merged in
+ * their order as the blocks finish, so the memory does not grow with the
+ * number of realizations or the length of the observation.
+ *
+ * Realization i uses a random stream derived only from the seed and i, and
+ * the blocks are always merged in the same order, so the results are
+ * identical for any number of threads.
+ */
+class LEO_API monte_carlo {
+public:
+  typedef std::shared_ptr<monte_carlo> monte_carlo_sptr;
+
+  /*!
+   * \param scenario the nominal scenario
+   * \param perturbation the spread of the perturbed parameters
+   * \param realizations the number of realizations
+   * \param outage_threshold_db the link margin in dB below which the link
+   * is considered out
+   * \param seed the seed of the simulation
+   */
+  static monte_carlo_sptr
+  make(const scenario_t &scenario, const perturbation_t &perturbation,
+       size_t realizations, double outage_threshold_db = 0,
+       unsigned int seed = 0);
+
+  virtual ~monte_carlo() {};
+
+  /*!
+   * \brief Run all the realizations, discarding the results of any previous
+   * run
+   * \param nthreads the number of threads. If 0, one per hardware thread.
+   */
+  virtual void
+  run(size_t nthreads = 0) = 0;
+
+  /*!
+   * \brief Get the number of realizations with the satellite visible for at
+   * least one time step
+   */
+  virtual size_t
+  get_passes() const = 0;
+
+  /*!
+   * \brief Get the statistics of the link margin in dB over all the visible
+   * time steps of all the realizations
+   * \param percentiles the requested percentiles in the range [0, 100]
+   */
+  virtual link_statistics_t
+  get_link_margin(const std::vector<double> &percentiles = {5, 50, 95})
+  const = 0;
+
+  /*!
+   * \brief Get the statistics of the minimum link margin in dB of each
+   * realization with a pass
+   * \param percentiles the requested percentiles in the range [0, 100]
+   */
+  virtual link_statistics_t
+  get_min_link_margin(const std::vector<double> &percentiles = {5, 50, 95})
+  const = 0;
+
+  /*!
+   * \brief Get the statistics of the fraction of the visible time steps
+   * that each realization with a pass spends in outage
+   * \param percentiles the requested percentiles in the range [0, 100]
+   */
+  virtual link_statistics_t
+  get_outage_fraction(const std::vector<double> &percentiles = {5, 50, 95})
+  const = 0;
+
+  /*!
+   * \brief Get the fraction of the realizations with a pass that have at
+   * least one time step in outage
+   */
+  virtual double
+  get_outage_probability() const = 0;
+};
+
+/*!
+ * \brief Shift the epoch of a TLE, keeping its orbital elements
+ * \param tle_1 the first line of the TLE
+ * \param seconds the shift of the epoch in seconds
+ * \return the first line with the new epoch and checksum
+ */
+LEO_API std::string
+shift_tle_epoch(const std::string &tle_1, double seconds);
+
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_MONTE_CARLO_H */
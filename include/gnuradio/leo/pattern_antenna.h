@@ -0,0 +1,73 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_PATTERN_ANTENNA_H
+#define INCLUDED_LEO_PATTERN_ANTENNA_H
+
+#include <gnuradio/leo/api.h>
+#include <gnuradio/leo/generic_antenna.h>
+#include <gnuradio/leo/leo_types.h>
+#include <string>
+
+namespace gr {
+namespace leo {
+namespace antenna {
+/*!
+ * \brief Class that represents an antenna with a tabulated radiation
+ * pattern.
+ *
+ * \details
+ *
+ * The pattern_antenna class extends the generic_antenna class to simulate
+ * an antenna from its measured or simulated gain at each direction, e.g.
+ * the radiation pattern of a NEC simulation. The gain is interpolated
+ * bilinearly from the table, that is parsed once and cached in a binary
+ * form.
+ */
+class LEO_API pattern_antenna : virtual public generic_antenna {
+
+public:
+
+  /*!
+   * \param type The enumeration that defines the type of the antenna. It
+   * must be PATTERN.
+   * \param frequency The frequency of the antenna in Hz
+   * \param polarization The enumeration that defines the antenna
+   * polarization
+   * \param pointing_error The pointing error of the antenna in degrees.
+   * \param filename The radiation pattern table. Each line holds theta, the
+   * angle from the boresight in degrees, phi, the azimuth around the
+   * boresight in degrees, and the gain in dBi, separated by commas or
+   * whitespace. The points must cover a regular grid in theta and phi.
+   *
+   * \return a std::shared_ptr to the constructed antenna object.
+   */
+  static generic_antenna::generic_antenna_sptr
+  make(antenna_t type, double frequency, polarization_t polarization,
+       double pointing_error, const std::string &filename);
+
+  pattern_antenna() {};
+
+};
+} // namespace antenna
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_PATTERN_ANTENNA_H */
@@ -30,15 +30,50 @@ namespace leo {
 namespace attenuation {
 /*!
  * \brief Precipitation loss following the ITU P.618 recommendation
+ *
+ * \details
+ * With PRECIPITATION_ITU or PRECIPITATION_CUSTOM the attenuation exceeded
+ * for 0.01% of an average year is reported at every time instance.
+ *
+ * With PRECIPITATION_STATISTICAL the attenuation is a time correlated rain
+ * fade, whose statistics follow the P.618 attenuation exceeded for a
+ * percentage of time, scaled from the rainfall rate exceeded for 0.01% of
+ * an average year. The fade is synthesized with the Maseng-Bakken model: a
+ * first order Gauss-Markov process with a time constant 1 / fade_dynamics,
+ * that is mapped to an exceedance probability. It rains for
+ * rain_probability percent of the time, and the attenuation is zero
+ * otherwise. The attenuation for each elevation angle and exceedance
+ * probability is tabulated once per frequency and polarization, so each
+ * time step costs a Gaussian sample and a bilinear interpolation.
  */
 class LEO_API precipitation_itu : virtual public generic_attenuation {
 
 public:
 
+  /*!
+   * \param rainfall_rate the rainfall rate exceeded for 0.01% of an average
+   * year in mm/h. Ignored with PRECIPITATION_ITU.
+   * \param tracker_lontitude the longitude of the ground station in degrees
+   * \param tracker_latitude the latitude of the ground station in degrees
+   * \param tracker_altitude the altitude of the ground station above the mean
+   * sea level in km. Ignored if topographic_altitude is true.
+   * \param mode PRECIPITATION_ITU, PRECIPITATION_CUSTOM or
+   * PRECIPITATION_STATISTICAL
+   * \param rain_probability the percentage of time with rain, in the
+   * range (0.001, 5]. Used only with PRECIPITATION_STATISTICAL.
+   * \param fade_dynamics the inverse of the time constant of the rain fade
+   * in 1/s. Used only with PRECIPITATION_STATISTICAL.
+   * \param seed the seed of the rain fade synthesizer. Used only with
+   * PRECIPITATION_STATISTICAL.
+   * \param topographic_altitude if true, the altitude of the ground station
+   * is interpolated from the topography of the ITU-R P.1511 recommendation
+   */
   static generic_attenuation::generic_attenuation_sptr
   make(double rainfall_rate, double tracker_lontitude,
        double tracker_latitude, double tracker_altitude,
-       impairment_enum_t mode);
+       impairment_enum_t mode, double rain_probability = 5.0,
+       double fade_dynamics = 2e-4, unsigned int seed = 0,
+       bool topographic_altitude = false);
 
 };
 } // namespace attenuation
@@ -0,0 +1,163 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_ROTATOR_H
+#define INCLUDED_LEO_ROTATOR_H
+
+#include <gnuradio/leo/api.h>
+#include <memory>
+
+namespace gr {
+namespace leo {
+
+/**
+ * \brief Rotator simulates the azimuth/elevation rotator that points the
+ * antenna of a ground station to the satellite.
+ * \ingroup tracker
+ *
+ * The controller of the rotator commands the look angle of the satellite
+ * every update interval, and each axis slews towards the command with a
+ * finite rate. The mechanical play of the gears is modeled as a backlash
+ * dead band between the motor and the antenna. The off-boresight angle
+ * between the antenna and the satellite is the pointing error of the
+ * rotator, which grows when the satellite moves faster than the rotator,
+ * like near the zenith where the azimuth rate of a pass diverges (the
+ * keyhole of the azimuth/elevation mounts).
+ *
+ * The azimuth travel starts at the north stop and may exceed 360 degrees
+ * to avoid unwinding in the middle of a pass. A mount with an elevation
+ * travel of 180 degrees can track the pass flipped over, with the azimuth
+ * opposite to the satellite, which avoids the keyhole. On every command the
+ * controller selects the position that the rotator reaches first.
+ *
+ * The state is integrated incrementally from the look angles the tracker
+ * has already computed for each time step. The look angle at the command
+ * instants between two steps is linearly interpolated.
+ */
+class LEO_API rotator {
+
+public:
+  using rotator_sptr = std::shared_ptr<rotator>;
+
+  /*!
+   * \param max_az_rate The maximum azimuth rate in degrees/sec
+   * \param max_el_rate The maximum elevation rate in degrees/sec
+   * \param backlash The backlash of each axis in degrees
+   * \param update_interval The interval between the commands of the
+   *        controller in seconds
+   * \param az_range The azimuth travel from the north stop in degrees. It
+   *        must be at least 360.
+   * \param max_elevation The maximum elevation of the mount in degrees,
+   *        90 or up to 180 for mounts that can flip over.
+   *
+   * \return a std::shared_ptr to the constructed rotator object.
+   */
+  static rotator_sptr
+  make(const double max_az_rate, const double max_el_rate,
+       const double backlash = 0, const double update_interval = 1,
+       const double az_range = 360, const double max_elevation = 90);
+
+  rotator(const double max_az_rate, const double max_el_rate,
+          const double backlash, const double update_interval,
+          const double az_range, const double max_elevation);
+
+  ~rotator();
+
+  /*!
+   * Advances the rotator to a new time instance of the observation.
+   * The first call points the antenna to the satellite. Going back in time,
+   * or a gap of more than a minute (e.g. between two passes) restarts the
+   * rotator pointing to the satellite.
+   * @param time the time in seconds
+   * @param azimuth the azimuth of the satellite in degrees
+   * @param elevation the elevation of the satellite in degrees
+   */
+  void
+  update(double time, double azimuth, double elevation);
+
+  /*!
+   * Restarts the rotator. The next update points the antenna to the
+   * satellite.
+   */
+  void
+  reset();
+
+  /*!
+   * Returns the angle between the boresight of the antenna and the
+   * satellite, at the last update.
+   * @return the pointing error in degrees.
+   */
+  double
+  get_pointing_error() const;
+
+  /*!
+   * Returns the azimuth of the antenna, from the north stop.
+   * @return the azimuth in degrees.
+   */
+  double
+  get_azimuth() const;
+
+  /*!
+   * Returns the elevation of the antenna.
+   * @return the elevation in degrees.
+   */
+  double
+  get_elevation() const;
+
+private:
+  const double d_max_az_rate;
+  const double d_max_el_rate;
+  const double d_backlash;
+  const double d_update_interval;
+  const double d_az_range;
+  const double d_max_elevation;
+
+  bool d_started;
+  double d_time;
+  double d_next_command;
+
+  /* The look angle of the satellite at the last update */
+  double d_target_az;
+  double d_target_el;
+
+  /* The position of the motors, the antenna and the command of each axis */
+  double d_motor_az;
+  double d_motor_el;
+  double d_antenna_az;
+  double d_antenna_el;
+  double d_command_az;
+  double d_command_el;
+
+  double d_pointing_error;
+
+  void
+  command(double azimuth, double elevation);
+
+  void
+  slew(double dt);
+
+  void
+  start(double time, double azimuth, double elevation);
+};
+
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_ROTATOR_H */
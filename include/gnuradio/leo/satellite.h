@@ -23,6 +23,7 @@
 
 #include <gnuradio/leo/api.h>
 #include <gnuradio/leo/generic_antenna.h>
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -40,7 +41,7 @@ namespace leo {
  */
 class LEO_API satellite {
 public:
-  static int base_unique_id;
+  static std::atomic<int> base_unique_id;
 
   int my_id;
 
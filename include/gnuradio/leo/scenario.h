@@ -0,0 +1,180 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_SCENARIO_H
+#define INCLUDED_LEO_SCENARIO_H
+
+#include <gnuradio/leo/api.h>
+#include <gnuradio/leo/generic_antenna.h>
+#include <gnuradio/leo/generic_model.h>
+#include <gnuradio/leo/leo_types.h>
+#include <gnuradio/leo/tracker.h>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+/*!
+ * \brief The description of an antenna of a scenario.
+ *
+ * \details
+ * The meaning of the parameters depends on the type of the antenna:
+ * - YAGI: the boom length in meters
+ * - HELIX: the number of turns, the turn spacing and the circumference in
+ * wavelengths
+ * - PARABOLIC_REFLECTOR: the diameter in meters and the aperture efficiency
+ * - CUSTOM: the gain in dBi, the beamwidth in degrees and the roll-off gain
+ * - QUADRIFILAR_HELIX: the loop length in meters
+ * - MONOPOLE, DIPOLE: none
+ * - PATTERN: none, the pattern is read from the pattern file
+ */
+struct antenna_config_t {
+  antenna_t type = DIPOLE;
+  polarization_t polarization = LINEAR_VERTICAL;
+  double pointing_error = 0;
+  double params[3] = {0, 0, 0};
+  std::string pattern_file;
+};
+
+/*!
+ * \brief A complete link scenario: a satellite, a ground station, an
+ * observation window and the impairments of the channel.
+ *
+ * \details
+ * The uplink frequency is the transmission frequency of the ground station
+ * and the reception frequency of the satellite, the downlink frequency the
+ * opposite. The same antenna is used for transmission and reception.
+ * Frequencies are in Hz, powers in dBm and temperatures in Kelvin. The
+ * coordinates of the ground station are in degrees and its altitude in km.
+ * If gs_topographic_alt is set, the altitude of the ground station is
+ * interpolated from the topography of the ITU-R P.1511 recommendation
+ * instead.
+ */
+struct scenario_t {
+  std::string name;
+
+  /* The satellite */
+  std::string tle_title;
+  std::string tle_1;
+  std::string tle_2;
+  double sat_tx_power_dbm = 30;
+  antenna_config_t sat_antenna;
+  double sat_noise_figure = 5;
+  double sat_noise_temp = 290;
+  double sat_rx_bw = 10e3;
+
+  /* The ground station */
+  double gs_lat = 0;
+  double gs_lon = 0;
+  double gs_alt = 0;
+  bool gs_topographic_alt = false;
+  double gs_tx_power_dbm = 30;
+  antenna_config_t gs_antenna;
+  double gs_noise_figure = 1;
+  double gs_noise_temp = 290;
+  double gs_rx_bw = 10e3;
+
+  /* The observation */
+  std::string obs_start;
+  std::string obs_end;
+  double time_step_us = 1e6;
+  double uplink_freq = 435e6;
+  double downlink_freq = 435e6;
+
+  /* The channel */
+  link_mode_t mode = DOWNLINK;
+  impairment_enum_t fspl = FREE_SPACE_PATH_LOSS;
+  impairment_enum_t pointing = ANTENNA_POINTING_LOSS;
+  impairment_enum_t doppler = DOPPLER_SHIFT;
+  impairment_enum_t atmo = ATMO_GASES_REGRESSION;
+  impairment_enum_t precipitation = IMPAIRMENT_NONE;
+  double surface_watervap_density = 7.5;
+  double temperature = 20;
+  double rainfall_rate = 25;
+  double rain_probability = 5.0;
+  double fade_dynamics = 2e-4;
+  unsigned int seed = 0;
+};
+
+namespace scenario {
+
+/*!
+ * \brief Create an antenna of a scenario
+ * \param config the description of the antenna
+ * \param frequency the operating frequency of the antenna in Hz
+ */
+LEO_API generic_antenna::generic_antenna_sptr
+make_antenna(const antenna_config_t &config, double frequency);
+
+/*!
+ * \brief Create the satellite and the tracker of a scenario.
+ * Every call returns new instances, that share no state with the instances
+ * of previous calls.
+ */
+LEO_API tracker::tracker_sptr
+make_tracker(const scenario_t &scenario);
+
+/*!
+ * \brief Create the LEO channel model of a scenario, with the link margin
+ * estimation enabled
+ * \param scenario the scenario
+ * \param tracker the tracker of the scenario. If it is null, a new one is
+ * created with make_tracker().
+ */
+LEO_API generic_model::generic_model_sptr
+make_model(const scenario_t &scenario, tracker::tracker_sptr tracker = nullptr);
+
+/*!
+ * \brief Load the scenarios of a scenario file.
+ *
+ * \details
+ * The file is made of INI sections with key = value lines. Comments start
+ * with # or ;. The [observation] section sets the observation window and
+ * the channel of all the scenarios, with the keys start, end, time_step_us,
+ * uplink_freq, downlink_freq, mode, fspl, pointing, doppler, atmo,
+ * precipitation, surface_watervap_density, temperature, rainfall_rate,
+ * rain_probability, fade_dynamics and seed.
+ *
+ * Each [satellite NAME] section describes a satellite with the keys tle1,
+ * tle2, tx_power_dbm, antenna, polarization, pointing_error,
+ * antenna_params, pattern_file, noise_figure, noise_temp and rx_bw.
+ * Instead of tle1 and tle2, tle_file loads all the satellites of a TLE
+ * file, with the rest of the keys of the section. Each [station NAME]
+ * section describes a ground station with the keys lat, lon, alt and the
+ * same transmitter, antenna and receiver keys. An alt of auto takes the
+ * altitude from the ITU-R P.1511 topography.
+ *
+ * A scenario is created for each pair of a satellite and a station, named
+ * SATELLITE_STATION. Enumerations are given by their name in
+ * gr::leo, e.g. ATMO_GASES_ITU or RHCP, or by their value. Relative paths
+ * are relative to the directory of the file.
+ *
+ * \param filename the scenario file
+ * \return the scenarios, ordered by satellite and then by station
+ */
+LEO_API std::vector<scenario_t>
+load(const std::string &filename);
+
+} // namespace scenario
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_SCENARIO_H */
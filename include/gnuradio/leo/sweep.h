@@ -0,0 +1,204 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_SWEEP_H
+#define INCLUDED_LEO_SWEEP_H
+
+#include <gnuradio/leo/api.h>
+#include <gnuradio/leo/leo_types.h>
+#include <gnuradio/leo/scenario.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+/*!
+ * \brief An axis of a parameter sweep: a parameter and its values
+ */
+struct sweep_axis_t {
+  sweep_param_t param = SWEEP_GS_TX_POWER;
+  std::vector<double> values;
+};
+
+/*!
+ * \brief The link budget of a point of a parameter sweep, over the time
+ * steps of the observation with the satellite visible
+ */
+struct sweep_result_t {
+  uint64_t visible_steps = 0;
+  double min_link_margin = 0;
+  double mean_link_margin = 0;
+  double max_link_margin = 0;
+  /*!
+   * \brief The fraction of the visible time steps with the link margin
+   * below the outage threshold
+   */
+  double outage_fraction = 0;
+};
+
+/*!
+ * \brief The time steps of the link budget of a point of a parameter sweep
+ */
+struct link_timeline_t {
+  /*!
+   * \brief The times in microseconds since the Unix epoch
+   */
+  std::vector<int64_t> time;
+  /*!
+   * \brief The azimuths in degrees, clockwise from the north
+   */
+  std::vector<double> azimuth;
+  /*!
+   * \brief The elevations in degrees
+   */
+  std::vector<double> elevation;
+  /*!
+   * \brief The slant ranges in km
+   */
+  std::vector<double> slant_range;
+  /*!
+   * \brief The Doppler shifts of the link frequency in Hz
+   */
+  std::vector<double> doppler_shift;
+  /*!
+   * \brief The total attenuation in dB, including the pointing loss
+   */
+  std::vector<double> attenuation;
+  /*!
+   * \brief The link margins in dB
+   */
+  std::vector<double> link_margin;
+};
+
+/*!
+ * \brief Link budget of many variations of a scenario, for trade studies.
+ * \ingroup model
+ *
+ * \details
+ * The link budget of a time step is split in three stages, each cached
+ * separately and shared by all the points that agree on its inputs:
+ * - the geometry, that depends on the orbit, the ground station location and
+ * the observation window. It is propagated once per distinct combination.
+ * - the attenuation of the atmosphere, the precipitation and the path loss,
+ * that additionally depends on the frequency, the polarization and the
+ * weather. It is evaluated once per distinct combination, over the cached
+ * geometry.
+ * - the budget itself, that depends on the antennas, the powers and the
+ * receiver. It is evaluated for every point and costs a few operations per
+ * time step.
+ *
+ * So sweeping the transmission power or the antenna size reuses both the
+ * geometry and the attenuation, and sweeping the frequency reuses the
+ * geometry. The stages are evaluated by a pool of threads. The results
+ * match the link margin of a LEO model built for each point with
+ * gr::leo::scenario::make_model().
+ */
+class LEO_API sweep {
+public:
+  typedef std::shared_ptr<sweep> sweep_sptr;
+
+  /*!
+   * \param points the scenarios of the sweep
+   * \param outage_threshold_db the link margin in dB below which the link
+   * is considered out
+   */
+  static sweep_sptr
+  make(const std::vector<scenario_t> &points, double outage_threshold_db = 0);
+
+  /*!
+   * \brief Build the Cartesian product of some axes around a scenario. The
+   * last axis varies the fastest.
+   * \param base the scenario with the parameters that do not vary
+   * \param axes the axes of the sweep
+   */
+  static std::vector<scenario_t>
+  grid(const scenario_t &base, const std::vector<sweep_axis_t> &axes);
+
+  /*!
+   * \brief Set a parameter of a scenario
+   */
+  static void
+  set_param(scenario_t &scenario, sweep_param_t param, double value);
+
+  virtual ~sweep() {};
+
+  /*!
+   * \brief Compute the link budget of all the points
+   * \param nthreads the number of threads. If 0, one per hardware thread.
+   */
+  virtual void
+  run(size_t nthreads = 0) = 0;
+
+  /*!
+   * \brief Get the link budget of each point, in the order of the points
+   */
+  virtual std::vector<sweep_result_t>
+  get_results() const = 0;
+
+  /*!
+   * \brief Get the link margin of a point at every time step, from the
+   * cached geometry and attenuation of the last run
+   * \param point the index of the point
+   * \return the link margin in dB, NaN at the time steps with the satellite
+   * not visible
+   */
+  virtual std::vector<double>
+  get_link_margin(size_t point) const = 0;
+
+  /*!
+   * \brief Get the geometry and the link budget of a point at the time steps
+   * of the observation, from the cached stages of the last run
+   * \param point the index of the point
+   * \param visible_only keep only the time steps with the satellite visible.
+   * Otherwise the attenuation and the link margin are NaN at the rest.
+   */
+  virtual link_timeline_t
+  get_timeline(size_t point, bool visible_only = true) const = 0;
+
+  /*!
+   * \brief Get the passes of the observation of each point. The passes are
+   * searched once per distinct geometry, by a pool of threads, and do not
+   * need a run of the sweep.
+   * \param pass_step the step of the pass search in seconds
+   * \param nthreads the number of threads. If 0, one per hardware thread.
+   * \return the passes of each point, in the order of the points
+   */
+  virtual std::vector<std::vector<pass_info_t>>
+  get_passes(int pass_step = 60, size_t nthreads = 0) const = 0;
+
+  /*!
+   * \brief Get the number of distinct geometries of the sweep
+   */
+  virtual size_t
+  get_geometry_count() const = 0;
+
+  /*!
+   * \brief Get the number of distinct attenuation timelines of the sweep
+   */
+  virtual size_t
+  get_attenuation_count() const = 0;
+};
+
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_SWEEP_H */
@@ -28,9 +28,12 @@
 #include <libsgp4/CoordGeodetic.h>
 #include <libsgp4/Observer.h>
 #include <libsgp4/SGP4.h>
+#include <libsgp4/Vector.h>
+#include <atomic>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <utility>
 
 namespace gr {
 namespace leo {
@@ -53,7 +56,7 @@ namespace leo {
 class LEO_API tracker {
 
 public:
-  static int base_unique_id;
+  static std::atomic<int> base_unique_id;
 
   int my_id;
 
@@ -160,6 +163,28 @@ public:
   std::vector<pass_details_t>
   generate_passlist(const int time_step);
 
+  /*!
+   * Generates the passes of the observation in numeric form, without any
+   * string formatting or console output. The pass windows that
+   * get_time_to_next_aos_us() relies on are updated, but the string pass
+   * list of generate_passlist() is not built.
+   * @param time_step the step of the search in seconds
+   * @return a std::vector of pass_info_t satellite passes.
+   */
+  std::vector<pass_info_t>
+  generate_passes(const int time_step);
+
+  /*!
+   * Returns the time remaining until the acquisition of signal of the next
+   * pass, based on the pass list of the observation. If no pass list has
+   * been generated yet, it is generated silently with a 10 seconds step.
+   * @return the time in microseconds until the next AOS. Zero if the
+   * satellite is currently inside a pass, or the time remaining until the end
+   * of the observation if there are no more passes.
+   */
+  double
+  get_time_to_next_aos_us();
+
   /*!
    * Get the observed satellite.
    * @return a boost::shared_ptr to the observed satellite.
@@ -192,6 +217,24 @@ public:
   double
   get_elevation_radians();
 
+  /*!
+   * Returns the azimuth of satellite in degrees at
+   * the specific moment inside the observation.
+   * @return a double representing the current azimuth of the satellite,
+   * clockwise from the north.
+   */
+  double
+  get_azimuth_degrees();
+
+  /*!
+   * Returns the azimuth of satellite in radians at
+   * the specific moment inside the observation.
+   * @return a double representing the current azimuth of the satellite,
+   * clockwise from the north.
+   */
+  double
+  get_azimuth_radians();
+
   /*!
    * Returns the range rate of the observed satellite in kilometers/sec, at
    * the specific moment inside the observation.
@@ -200,6 +243,32 @@ public:
   double
   get_velocity();
 
+  /*!
+   * Returns the Earth-centered inertial position and velocity of the
+   * satellite and the position of the ground station, at the specific
+   * moment inside the observation.
+   * @return the ECI state in km and km/sec.
+   */
+  eci_state_t
+  get_eci_state();
+
+  /*!
+   * Computes the geometry of the observation for a series of time
+   * instances, without changing the elapsed time of the observation.
+   * Each time instance costs a single SGP4 propagation, and the method does
+   * not modify the tracker, so it can run concurrently with other threads
+   * that only read it.
+   * @param time the times in seconds since the start of the observation
+   * @param n the number of time instances
+   * @param range the slant ranges in kilometers
+   * @param range_rate the range rates in kilometers/sec
+   * @param azimuth the azimuths in degrees, clockwise from the north
+   * @param elevation the elevations in degrees
+   */
+  void
+  get_geometry_batch(const double *time, size_t n, double *range,
+                     double *range_rate, double *azimuth,
+                     double *elevation) const;
 
   /*!
    * Returns the time resolution of the observation in microseconds.
@@ -216,6 +285,14 @@ public:
   void
   advance_time(double us);
 
+  /*!
+   * Sets the absolute timing of the simulation. Used when the observation
+   * follows an external clock instead of the processed samples.
+   * @param t the new time of the observation
+   */
+  void
+  set_elapsed_time(const libsgp4::DateTime &t);
+
   /*!
    * Checks whether the observation is over.
    * @return true if the observation is over,  false otherwise.
@@ -310,6 +387,13 @@ public:
 
 private:
   std::vector<pass_details_t> d_passlist;
+
+  /**
+   * The AOS and LOS of each pass in the pass list, kept in libSGP4 form to
+   * avoid parsing the string representation of pass_details_t
+   */
+  std::vector<std::pair<libsgp4::DateTime, libsgp4::DateTime>> d_pass_windows;
+  bool d_passlist_generated;
   libsgp4::Observer d_observer;
   satellite::satellite_sptr d_satellite;
 
@@ -342,6 +426,23 @@ private:
   generic_antenna::generic_antenna_sptr d_tx_antenna;
   generic_antenna::generic_antenna_sptr d_rx_antenna;
 
+  /**
+   * The look angle of the satellite at d_look_time. The getters of the
+   * geometry share a single SGP4 solution for each time step.
+   */
+  libsgp4::CoordTopocentric d_look;
+  libsgp4::Vector d_sat_position;
+  libsgp4::Vector d_sat_velocity;
+  libsgp4::DateTime d_look_time;
+  bool d_look_valid;
+
+  /*!
+   * Returns the look angle of the satellite at the elapsed time of the
+   * observation, propagating the orbit only if the time has changed.
+   */
+  const libsgp4::CoordTopocentric &
+  look_angle();
+
   /*!
    * Converts an ISO-8601 UTC timestamp into a libSGP4 DateTime object.
    */
@@ -350,12 +451,19 @@ private:
 
   /*!
    * Calculates the maximum elevation of a satellite for a specific
-   * observation timeframe.
+   * observation timeframe and optionally the time that it occurs.
    */
   double find_max_elevation(libsgp4::Observer& observer,
                             libsgp4::SGP4& sgp4,
                             const libsgp4::DateTime& aos,
-                            const libsgp4::DateTime& los);
+                            const libsgp4::DateTime& los,
+                            libsgp4::DateTime *max_time = nullptr);
+
+  /*!
+   * Appends a pass to the pass windows and returns its numeric form.
+   */
+  pass_info_t
+  add_pass(const libsgp4::DateTime &aos, const libsgp4::DateTime &los);
 
   /*!
    * Estimates the timestamp that an orbiting satellite crosses the horizon.
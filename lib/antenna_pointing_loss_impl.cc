@@ -24,6 +24,10 @@
 
 #include "antenna_pointing_loss_impl.h"
 #include <gnuradio/leo/log.h>
+#include <gnuradio/leo/utils/helper.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 namespace gr {
 namespace leo {
@@ -32,19 +36,34 @@ namespace attenuation {
 generic_attenuation::generic_attenuation_sptr
 antenna_pointing_loss::make(generic_antenna::generic_antenna_sptr
                             tracker_antenna,
-                            generic_antenna::generic_antenna_sptr satellite_antenna)
+                            generic_antenna::generic_antenna_sptr satellite_antenna,
+                            impairment_enum_t mode,
+                            rotator::rotator_sptr rotator,
+                            attitude::attitude_sptr attitude)
 {
   return generic_attenuation::generic_attenuation_sptr(
-           new antenna_pointing_loss_impl(tracker_antenna, satellite_antenna));
+           new antenna_pointing_loss_impl(tracker_antenna, satellite_antenna,
+                                          mode, rotator, attitude));
 }
 
 antenna_pointing_loss_impl::antenna_pointing_loss_impl(
   generic_antenna::generic_antenna_sptr tracker_antenna,
-  generic_antenna::generic_antenna_sptr satellite_antenna) :
+  generic_antenna::generic_antenna_sptr satellite_antenna,
+  impairment_enum_t mode,
+  rotator::rotator_sptr rotator,
+  attitude::attitude_sptr attitude) :
+  generic_attenuation(),
   d_tracker_antenna(tracker_antenna),
   d_satellite_antenna(satellite_antenna),
-  generic_attenuation()
+  d_mode(mode),
+  d_rotator(rotator),
+  d_attitude(attitude)
 {
+  if (mode != ANTENNA_POINTING_LOSS
+      && mode != ANTENNA_POINTING_LOSS_GEOMETRIC) {
+    throw std::invalid_argument(
+      "antenna_pointing_loss: invalid antenna pointing loss enumeration");
+  }
 }
 
 antenna_pointing_loss_impl::~antenna_pointing_loss_impl()
@@ -55,7 +74,37 @@ double
 antenna_pointing_loss_impl::get_attenuation()
 {
   double attenuation = 0;
-//        attenuation += d_tracker_antenna->get_gain_rolloff();
+
+  /* The static error of the antenna adds to the tracking error of the rotator */
+  if (d_rotator) {
+    attenuation += d_tracker_antenna->get_gain_rolloff(
+                     d_tracker_antenna->get_pointing_error()
+                     + utils::degrees_to_radians(d_rotator->get_pointing_error()),
+                     0);
+  }
+  else if (d_mode == ANTENNA_POINTING_LOSS_GEOMETRIC) {
+    attenuation += d_tracker_antenna->get_gain_rolloff();
+  }
+
+  if (d_attitude) {
+    attenuation += d_satellite_antenna->get_gain_rolloff(
+                     d_attitude->get_off_boresight()
+                     + d_satellite_antenna->get_pointing_error(),
+                     d_attitude->get_azimuth());
+    return attenuation;
+  }
+  if (d_mode == ANTENNA_POINTING_LOSS_GEOMETRIC) {
+    /* The angle between the nadir of the satellite and the ground station */
+    const double r = std::sqrt(EARTH_RADIUS * EARTH_RADIUS
+                               + slant_range * slant_range
+                               + 2 * EARTH_RADIUS * slant_range
+                               * std::sin(elevation_angle));
+    const double nadir = std::asin(std::min(1.0, EARTH_RADIUS
+                                            * std::cos(elevation_angle) / r));
+    attenuation += d_satellite_antenna->get_gain_rolloff(
+                     nadir + d_satellite_antenna->get_pointing_error(), 0);
+    return attenuation;
+  }
   attenuation += d_satellite_antenna->get_gain_rolloff();
   return attenuation;
 }
@@ -32,7 +32,10 @@ class LEO_API antenna_pointing_loss_impl : public antenna_pointing_loss {
 public:
   antenna_pointing_loss_impl(generic_antenna::generic_antenna_sptr
                              tracker_antenna,
-                             generic_antenna::generic_antenna_sptr satellite_antenna);
+                             generic_antenna::generic_antenna_sptr satellite_antenna,
+                             impairment_enum_t mode,
+                             rotator::rotator_sptr rotator,
+                             attitude::attitude_sptr attitude);
 
   ~antenna_pointing_loss_impl();
 
@@ -42,6 +45,9 @@ public:
 private:
   generic_antenna::generic_antenna_sptr d_tracker_antenna;
   generic_antenna::generic_antenna_sptr d_satellite_antenna;
+  impairment_enum_t d_mode;
+  rotator::rotator_sptr d_rotator;
+  attitude::attitude_sptr d_attitude;
 
 };
 } // namespace attenuation
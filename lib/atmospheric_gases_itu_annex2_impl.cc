@@ -0,0 +1,231 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "atmospheric_gases_itu_annex2_impl.h"
+#include <algorithm>
+#include <cmath>
+#include <gnuradio/leo/utils/helper.h>
+
+namespace gr {
+namespace leo {
+namespace attenuation {
+
+/* Effective Earth radius for the low elevation paths, in km */
+static const double EFFECTIVE_EARTH_RADIUS = 8500;
+
+generic_attenuation::generic_attenuation_sptr
+atmospheric_gases_itu_annex2::make(double watervap, double temperature,
+                                   double pressure)
+{
+  return generic_attenuation::generic_attenuation_sptr(
+           new atmospheric_gases_itu_annex2_impl(watervap, temperature,
+               pressure));
+}
+
+atmospheric_gases_itu_annex2_impl::atmospheric_gases_itu_annex2_impl(
+  double surface_watervap_density, double temperature, double pressure) :
+  generic_attenuation(),
+  d_surface_watervap_density(surface_watervap_density),
+  d_rp(pressure / 1013.0),
+  d_rt(288.0 / (273.0 + temperature)),
+  d_cached_frequency(-1),
+  d_gamma_o(0),
+  d_gamma_w(0),
+  d_h_o(0),
+  d_h_w(0)
+{
+  if (pressure <= 0) {
+    throw std::invalid_argument("atmospheric_gases_itu_annex2: invalid pressure");
+  }
+  if (temperature <= -273) {
+    throw std::invalid_argument("atmospheric_gases_itu_annex2: invalid temperature");
+  }
+}
+
+atmospheric_gases_itu_annex2_impl::~atmospheric_gases_itu_annex2_impl()
+{
+}
+
+double
+atmospheric_gases_itu_annex2_impl::phi(double a, double b, double c,
+                                       double d) const
+{
+  return std::pow(d_rp, a) * std::pow(d_rt, b)
+         * std::exp(c * (1 - d_rp) + d * (1 - d_rt));
+}
+
+double
+atmospheric_gases_itu_annex2_impl::oxygen_specific_attenuation(double f) const
+{
+  const double rp2 = d_rp * d_rp;
+
+  if (f <= 54) {
+    const double xi1 = phi(0.0717, -1.8132, 0.0156, -1.6515);
+    const double xi2 = phi(0.5146, -4.6368, -0.1921, -5.7416);
+    const double xi3 = phi(0.3414, -6.5851, 0.2130, -8.5854);
+    return (7.2 * std::pow(d_rt, 2.8)
+            / (f * f + 0.34 * rp2 * std::pow(d_rt, 1.6))
+            + 0.62 * xi3 / (std::pow(54 - f, 1.16 * xi1) + 0.83 * xi2))
+           * f * f * rp2 * 1e-3;
+  }
+  if (f <= 66) {
+    const double g54 = 2.192 * phi(1.8286, -1.9487, 0.4051, -2.8509);
+    const double g58 = 12.59 * phi(1.0045, 3.5610, 0.1588, 1.2834);
+    const double g60 = 15.0 * phi(0.9003, 4.1335, 0.0427, 1.6088);
+    const double g62 = 14.28 * phi(0.9886, 3.4176, 0.1827, 1.3429);
+    const double g64 = 6.819 * phi(1.4320, 0.6258, 0.3177, -0.5914);
+    const double g66 = 1.908 * phi(2.0717, -4.1404, 0.4910, -4.8718);
+    if (f <= 60) {
+      return std::exp(std::log(g54) / 24 * (f - 58) * (f - 60)
+                      - std::log(g58) / 8 * (f - 54) * (f - 60)
+                      + std::log(g60) / 12 * (f - 54) * (f - 58));
+    }
+    if (f <= 62) {
+      return g60 + (g62 - g60) * (f - 60) / 2;
+    }
+    return std::exp(std::log(g62) / 8 * (f - 64) * (f - 66)
+                    - std::log(g64) / 4 * (f - 62) * (f - 66)
+                    + std::log(g66) / 8 * (f - 62) * (f - 64));
+  }
+  if (f <= 120) {
+    const double xi4 = phi(-0.0112, 0.0092, -0.1033, -0.0009);
+    const double xi5 = phi(0.2705, -2.7192, -0.3016, -4.1033);
+    const double xi6 = phi(0.2445, -5.9191, 0.0422, -8.0719);
+    const double xi7 = phi(-0.1833, 6.5589, -0.2402, 6.131);
+    return (3.02e-4 * std::pow(d_rt, 3.5)
+            + 0.283 * std::pow(d_rt, 3.8)
+            / (std::pow(f - 118.75, 2) + 2.91 * rp2 * std::pow(d_rt, 1.6))
+            + 0.502 * xi6 * (1 - 0.0163 * xi7 * (f - 66))
+            / (std::pow(f - 66, 1.4346 * xi4) + 1.15 * xi5))
+           * f * f * rp2 * 1e-3;
+  }
+  const double delta = -0.00306 * phi(3.211, -14.94, 1.583, -16.37);
+  return (3.02e-4 / (1 + 1.9e-5 * std::pow(f, 1.5))
+          + 0.283 * std::pow(d_rt, 0.3)
+          / (std::pow(f - 118.75, 2) + 2.91 * rp2 * std::pow(d_rt, 1.6)))
+         * f * f * rp2 * std::pow(d_rt, 3.5) * 1e-3 + delta;
+}
+
+double
+atmospheric_gases_itu_annex2_impl::water_vapour_specific_attenuation(
+  double f) const
+{
+  const double rho = d_surface_watervap_density;
+  const double eta1 = 0.955 * d_rp * std::pow(d_rt, 0.68) + 0.006 * rho;
+  const double eta2 = 0.735 * d_rp * std::pow(d_rt, 0.5)
+                      + 0.0353 * std::pow(d_rt, 4) * rho;
+  const double e1 = eta1 * eta1;
+  auto g = [f](double fi) {
+    return 1 + std::pow((f - fi) / (f + fi), 2);
+  };
+  auto x = [this](double c) {
+    return std::exp(c * (1 - d_rt));
+  };
+
+  const double sum =
+    3.98 * eta1 * x(2.23) / (std::pow(f - 22.235, 2) + 9.42 * e1) * g(22)
+    + 11.96 * eta1 * x(0.7) / (std::pow(f - 183.31, 2) + 11.14 * e1)
+    + 0.081 * eta1 * x(6.44) / (std::pow(f - 321.226, 2) + 6.29 * e1)
+    + 3.66 * eta1 * x(1.6) / (std::pow(f - 325.153, 2) + 9.22 * e1)
+    + 25.37 * eta1 * x(1.09) / std::pow(f - 380, 2)
+    + 17.4 * eta1 * x(1.46) / std::pow(f - 448, 2)
+    + 844.6 * eta1 * x(0.17) / std::pow(f - 557, 2) * g(557)
+    + 290 * eta1 * x(0.41) / std::pow(f - 752, 2) * g(752)
+    + 8.3328e4 * eta2 * x(0.99) / std::pow(f - 1780, 2) * g(1780);
+  return sum * f * f * std::pow(d_rt, 2.5) * rho * 1e-4;
+}
+
+double
+atmospheric_gases_itu_annex2_impl::oxygen_equivalent_height(double f) const
+{
+  const double t1 = 4.64 / (1 + 0.066 * std::pow(d_rp, -2.3))
+                    * std::exp(-std::pow((f - 59.7)
+                                         / (2.87 + 12.4 * std::exp(-7.9 * d_rp)), 2));
+  const double t2 = 0.14 * std::exp(2.12 * d_rp)
+                    / (std::pow(f - 118.75, 2) + 0.031 * std::exp(2.2 * d_rp));
+  const double t3 = 0.0114 / (1 + 0.14 * std::pow(d_rp, -2.6)) * f
+                    * (-0.0247 + 0.0001 * f + 1.61e-6 * f * f)
+                    / (1 - 0.0169 * f + 4.1e-5 * f * f + 3.2e-7 * f * f * f);
+  double h = 6.1 / (1 + 0.17 * std::pow(d_rp, -1.1)) * (1 + t1 + t2 + t3);
+  if (f < 70) {
+    h = std::min(h, 10.7 * std::pow(d_rp, 0.3));
+  }
+  return h;
+}
+
+double
+atmospheric_gases_itu_annex2_impl::water_vapour_equivalent_height(
+  double f) const
+{
+  const double sigma = 1.013 / (1 + std::exp(-8.6 * (d_rp - 0.57)));
+  return 1.66 * (1
+                 + 1.39 * sigma / (std::pow(f - 22.235, 2) + 2.56 * sigma)
+                 + 3.37 * sigma / (std::pow(f - 183.31, 2) + 4.69 * sigma)
+                 + 1.58 * sigma / (std::pow(f - 325.1, 2) + 2.89 * sigma));
+}
+
+void
+atmospheric_gases_itu_annex2_impl::update_frequency()
+{
+  d_gamma_o = oxygen_specific_attenuation(frequency);
+  d_gamma_w = water_vapour_specific_attenuation(frequency);
+  d_h_o = oxygen_equivalent_height(frequency);
+  d_h_w = water_vapour_equivalent_height(frequency);
+  d_cached_frequency = frequency;
+}
+
+double
+atmospheric_gases_itu_annex2_impl::get_attenuation()
+{
+  /* The frequency rarely changes, everything else is per elevation */
+  if (frequency != d_cached_frequency) {
+    update_frequency();
+  }
+
+  const double elev = std::max(elevation_angle, 0.0);
+  if (utils::radians_to_degrees(elev) >= 5) {
+    return (d_gamma_o * d_h_o + d_gamma_w * d_h_w) / std::sin(elev);
+  }
+
+  /* Eq. (29) for the paths close to the horizon */
+  auto F = [](double x) {
+    return 1.0 / (0.661 * x + 0.339 * std::sqrt(x * x + 5.51));
+  };
+  const double re = EFFECTIVE_EARTH_RADIUS;
+  return std::sqrt(re) / std::cos(elev)
+         * (d_gamma_o * std::sqrt(d_h_o)
+            * F(std::tan(elev) * std::sqrt(re / d_h_o))
+            + d_gamma_w * std::sqrt(d_h_w)
+            * F(std::tan(elev) * std::sqrt(re / d_h_w)));
+}
+
+bool
+atmospheric_gases_itu_annex2_impl::is_reentrant() const
+{
+  return true;
+}
+
+} /* namespace attenuation */
+} /* namespace leo */
+} /* namespace gr */
@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_ATMOSPHERIC_GASES_ITU_ANNEX2_IMPL_H
+#define INCLUDED_LEO_ATMOSPHERIC_GASES_ITU_ANNEX2_IMPL_H
+
+#include "../include/gnuradio/leo/atmospheric_gases_itu_annex2.h"
+
+namespace gr {
+namespace leo {
+namespace attenuation {
+
+class LEO_API atmospheric_gases_itu_annex2_impl : public
+  atmospheric_gases_itu_annex2 {
+
+public:
+  atmospheric_gases_itu_annex2_impl(double surface_watervap_density,
+                                    double temperature, double pressure);
+
+  ~atmospheric_gases_itu_annex2_impl();
+
+  double
+  get_attenuation();
+
+  /*!
+   * \brief Specific attenuation of dry air at the surface, Eq. (22)
+   * \param f the frequency in GHz
+   * \return the specific attenuation in dB/km
+   */
+  double
+  oxygen_specific_attenuation(double f) const;
+
+  /*!
+   * \brief Specific attenuation of water vapour at the surface, Eq. (23)
+   * \param f the frequency in GHz
+   * \return the specific attenuation in dB/km
+   */
+  double
+  water_vapour_specific_attenuation(double f) const;
+
+  /*!
+   * \brief Equivalent height of dry air, Eq. (25)
+   * \param f the frequency in GHz
+   * \return the height in km
+   */
+  double
+  oxygen_equivalent_height(double f) const;
+
+  /*!
+   * \brief Equivalent height of water vapour, Eq. (26)
+   * \param f the frequency in GHz
+   * \return the height in km
+   */
+  double
+  water_vapour_equivalent_height(double f) const;
+
+protected:
+  bool
+  is_reentrant() const override;
+
+private:
+  const double d_surface_watervap_density;
+  const double d_rp;
+  const double d_rt;
+
+  /* The frequency dependent terms, valid for d_cached_frequency */
+  double d_cached_frequency;
+  double d_gamma_o;
+  double d_gamma_w;
+  double d_h_o;
+  double d_h_w;
+
+  double
+  phi(double a, double b, double c, double d) const;
+
+  void
+  update_frequency();
+};
+
+} // namespace attenuation
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_ATMOSPHERIC_GASES_ITU_ANNEX2_IMPL_H */
@@ -40,9 +40,6 @@ atmospheric_gases_itu::make(double surface_watervap_density)
 atmospheric_gases_itu_impl::atmospheric_gases_itu_impl(
   double surface_watervap_density) :
   generic_attenuation(),
-  d_temperature(0),
-  d_oxygen_pressure(0),
-  d_water_pressure(0),
   d_surface_watervap_density(surface_watervap_density)
 {
 }
@@ -208,17 +205,18 @@ atmospheric_gases_itu_impl::get_water_vapour_pressure(double alt)
 }
 
 double
-atmospheric_gases_itu_impl::S(size_t index, atmo_element_t element)
+atmospheric_gases_itu_impl::S(size_t index, atmo_element_t element,
+                              const layer_t &layer)
 {
-  double theta = 300 / d_temperature;
+  double theta = 300 / layer.temperature;
   switch (element) {
   case OXYGEN:
-    return d_table1[index][1] * 1e-7 * d_oxygen_pressure
+    return d_table1[index][1] * 1e-7 * layer.oxygen_pressure
            * std::pow(theta, 3)
            * std::exp(d_table1[index][2] * (1 - theta));
     break;
   case WATER_VAPOUR:
-    return d_table2[index][1] * (1e-1) * d_water_pressure
+    return d_table2[index][1] * (1e-1) * layer.water_pressure
            * std::pow(theta, 3.5)
            * std::exp(d_table2[index][2] * (1 - theta));
     break;
@@ -228,9 +226,10 @@ atmospheric_gases_itu_impl::S(size_t index, atmo_element_t element)
 }
 
 double
-atmospheric_gases_itu_impl::F(size_t index, atmo_element_t element)
+atmospheric_gases_itu_impl::F(size_t index, atmo_element_t element,
+                              const layer_t &layer)
 {
-  double theta = 300 / d_temperature;
+  double theta = 300 / layer.temperature;
   double f0;
   double df;
   double delta = 0;
@@ -240,12 +239,12 @@ atmospheric_gases_itu_impl::F(size_t index, atmo_element_t element)
   case OXYGEN:
     f0 = d_table1[index][0];
     df = d_table1[index][3] * (1e-4)
-         * (d_oxygen_pressure
+         * (layer.oxygen_pressure
             * std::pow(theta, 0.8 - d_table1[index][4])
-            + 1.1 * d_water_pressure * theta);
+            + 1.1 * layer.water_pressure * theta);
     //TODO: Equation 6b
     delta = (1e-4) * (d_table1[index][5] + d_table1[index][6] * theta)
-            * (d_oxygen_pressure + d_water_pressure)
+            * (layer.oxygen_pressure + layer.water_pressure)
             * std::pow(theta, 0.8);
     result = (frequency / f0)
              * (((df - delta * (f0 - frequency))
@@ -256,8 +255,8 @@ atmospheric_gases_itu_impl::F(size_t index, atmo_element_t element)
   case WATER_VAPOUR:
     f0 = d_table2[index][0];
     df = d_table2[index][3] * 1e-4
-         * (d_oxygen_pressure * std::pow(theta, d_table1[index][4])
-            + d_table2[index][5] * d_water_pressure
+         * (layer.oxygen_pressure * std::pow(theta, d_table1[index][4])
+            + d_table2[index][5] * layer.water_pressure
             * std::pow(theta, d_table2[index][6]));
     //TODO: Equation 6b
     delta = 0;
@@ -275,31 +274,31 @@ atmospheric_gases_itu_impl::F(size_t index, atmo_element_t element)
 }
 
 double
-atmospheric_gases_itu_impl::ND()
+atmospheric_gases_itu_impl::ND(const layer_t &layer)
 {
-  double theta = 300 / d_temperature;
-  double d = (d_oxygen_pressure + d_water_pressure) * std::pow(theta, 0.8)
+  double theta = 300 / layer.temperature;
+  double d = (layer.oxygen_pressure + layer.water_pressure) * std::pow(theta, 0.8)
              * 5.6e-4;
-  return frequency * d_oxygen_pressure * std::pow(theta, 2)
+  return frequency * layer.oxygen_pressure * std::pow(theta, 2)
          * (6.14e-5 / (d * (1 + std::pow(frequency / d, 2)))
-            + (d_oxygen_pressure * std::pow(theta, 1.5) * 1.4e-12
+            + (layer.oxygen_pressure * std::pow(theta, 1.5) * 1.4e-12
                / (1 + (std::pow(frequency, 1.5) * 1.9e-5))));
 }
 
 double
-atmospheric_gases_itu_impl::N(atmo_element_t element)
+atmospheric_gases_itu_impl::N(atmo_element_t element, const layer_t &layer)
 {
   double sum = 0;
   switch (element) {
   case OXYGEN:
     for (size_t i = 0; i < d_table1.size(); i++) {
-      sum = sum + S(i, element) * F(i, element);
+      sum = sum + S(i, element, layer) * F(i, element, layer);
     }
-    return sum + ND();
+    return sum + ND(layer);
     break;
   case WATER_VAPOUR:
     for (size_t i = 0; i < d_table2.size(); i++) {
-      sum = sum + S(i, element) * F(i, element);
+      sum = sum + S(i, element, layer) * F(i, element, layer);
     }
     return sum;
     break;
@@ -310,9 +309,9 @@ atmospheric_gases_itu_impl::N(atmo_element_t element)
 }
 
 double
-atmospheric_gases_itu_impl::gamma()
+atmospheric_gases_itu_impl::gamma(const layer_t &layer)
 {
-  return 0.1820 * frequency * (N(OXYGEN) + N(WATER_VAPOUR));
+  return 0.1820 * frequency * (N(OXYGEN, layer) + N(WATER_VAPOUR, layer));
 }
 
 double
@@ -343,9 +342,9 @@ atmospheric_gases_itu_impl::a(double an, double rn, double delta)
 
 double
 atmospheric_gases_itu_impl::alpha(size_t n, double rn, double delta,
-                                  double prev_alpha)
+                                  double prev_alpha, const layer_t &layer)
 {
-  double b = beta(n, rn, delta, prev_alpha);
+  double b = beta(n, rn, delta, prev_alpha, layer);
   double alpha_tmp = -rn * cos(b)
                      + 0.5
                      * std::sqrt(
@@ -356,7 +355,7 @@ atmospheric_gases_itu_impl::alpha(size_t n, double rn, double delta,
 
 double
 atmospheric_gases_itu_impl::beta(size_t n, double rn, double delta,
-                                 double prev_alpha)
+                                 double prev_alpha, const layer_t &layer)
 {
   double delta_next = 0.0001 * std::exp(((n + 1) - 1) / 100);
   double aangle;
@@ -368,7 +367,7 @@ atmospheric_gases_itu_impl::beta(size_t n, double rn, double delta,
   else {
     aangle = a(prev_alpha, rn, delta);
     bangle = asin(
-               (nh(d_temperature, d_oxygen_pressure, d_water_pressure)
+               (nh(layer.temperature, layer.oxygen_pressure, layer.water_pressure)
                 / nh(
                   get_temperature(rn + delta_next - EARTH_RADIUS),
                   get_pressure(rn + delta_next - EARTH_RADIUS),
@@ -412,10 +411,12 @@ atmospheric_gases_itu_impl::get_attenuation()
      * Estimate temperature and pressure for the
      * current atmospheric layer.
      */
-    d_temperature = get_temperature(delta_sum);
-    d_oxygen_pressure = get_pressure(delta_sum);
-    d_water_pressure = get_water_vapour_pressure(delta_sum);
-    prev_alpha = alpha(i, rn, delta, prev_alpha);
+    const layer_t layer = {
+      get_temperature(delta_sum),
+      get_pressure(delta_sum),
+      get_water_vapour_pressure(delta_sum)
+    };
+    prev_alpha = alpha(i, rn, delta, prev_alpha, layer);
     /**
      * Ignore some NaN
      * TODO: Investigate this issue
@@ -423,7 +424,7 @@ atmospheric_gases_itu_impl::get_attenuation()
     if (!std::isnan(prev_alpha)) {
       alpha_sum += prev_alpha;
     }
-    attenuation = prev_alpha * gamma();
+    attenuation = prev_alpha * gamma(layer);
     if (!std::isnan(attenuation)) {
       attenuation_sum += attenuation;
     }
@@ -432,6 +433,13 @@ atmospheric_gases_itu_impl::get_attenuation()
   return attenuation_sum;
 }
 
+/* The state of the layers is local to each evaluation */
+bool
+atmospheric_gases_itu_impl::is_reentrant() const
+{
+  return true;
+}
+
 } /* namespace attenuation */
 } /* namespace leo */
 } /* namespace gr */
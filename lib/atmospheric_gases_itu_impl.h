@@ -42,11 +42,19 @@ public:
   double
   get_attenuation();
 
+protected:
+  bool
+  is_reentrant() const override;
+
 private:
 
-  double d_temperature;
-  double d_oxygen_pressure;
-  double d_water_pressure;
+  /* The temperature in K and the pressures in hPa of an atmospheric layer */
+  typedef struct {
+    double temperature;
+    double oxygen_pressure;
+    double water_pressure;
+  } layer_t;
+
   double d_surface_watervap_density;
 
   /*!
@@ -167,19 +175,19 @@ private:
   geopotential_to_geometric(double alt);
 
   double
-  S(size_t index, atmo_element_t element);
+  S(size_t index, atmo_element_t element, const layer_t &layer);
 
   double
-  F(size_t index, atmo_element_t element);
+  F(size_t index, atmo_element_t element, const layer_t &layer);
 
   double
-  ND();
+  ND(const layer_t &layer);
 
   double
-  N(atmo_element_t element);
+  N(atmo_element_t element, const layer_t &layer);
 
   double
-  gamma();
+  gamma(const layer_t &layer);
 
   double
   nh(double temperature, double oxygen_pressure,
@@ -189,10 +197,12 @@ private:
   a(double an, double rn, double delta);
 
   double
-  alpha(size_t n, double rn, double delta, double prev_alpha);
+  alpha(size_t n, double rn, double delta, double prev_alpha,
+        const layer_t &layer);
 
   double
-  beta(size_t n, double rn, double delta, double prev_alpha);
+  beta(size_t n, double rn, double delta, double prev_alpha,
+       const layer_t &layer);
 
 };
 } // namespace attenuation
@@ -23,6 +23,7 @@
 #endif
 
 #include "atmospheric_gases_regression_impl.h"
+#include <algorithm>
 #include <cmath>
 #include <gnuradio/leo/log.h>
 #include <gnuradio/leo/utils/helper.h>
@@ -40,26 +41,51 @@ atmospheric_gases_regression::make(double surface_watervap_density,
                temperature));
 }
 
+/*
+ * Data taken from Ippolito - Radiowave Propagation in Satellite Communications
+ * Table 3-1  Coefficients for the Calculation of specific attenuation due
+ * to gaseous absorption.
+ */
+static const double coeff_freq[] = { 1, 4, 6, 12 };
+static const double coeff_a[] = { 0.00588, 0.00802, 0.00824, 0.00898 };
+static const double coeff_b[] = { 0.0000178, 0.000141, 0.000300, 0.00137 };
+static const double coeff_c[] = { 0.0000517, 0.0000850, 0.0000895, 0.000108 };
+
+/*
+ * Data taken from Ippolito - Radiowave Propagation in Satellite Communications
+ * Table 3-2  Coefficients for the Calculation of Total Zenith Atmospheric
+ * Attenuation.
+ */
+static const double zenith_freq[] = { 1, 4, 6, 12 };
+static const double zenith_a[] = { 0.0334, 0.0397, 0.0404, 0.0436 };
+static const double zenith_b[] = { 0.00000276, 0.000276, 0.000651, 0.00318 };
+static const double zenith_c[] = { 0.000112, 0.000176, 0.000196, 0.000315 };
+
+const atmospheric_gases_regression_impl::atmo_coeff_table_t
+atmospheric_gases_regression_impl::s_atmo_gases_coeff = {
+  coeff_freq, coeff_a, coeff_b, coeff_c,
+  sizeof(coeff_freq) / sizeof(coeff_freq[0])
+};
+
+const atmospheric_gases_regression_impl::atmo_coeff_table_t
+atmospheric_gases_regression_impl::s_atmo_gases_coeff_zenith = {
+  zenith_freq, zenith_a, zenith_b, zenith_c,
+  sizeof(zenith_freq) / sizeof(zenith_freq[0])
+};
+
 atmospheric_gases_regression_impl::atmospheric_gases_regression_impl(
   double watervap, double temperature) :
   generic_attenuation(),
   d_surface_watervap_density(watervap),
-  d_temperature(temperature)
-
+  d_temperature(temperature),
+  d_cached_frequency(-1),
+  d_af(0), d_bf(0), d_cf(0),
+  d_azf(0), d_bzf(0), d_czf(0)
 {
-  atmospheric_gases_regression_impl::atmo_coefficients_t tmp_coeff;
-  tmp_coeff = get_atmo_coeff(frequency, &d_atmo_gases_coeff);
-
-  d_af = std::get<1> (tmp_coeff);
-  d_bf = std::get<2> (tmp_coeff);
-  d_cf = std::get<3> (tmp_coeff);
-
-  tmp_coeff = get_atmo_coeff(frequency, &d_atmo_gases_coeff_zenith);
-
-  d_azf = std::get<1> (tmp_coeff);
-  d_bzf = std::get<2> (tmp_coeff);
-  d_czf = std::get<3> (tmp_coeff);
-
+  /*
+   * The frequency is not known yet at this point. The coefficients are
+   * resolved at the first evaluation and whenever the frequency changes.
+   */
 }
 
 atmospheric_gases_regression_impl::~atmospheric_gases_regression_impl()
@@ -83,55 +109,51 @@ atmospheric_gases_regression_impl::calc_coeff(double y1, double y2,
            10, _m * std::log10(f0) + (std::log10(y2) - _m * std::log10(f2)));
 }
 
-atmospheric_gases_regression_impl::atmo_coefficients_t
+void
 atmospheric_gases_regression_impl::get_atmo_coeff(
-  double frequency, std::vector<atmo_coefficients_t> *coeff_table)
+  double frequency, const atmo_coeff_table_t &table,
+  double *a, double *b, double *c)
 {
-  double a_f, b_f, c_f = 0;
-
-  if (frequency < std::get<0> ((*coeff_table)[0])) {
-    a_f = std::get<1> ((*coeff_table)[0]);
-    b_f = std::get<2> ((*coeff_table)[0]);
-    c_f = std::get<3> ((*coeff_table)[0]);
-  }
-  else if (frequency
-           > std::get<0> ((*coeff_table)[coeff_table->size() - 1])) {
-    a_f = std::get<1> ((*coeff_table)[0]);
-    b_f = std::get<2> ((*coeff_table)[0]);
-    c_f = std::get<3> ((*coeff_table)[0]);
+  /* Outside of the table the coefficients of the first entry are used */
+  if (frequency < table.freq[0] || frequency > table.freq[table.size - 1]) {
+    *a = table.a[0];
+    *b = table.b[0];
+    *c = table.c[0];
+    return;
   }
-  else {
-    for (size_t i = 0; i < coeff_table->size(); i++) {
-      if (std::get<0> ((*coeff_table)[i]) == frequency) {
-        a_f = std::get<1> ((*coeff_table)[i]);
-        b_f = std::get<2> ((*coeff_table)[i]);
-        c_f = std::get<3> ((*coeff_table)[i]);
-        break;
-      }
-      else if (std::get<0> ((*coeff_table)[i]) > frequency) {
-        a_f = calc_coeff(std::get<1> ((*coeff_table)[i - 1]),
-                         std::get<1> ((*coeff_table)[i]),
-                         std::get<0> ((*coeff_table)[i - 1]),
-                         std::get<0> ((*coeff_table)[i]), frequency);
-        b_f = calc_coeff(std::get<2> ((*coeff_table)[i - 1]),
-                         std::get<2> ((*coeff_table)[i]),
-                         std::get<0> ((*coeff_table)[i - 1]),
-                         std::get<0> ((*coeff_table)[i]), frequency);
-        c_f = calc_coeff(std::get<3> ((*coeff_table)[i - 1]),
-                         std::get<3> ((*coeff_table)[i]),
-                         std::get<0> ((*coeff_table)[i - 1]),
-                         std::get<0> ((*coeff_table)[i]), frequency);
-        break;
-      }
-    }
+
+  const size_t i = std::lower_bound(table.freq, table.freq + table.size,
+                                    frequency) - table.freq;
+  if (table.freq[i] == frequency) {
+    *a = table.a[i];
+    *b = table.b[i];
+    *c = table.c[i];
+    return;
   }
+  *a = calc_coeff(table.a[i - 1], table.a[i], table.freq[i - 1],
+                  table.freq[i], frequency);
+  *b = calc_coeff(table.b[i - 1], table.b[i], table.freq[i - 1],
+                  table.freq[i], frequency);
+  *c = calc_coeff(table.c[i - 1], table.c[i], table.freq[i - 1],
+                  table.freq[i], frequency);
+}
 
-  return atmo_coefficients_t (frequency, a_f, b_f, c_f);
+void
+atmospheric_gases_regression_impl::update_frequency()
+{
+  get_atmo_coeff(frequency, s_atmo_gases_coeff, &d_af, &d_bf, &d_cf);
+  get_atmo_coeff(frequency, s_atmo_gases_coeff_zenith, &d_azf, &d_bzf,
+                 &d_czf);
+  d_cached_frequency = frequency;
 }
 
 double
 atmospheric_gases_regression_impl::get_attenuation()
 {
+  if (frequency != d_cached_frequency) {
+    update_frequency();
+  }
+
   double gammaa = d_af + d_bf * d_surface_watervap_density
                   - d_cf * d_temperature;
   double zenitha = d_azf + d_bzf * d_surface_watervap_density
@@ -150,6 +172,12 @@ atmospheric_gases_regression_impl::get_attenuation()
   }
 }
 
+bool
+atmospheric_gases_regression_impl::is_reentrant() const
+{
+  return true;
+}
+
 } /* namespace attenuation */
 } /* namespace leo */
 } /* namespace gr */
@@ -0,0 +1,179 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/leo/attitude.h>
+#include <gnuradio/leo/utils/helper.h>
+#include <gnuradio/random.h>
+#include "utils/quaternion.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+namespace leo {
+
+attitude::attitude_sptr
+attitude::make(attitude_mode_t mode, double rate, double axis_ra,
+               double axis_dec, unsigned int seed)
+{
+  return attitude::attitude_sptr(new attitude(mode, rate, axis_ra, axis_dec,
+                                 seed));
+}
+
+attitude::attitude(attitude_mode_t mode, double rate, double axis_ra,
+                   double axis_dec, unsigned int seed) :
+  d_mode(mode),
+  d_rate(utils::degrees_to_radians(rate)),
+  d_q0{1, 0, 0, 0},
+  d_axis{0, 0, 1},
+  d_theta(0),
+  d_phi(0)
+{
+  switch (mode) {
+  case ATTITUDE_NADIR:
+    break;
+  case ATTITUDE_SPIN: {
+    /* The rotation that takes the inertial +Z to the spin axis */
+    const double ra = utils::degrees_to_radians(axis_ra);
+    const double dec = utils::degrees_to_radians(axis_dec);
+    const utils::quaternion q = utils::quaternion_from_axis_angle(
+                                  -std::sin(ra), std::cos(ra), 0, M_PI / 2 - dec);
+    d_q0[0] = q.w;
+    d_q0[1] = q.x;
+    d_q0[2] = q.y;
+    d_q0[3] = q.z;
+    break;
+  }
+  case ATTITUDE_TUMBLING: {
+    gr::random rng(seed);
+    /* Uniformly distributed orientation (Shoemake) and rotation axis */
+    const double u1 = rng.ran1();
+    const double u2 = 2 * M_PI * rng.ran1();
+    const double u3 = 2 * M_PI * rng.ran1();
+    d_q0[0] = std::sqrt(1 - u1) * std::sin(u2);
+    d_q0[1] = std::sqrt(1 - u1) * std::cos(u2);
+    d_q0[2] = std::sqrt(u1) * std::sin(u3);
+    d_q0[3] = std::sqrt(u1) * std::cos(u3);
+    const double z = 2 * rng.ran1() - 1;
+    const double az = 2 * M_PI * rng.ran1();
+    d_axis[0] = std::sqrt(1 - z * z) * std::cos(az);
+    d_axis[1] = std::sqrt(1 - z * z) * std::sin(az);
+    d_axis[2] = z;
+    break;
+  }
+  default:
+    throw std::invalid_argument("attitude: invalid attitude mode");
+  }
+}
+
+attitude::~attitude()
+{
+}
+
+void
+attitude::update(double time, const eci_state_t &state)
+{
+  /* A single element is the same with the coordinate arrays */
+  off_boresight_batch(1, &time, state.sat_position, state.sat_velocity,
+                      state.gs_position, &d_theta, &d_phi);
+}
+
+void
+attitude::off_boresight_batch(size_t n, const double *time,
+                              const double *sat_position,
+                              const double *sat_velocity,
+                              const double *gs_position, double *theta,
+                              double *phi) const
+{
+  const double *rx = sat_position;
+  const double *ry = sat_position + n;
+  const double *rz = sat_position + 2 * n;
+  const double *vx = sat_velocity;
+  const double *vy = sat_velocity + n;
+  const double *vz = sat_velocity + 2 * n;
+  const double *gx = gs_position;
+  const double *gy = gs_position + n;
+  const double *gz = gs_position + 2 * n;
+
+  if (d_mode == ATTITUDE_NADIR) {
+    for (size_t i = 0; i < n; i++) {
+      /* The line of sight to the ground station */
+      const double lx = gx[i] - rx[i];
+      const double ly = gy[i] - ry[i];
+      const double lz = gz[i] - rz[i];
+      /* +Z to the nadir, +Y against the orbit normal, +X completes them */
+      const double r = std::sqrt(rx[i] * rx[i] + ry[i] * ry[i] + rz[i] * rz[i]);
+      const double zx = -rx[i] / r;
+      const double zy = -ry[i] / r;
+      const double zz = -rz[i] / r;
+      const double hx = ry[i] * vz[i] - rz[i] * vy[i];
+      const double hy = rz[i] * vx[i] - rx[i] * vz[i];
+      const double hz = rx[i] * vy[i] - ry[i] * vx[i];
+      const double h = std::sqrt(hx * hx + hy * hy + hz * hz);
+      const double yx = -hx / h;
+      const double yy = -hy / h;
+      const double yz = -hz / h;
+      const double xx = yy * zz - yz * zy;
+      const double xy = yz * zx - yx * zz;
+      const double xz = yx * zy - yy * zx;
+      const double bx = lx * xx + ly * xy + lz * xz;
+      const double by = lx * yx + ly * yy + lz * yz;
+      const double bz = lx * zx + ly * zy + lz * zz;
+      theta[i] = std::atan2(std::sqrt(bx * bx + by * by), bz);
+      phi[i] = std::atan2(by, bx);
+    }
+    return;
+  }
+
+  const utils::quaternion q0 = {d_q0[0], d_q0[1], d_q0[2], d_q0[3]};
+  for (size_t i = 0; i < n; i++) {
+    const utils::quaternion q = utils::quaternion_multiply(q0,
+                                utils::quaternion_from_axis_angle(
+                                  d_axis[0], d_axis[1], d_axis[2], d_rate * time[i]));
+    double b[3] = {gx[i] - rx[i], gy[i] - ry[i], gz[i] - rz[i]};
+    utils::quaternion_rotate_inverse(q, b);
+    theta[i] = std::atan2(std::sqrt(b[0] * b[0] + b[1] * b[1]), b[2]);
+    phi[i] = std::atan2(b[1], b[0]);
+  }
+}
+
+double
+attitude::get_off_boresight() const
+{
+  return d_theta;
+}
+
+double
+attitude::get_azimuth() const
+{
+  return d_phi;
+}
+
+attitude_mode_t
+attitude::get_mode() const
+{
+  return d_mode;
+}
+
+} /* namespace leo */
+} /* namespace gr */
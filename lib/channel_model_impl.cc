@@ -24,7 +24,17 @@
 
 #include "channel_model_impl.h"
 #include <gnuradio/io_signature.h>
+#include <libsgp4/TimeSpan.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #include <string>
 
 namespace gr {
@@ -33,10 +43,16 @@ namespace leo {
 channel_model::sptr channel_model::make(const double sample_rate,
                                         generic_model::generic_model_sptr model,
                                         const noise_t noise_type,
-                                        const bool store_csv, const char *filename)
+                                        const bool store_csv, const char *filename,
+                                        const los_mode_t los_mode,
+                                        const double time_scale,
+                                        const time_source_t time_source,
+                                        const size_t precompute_windows)
 {
   return gnuradio::get_initial_sptr(
-           new channel_model_impl(sample_rate, model, noise_type, store_csv, filename));
+           new channel_model_impl(sample_rate, model, noise_type, store_csv, filename,
+                                  los_mode, time_scale, time_source,
+                                  precompute_windows));
 }
 
 /*
@@ -45,17 +61,36 @@ channel_model::sptr channel_model::make(const double sample_rate,
 channel_model_impl::channel_model_impl(const double sample_rate,
                                        generic_model::generic_model_sptr model,
                                        const noise_t noise_type,
-                                       const bool store_csv, const char *filename)
-  : gr::sync_block("channel_model",
-                   gr::io_signature::make(1, 1, sizeof(gr_complex)),
-                   gr::io_signature::make(1, 1, sizeof(gr_complex))),
+                                       const bool store_csv, const char *filename,
+                                       const los_mode_t los_mode,
+                                       const double time_scale,
+                                       const time_source_t time_source,
+                                       const size_t precompute_windows)
+  : gr::block("channel_model",
+              gr::io_signature::make(1, 1, sizeof(gr_complex)),
+              gr::io_signature::make(1, 1, sizeof(gr_complex))),
     d_sample_rate(sample_rate),
     d_time_win_samples(0),
     d_win_produced(0),
     d_model(model),
-    d_noise_type(noise_type)
-
-
+    d_noise_type(noise_type),
+    d_los_mode(los_mode),
+    d_time_scale(time_scale),
+    d_los_window(false),
+    d_time_source(time_source),
+    d_running(false),
+    d_applied_ticks(0),
+    d_observation_over(false),
+    d_requested_ticks(0),
+    d_rx_time_ticks(0),
+    d_rx_time_offset(0),
+    d_rx_time_valid(false),
+    d_precompute_windows(precompute_windows),
+    d_windows(precompute_windows),
+    d_window_pending(precompute_windows > 0),
+    d_window_ticks(0),
+    d_window_applied(false),
+    d_profiler({"model_work", "model_update", "noise", "tags_messages"})
 {
   /* A power of 2, should speed up the scheduler */
   set_output_multiple(2048);
@@ -65,8 +100,23 @@ channel_model_impl::channel_model_impl(const double sample_rate,
     throw std::invalid_argument(msg);
   }
 
+  if (d_time_scale <= 0.0) {
+    std::string msg = name() + ": Invalid time scale";
+    throw std::invalid_argument(msg);
+  }
+  model->set_time_scale(d_time_scale);
+
+  /*
+   * The model is always evaluated on the orbital time grid of the tracker.
+   * The time scale only changes how many samples span each time step.
+   */
   d_time_win_samples =
-    (d_sample_rate * model->get_tracker()->get_time_resolution_us()) / 1e6;
+    (d_sample_rate * model->get_tracker()->get_time_resolution_us())
+    / (1e6 * d_time_scale);
+  if (d_time_win_samples == 0) {
+    std::string msg = name() + ": Time scale too large for the time resolution of the tracker";
+    throw std::invalid_argument(msg);
+  }
 
   /* We use Volk underneath for complex multiplication */
   set_alignment(8);
@@ -84,6 +134,32 @@ channel_model_impl::channel_model_impl(const double sample_rate,
     throw std::invalid_argument(msg);
   }
 
+  switch (d_los_mode) {
+  case LOS_SIMULATE:
+  case LOS_ZEROS:
+  case LOS_SKIP:
+    break;
+  default:
+    std::string msg = name() + ": Invalid LOS mode";
+    throw std::invalid_argument(msg);
+  }
+
+  switch (d_time_source) {
+  case TIME_SIMULATED:
+  case TIME_WALL_CLOCK:
+  case TIME_RX_TAGS:
+    break;
+  default:
+    std::string msg = name() + ": Invalid time source";
+    throw std::invalid_argument(msg);
+  }
+
+  if (d_precompute_windows > 0 && d_time_source != TIME_SIMULATED) {
+    std::string msg = name() +
+                      ": Precomputing time windows requires a simulated time source";
+    throw std::invalid_argument(msg);
+  }
+
   d_tag.offset = 0;
   d_tag.key = pmt::intern("frequency");
   d_tag.srcid = alias_pmt();
@@ -98,23 +174,400 @@ channel_model_impl::channel_model_impl(const double sample_rate,
 /*
  * Our virtual destructor.
  */
-channel_model_impl::~channel_model_impl() {}
+channel_model_impl::~channel_model_impl()
+{
+  stop();
+}
+
+std::vector<double>
+channel_model_impl::work_latency_percentiles(const std::vector<double>
+    &percentiles)
+{
+  return d_work_latency.percentiles(percentiles);
+}
+
+uint64_t channel_model_impl::work_latency_count()
+{
+  return d_work_latency.count();
+}
+
+void channel_model_impl::reset_work_latency()
+{
+  d_work_latency.reset();
+}
+
+std::map<std::string, stage_stats_t> channel_model_impl::get_stats()
+{
+  std::map<std::string, stage_stats_t> stats = d_model->get_stats();
+  const std::map<std::string, stage_stats_t> own = d_profiler.get_stats();
+  stats.insert(own.begin(), own.end());
+  return stats;
+}
 
-int channel_model_impl::work(int noutput_items,
-                             gr_vector_const_void_star &input_items,
-                             gr_vector_void_star &output_items)
+void channel_model_impl::reset_stats()
+{
+  d_profiler.reset();
+  d_model->reset_stats();
+}
+
+bool channel_model_impl::start()
+{
+  if (d_time_source != TIME_SIMULATED && !d_running) {
+    d_running = true;
+    d_update_thread = std::thread(&channel_model_impl::update_thread, this);
+  }
+  else if (d_precompute_windows > 0 && !d_running) {
+    /*
+     * The update thread of a previous run may have computed windows that
+     * the work never applied. Drop them and rewind the tracker to the
+     * time the work has actually reached.
+     */
+    tracker::tracker_sptr t = d_model->get_tracker();
+    d_windows.clear();
+    if (d_window_ticks == 0) {
+      d_window_ticks = t->get_elapsed_time().Ticks();
+    }
+    else {
+      t->set_elapsed_time(libsgp4::DateTime(d_window_ticks));
+    }
+    d_running = true;
+    d_update_thread = std::thread(&channel_model_impl::precompute_thread,
+                                  this, d_window_applied);
+  }
+  return block::start();
+}
+
+bool channel_model_impl::stop()
+{
+  d_running = false;
+  if (d_update_thread.joinable()) {
+    d_update_thread.join();
+  }
+  d_windows.clear();
+  return block::stop();
+}
+
+/*
+ * Updates the model at every time step of the tracker, following the
+ * selected clock. This is the only thread that touches the tracker and
+ * performs orbit and attenuation calculations in the real-time modes.
+ */
+void channel_model_impl::update_thread()
+{
+#ifdef __linux__
+  /* Best effort, the signal processing threads should be preferred */
+  setpriority(PRIO_PROCESS, syscall(SYS_gettid), 10);
+#endif
+  tracker::tracker_sptr t = d_model->get_tracker();
+  const int64_t res_us = std::max<int64_t>(1,
+                         static_cast<int64_t>(t->get_time_resolution_us()));
+  const int64_t res_ticks = res_us * libsgp4::TicksPerMicrosecond;
+  int64_t last_ticks = 0;
+
+  while (true) {
+    /*
+     * Read before the update, so the time requested last before stop() is
+     * applied by a final pass
+     */
+    const bool running = d_running;
+    int64_t ticks;
+    if (d_time_source == TIME_WALL_CLOCK) {
+      ticks = libsgp4::DateTime::Now(true).Ticks();
+    }
+    else {
+      ticks = d_requested_ticks.load(std::memory_order_acquire);
+    }
+
+    if (ticks != 0 && std::abs(ticks - last_ticks) >= res_ticks) {
+      t->set_elapsed_time(libsgp4::DateTime(ticks));
+      d_model->update_state();
+      d_published_state.store(d_model->get_state());
+      d_observation_over = t->is_observation_over();
+      last_ticks = ticks;
+    }
+    if (!running) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(
+                                  std::min<int64_t>(res_us, 100000)));
+  }
+}
+
+/*
+ * Computes the model states of the upcoming time windows, following the
+ * same steps with the work of the simulated mode. It is the only thread
+ * that touches the tracker while the flowgraph runs.
+ * If resume is set, the current time of the tracker is that of a window
+ * already applied and the first window is the one after it.
+ */
+void channel_model_impl::precompute_thread(bool resume)
+{
+#ifdef __linux__
+  setpriority(PRIO_PROCESS, syscall(SYS_gettid), 10);
+#endif
+  tracker::tracker_sptr t = d_model->get_tracker();
+  const double res = t->get_time_resolution_us();
+  bool first = !resume;
+  precomputed_window_t w;
+
+  while (d_running) {
+    /* The first window starts at the current time of the tracker */
+    if (!first) {
+      t->advance_time(res);
+    }
+    first = false;
+
+    w.skipped_us = 0.0;
+    if (d_los_mode == LOS_SKIP) {
+      w.skipped_us = std::floor(t->get_time_to_next_aos_us() / res) * res;
+      if (w.skipped_us > 0.0) {
+        t->advance_time(w.skipped_us);
+      }
+    }
+    w.elapsed_ticks = t->get_elapsed_time().Ticks();
+    w.los_window = is_los_window();
+    d_model->update_state();
+    w.state = d_model->get_state();
+    w.observation_over = t->is_observation_over();
+
+    while (d_running && !d_windows.push(w)) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    if (w.observation_over) {
+      break;
+    }
+  }
+}
+
+/*
+ * Applies the next precomputed window. If the update thread lags behind,
+ * this is the only point where the signal processing waits, backing off
+ * up to 1 ms between retries.
+ * Returns false if the observation is over or the update thread has been
+ * stopped. In the latter case the window stays pending.
+ */
+bool channel_model_impl::pop_window(uint64_t offset)
+{
+  precomputed_window_t w;
+  int64_t backoff_us = 1;
+  while (!d_windows.pop(w)) {
+    if (!d_running) {
+      d_window_pending = true;
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
+    backoff_us = std::min<int64_t>(backoff_us * 2, 1000);
+  }
+  d_window_ticks = w.elapsed_ticks;
+  d_window_applied = true;
+  if (w.observation_over) {
+    d_observation_over = true;
+    return false;
+  }
+  if (w.skipped_us > 0.0) {
+    tag_skipped(offset, w.skipped_us);
+  }
+  d_model->set_state(w.state);
+  d_los_window = w.los_window;
+  return true;
+}
+
+void channel_model_impl::tag_skipped(uint64_t offset, double skip_us)
+{
+  tag_t tag;
+  tag.offset = offset;
+  tag.key = pmt::intern("los_skip_us");
+  tag.value = pmt::from_double(skip_us);
+  tag.srcid = alias_pmt();
+  add_item_tag(0, tag);
+}
+
+/*
+ * Attaches the state of the model as tags, stores it into the CSV log and
+ * publishes it alongside with the signal it was applied on
+ */
+void channel_model_impl::publish_state(uint64_t offset, const gr_complex *out,
+                                       size_t nitems)
+{
+  LEO_PROFILE(d_profiler, STAGE_TAGS);
+  d_tag.offset = offset;
+
+  d_tags_vec = d_model->get_tags_vector();
+  std::vector<std::pair<pmt::pmt_t, pmt::pmt_t>>::iterator it;
+
+  pmt::pmt_t dict = pmt::make_dict();
+  for (it = d_tags_vec.begin(); it != d_tags_vec.end(); it++) {
+    d_tag.key = (*it).first;
+    d_tag.value = (*it).second;
+    add_item_tag(0, d_tag);
+
+    dict = pmt::dict_add(dict, (*it).first, (*it).second);
+  }
+
+  const std::string &str = d_model->get_csv_log();
+  d_fout << str.c_str() << "\n";
+  pmt::pmt_t t = pmt::init_c32vector(nitems, out);
+  message_port_pub(pmt::mp("pdus"),
+                   pmt::cons(dict,
+                             t));
+}
+
+/*
+ * The work of the real-time modes. The state of the model is only applied,
+ * never computed here.
+ */
+int channel_model_impl::realtime_work(int noutput_items, int ninput_items,
+                                      const gr_complex *in, gr_complex *out)
+{
+  if (d_observation_over) {
+    return WORK_DONE;
+  }
+
+  if (d_time_source == TIME_RX_TAGS) {
+    std::vector<tag_t> tags;
+    get_tags_in_range(tags, 0, nitems_read(0), nitems_read(0) + ninput_items,
+                      pmt::intern("rx_time"));
+    if (!tags.empty()) {
+      const pmt::pmt_t &val = tags.back().value;
+      const uint64_t secs = pmt::to_uint64(pmt::tuple_ref(val, 0));
+      const double frac = pmt::to_double(pmt::tuple_ref(val, 1));
+      d_rx_time_ticks = libsgp4::UnixEpoch
+                        + static_cast<int64_t>(secs) * libsgp4::TicksPerSecond
+                        + static_cast<int64_t>(frac * libsgp4::TicksPerSecond);
+      d_rx_time_offset = tags.back().offset;
+      d_rx_time_valid = true;
+    }
+    if (d_rx_time_valid) {
+      const double elapsed_s = (static_cast<double>(nitems_read(0))
+                                - static_cast<double>(d_rx_time_offset)) / d_sample_rate;
+      const int64_t elapsed_ticks = static_cast<int64_t>(elapsed_s
+                                    * libsgp4::TicksPerSecond);
+      d_requested_ticks.store(d_rx_time_ticks + elapsed_ticks,
+                              std::memory_order_release);
+    }
+  }
+
+  model_state_t state;
+  bool updated = false;
+  if (d_published_state.try_load(state)
+      && state.elapsed_ticks != d_applied_ticks) {
+    d_applied_ticks = state.elapsed_ticks;
+    d_model->set_state(state);
+    updated = true;
+  }
+
+  int consumed = 0;
+  int produced;
+  {
+    LEO_PROFILE(d_profiler, STAGE_MODEL_WORK);
+    produced = d_model->generic_general_work(in, ninput_items, consumed,
+               out, noutput_items, d_sample_rate);
+  }
+  consume_each(consumed);
+  if (d_noise_type != NOISE_NONE) {
+    LEO_PROFILE(d_profiler, STAGE_NOISE);
+    d_noise->add_noise(out, out, produced, d_model->get_noise_floor());
+  }
+
+  if (updated && d_model->aos()) {
+    publish_state(nitems_written(0), out, produced);
+  }
+  return produced;
+}
+
+/*
+ * Checks if the time window that starts now lies entirely outside
+ * a satellite pass
+ */
+bool channel_model_impl::is_los_window()
+{
+  if (d_los_mode == LOS_SIMULATE) {
+    return false;
+  }
+  tracker::tracker_sptr t = d_model->get_tracker();
+  return t->get_time_to_next_aos_us() >= t->get_time_resolution_us();
+}
+
+/*
+ * Advances the observation by the whole number of time windows that
+ * precede the next AOS, so the time grid of the model is preserved.
+ * Returns true if any time was skipped.
+ */
+bool channel_model_impl::skip_to_next_aos()
+{
+  tracker::tracker_sptr t = d_model->get_tracker();
+  const double res = t->get_time_resolution_us();
+  const double skip_us = std::floor(t->get_time_to_next_aos_us() / res) * res;
+  if (skip_us <= 0.0) {
+    return false;
+  }
+
+  d_model->advance_time(skip_us);
+  tag_skipped(nitems_written(0), skip_us);
+  return true;
+}
+
+void channel_model_impl::forecast(int noutput_items,
+                                  gr_vector_int &ninput_items_required)
+{
+  ninput_items_required[0] = d_model->forecast(noutput_items);
+}
+
+int channel_model_impl::general_work(int noutput_items,
+                                     gr_vector_int &ninput_items,
+                                     gr_vector_const_void_star &input_items,
+                                     gr_vector_void_star &output_items)
 {
   const gr_complex *in = (const gr_complex *)input_items[0];
   gr_complex *out = (gr_complex *)output_items[0];
+#if LEO_PROFILING
+  utils::latency_histogram::scoped_timer timer(d_work_latency);
+#endif
 
-  if (d_model->get_tracker()->is_observation_over()) {
+  if (d_time_source != TIME_SIMULATED) {
+    return realtime_work(noutput_items, ninput_items[0], in, out);
+  }
+
+  if (d_precompute_windows > 0) {
+    if (d_observation_over) {
+      return WORK_DONE;
+    }
+    if (d_window_pending) {
+      d_window_pending = false;
+      if (!pop_window(nitems_written(0))) {
+        return d_observation_over ? WORK_DONE : 0;
+      }
+    }
+  }
+  else if (d_model->get_tracker()->is_observation_over()) {
     return WORK_DONE;
   }
 
+  if (d_win_produced == 0 && d_precompute_windows == 0) {
+    if (d_los_mode == LOS_SKIP && skip_to_next_aos()
+        && d_model->get_tracker()->is_observation_over()) {
+      return WORK_DONE;
+    }
+    d_los_window = is_los_window();
+  }
+
+  int consumed = 0;
   size_t avail = std::min<size_t>(noutput_items,
                                   d_time_win_samples - d_win_produced);
-  d_model->generic_work(in, out, avail, d_sample_rate);
+  if (d_los_window) {
+    /* Nothing to simulate, the satellite is not visible */
+    avail = std::min<size_t>(avail, ninput_items[0]);
+    std::fill_n(out, avail, gr_complex(0, 0));
+    consumed = avail;
+  }
+  else {
+    LEO_PROFILE(d_profiler, STAGE_MODEL_WORK);
+    avail = d_model->generic_general_work(in, ninput_items[0], consumed, out,
+                                          avail, d_sample_rate);
+  }
+  consume_each(consumed);
   if (d_noise_type != NOISE_NONE) {
+    LEO_PROFILE(d_profiler, STAGE_NOISE);
     d_noise->add_noise(out, out, avail, d_model->get_noise_floor());
   }
 
@@ -122,33 +575,30 @@ int channel_model_impl::work(int noutput_items,
 
   uint64_t nitems = static_cast<uint64_t>(avail) + nitems_written(0);
 
-  if (d_win_produced == d_time_win_samples) {
+  if (d_win_produced == d_time_win_samples && d_los_window
+      && d_precompute_windows == 0) {
     d_win_produced = 0;
-    d_model->advance_time(d_model->get_tracker()->get_time_resolution_us());
+    tracker::tracker_sptr t = d_model->get_tracker();
+    t->advance_time(t->get_time_resolution_us());
+    /* Refresh the model state before leaving the LOS period */
+    if (!is_los_window()) {
+      d_model->advance_time(0);
+    }
+  }
+  else if (d_win_produced == d_time_win_samples) {
+    d_win_produced = 0;
+    if (d_precompute_windows > 0) {
+      if (!pop_window(nitems)) {
+        return avail;
+      }
+    }
+    else {
+      LEO_PROFILE(d_profiler, STAGE_MODEL_UPDATE);
+      d_model->advance_time(d_model->get_tracker()->get_time_resolution_us());
+    }
     /* Produce messages only in case we have AOS */
     if (d_model->aos()) {
-      d_tag.offset = nitems + d_time_win_samples;
-
-      d_tags_vec = d_model->get_tags_vector();
-      std::vector<std::pair<pmt::pmt_t, pmt::pmt_t>>::iterator it;
-
-      pmt::pmt_t dict = pmt::make_dict();
-      for (it = d_tags_vec.begin(); it != d_tags_vec.end(); it++) {
-        d_tag.key = (*it).first;
-        d_tag.value = (*it).second;
-        add_item_tag(0, d_tag);
-
-        dict = pmt::dict_add(dict, (*it).first, (*it).second);
-      }
-
-      const std::string &str = d_model->get_csv_log();
-      d_fout << str.c_str() << "\n";
-      pmt::pmt_t t = pmt::init_c32vector(d_time_win_samples, out);
-//      gr_complex* tmp = c32vector_writable_elements(t, d_time_win_samples);
-//      memcpy(tmp, out, d_time_win_samples*sizeof(gr_complex));
-      message_port_pub(pmt::mp("pdus"),
-                       pmt::cons(dict,
-                                 t));
+      publish_state(nitems + d_time_win_samples, out, d_time_win_samples);
     }
   }
 
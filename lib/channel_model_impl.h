@@ -24,7 +24,13 @@
 #include <gnuradio/leo/channel_model.h>
 #include <gnuradio/leo/generic_noise.h>
 #include <gnuradio/leo/white_gaussian_noise.h>
+#include "utils/latency_histogram.h"
+#include "utils/seqlock.h"
+#include "utils/stage_profiler.h"
+#include "utils/spsc_queue.h"
+#include <atomic>
 #include <fstream>
+#include <thread>
 
 
 namespace gr {
@@ -55,23 +61,146 @@ private:
 
   noise_t d_noise_type;
 
+  const los_mode_t d_los_mode;
+
+  /*!
+   * \brief Orbital time represented by one second of samples
+   */
+  const double d_time_scale;
+
+  /*!
+   * \brief True if the whole current time window lies outside a pass and
+   * it is handled without invoking the model
+   */
+  bool d_los_window;
+
+  const time_source_t d_time_source;
+
+  /*!
+   * \brief Thread that updates the model in the real-time modes
+   */
+  std::thread d_update_thread;
+  std::atomic<bool> d_running;
+
+  /*!
+   * \brief The latest model state, published by the update thread
+   */
+  utils::seqlock<model_state_t> d_published_state;
+  int64_t d_applied_ticks;
+  std::atomic<bool> d_observation_over;
+
+  /*!
+   * \brief The time of the signal derived from the rx_time tags, in
+   * libSGP4 ticks. Zero until the first tag arrives.
+   */
+  std::atomic<int64_t> d_requested_ticks;
+  int64_t d_rx_time_ticks;
+  uint64_t d_rx_time_offset;
+  bool d_rx_time_valid;
+
+  /*!
+   * \brief A time window computed ahead by the update thread
+   */
+  typedef struct {
+    model_state_t state;
+    int64_t elapsed_ticks;
+    double skipped_us;
+    bool los_window;
+    bool observation_over;
+  } precomputed_window_t;
+
+  const size_t d_precompute_windows;
+  utils::spsc_queue<precomputed_window_t> d_windows;
+  bool d_window_pending;
+
+  /*!
+   * \brief The tracker time of the latest window applied by the work, in
+   * libSGP4 ticks. A restarted update thread resumes right after it.
+   */
+  int64_t d_window_ticks;
+  bool d_window_applied;
+
   generic_noise::generic_noise_sptr d_noise;
 
+  utils::latency_histogram d_work_latency;
+
+  enum stage_t {
+    STAGE_MODEL_WORK = 0,
+    STAGE_MODEL_UPDATE,
+    STAGE_NOISE,
+    STAGE_TAGS
+  };
+
+  utils::stage_profiler d_profiler;
+
   tag_t d_tag;
   uint64_t d_offset;
   std::vector<std::pair<pmt::pmt_t, pmt::pmt_t>> d_tags_vec;
   std::fstream d_fout;
 
+  bool
+  is_los_window();
+
+  bool
+  skip_to_next_aos();
+
+  void
+  publish_state(uint64_t offset, const gr_complex *out, size_t nitems);
+
+  void
+  update_thread();
+
+  void
+  precompute_thread(bool resume);
+
+  bool
+  pop_window(uint64_t offset);
+
+  void
+  tag_skipped(uint64_t offset, double skip_us);
+
+  int
+  realtime_work(int noutput_items, int ninput_items, const gr_complex *in,
+                gr_complex *out);
+
 public:
   channel_model_impl(const double sample_rate,
                      generic_model::generic_model_sptr model,
-                     const noise_t noise_type, const bool store_csv, const char *filename);
+                     const noise_t noise_type, const bool store_csv, const char *filename,
+                     const los_mode_t los_mode, const double time_scale,
+                     const time_source_t time_source,
+                     const size_t precompute_windows);
 
   ~channel_model_impl();
 
+  std::vector<double>
+  work_latency_percentiles(const std::vector<double> &percentiles) override;
+
+  uint64_t
+  work_latency_count() override;
+
+  void
+  reset_work_latency() override;
+
+  std::map<std::string, stage_stats_t>
+  get_stats() override;
+
+  void
+  reset_stats() override;
+
+  bool
+  start() override;
+
+  bool
+  stop() override;
+
+  void
+  forecast(int noutput_items, gr_vector_int &ninput_items_required) override;
+
   int
-  work(int noutput_items, gr_vector_const_void_star &input_items,
-       gr_vector_void_star &output_items) override;
+  general_work(int noutput_items, gr_vector_int &ninput_items,
+               gr_vector_const_void_star &input_items,
+               gr_vector_void_star &output_items) override;
 };
 
 } // namespace leo
@@ -69,6 +69,12 @@ custom_antenna_impl::get_gain_rolloff()
   return d_rolloff_gain;
 }
 
+double
+custom_antenna_impl::get_gain_rolloff(double theta, double phi)
+{
+  return d_rolloff_gain;
+}
+
 double
 custom_antenna_impl::get_beamwidth()
 {
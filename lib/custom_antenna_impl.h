@@ -72,6 +72,14 @@ public:
   double
   get_gain_rolloff();
 
+  /*!
+   * \brief Get the gain roll-off of the antenna towards a direction. The
+   * roll-off of a custom antenna is the same in every direction.
+   * \return the gain roll-off in dB.
+   */
+  double
+  get_gain_rolloff(double theta, double phi);
+
   /*!
    * \brief Get the beamwidth of the custom antenna. This is the implementation
    * of the parent's pure virtual function for the custom antenna.
@@ -47,6 +47,7 @@ dipole_antenna_impl::dipole_antenna_impl(antenna_t type,
     double pointing_error) :
   generic_antenna(DIPOLE, frequency, polarization, pointing_error)
 {
+  update_gain_rolloff();
   LEO_DEBUG("DIPOLE");
   LEO_DEBUG("Maximum Gain: %f", get_gain());
   LEO_DEBUG("Beamwidth: %f", get_beamwidth());
@@ -65,7 +66,13 @@ dipole_antenna_impl::get_gain()
 double
 dipole_antenna_impl::get_gain_rolloff()
 {
-  double error_deg = utils::radians_to_degrees(d_pointing_error);
+  return d_gain_rolloff;
+}
+
+double
+dipole_antenna_impl::get_gain_rolloff(double theta, double phi)
+{
+  double error_deg = utils::radians_to_degrees(theta);
   if (error_deg < 90) {
     if (!error_deg) {
       return 0;
@@ -67,6 +67,9 @@ public:
   double
   get_gain_rolloff();
 
+  double
+  get_gain_rolloff(double theta, double phi);
+
   /*!
    * \brief Get the beamwidth of the dipole antenna. This is the implementation
    * of the parent's pure virtual function for the dipole antenna.
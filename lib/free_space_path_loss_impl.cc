@@ -55,6 +55,12 @@ free_space_path_loss_impl::get_attenuation()
   return 92.45 + 20 * std::log10(slant_range * frequency);
 }
 
+bool
+free_space_path_loss_impl::is_reentrant() const
+{
+  return true;
+}
+
 } /* namespace attenuation */
 } /* namespace leo */
 } /* namespace gr */
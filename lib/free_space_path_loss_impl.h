@@ -40,6 +40,10 @@ public:
   double
   get_attenuation();
 
+protected:
+  bool
+  is_reentrant() const override;
+
 };
 } // namespace attenuation
 } // namespace leo
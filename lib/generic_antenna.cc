@@ -34,7 +34,8 @@ generic_antenna::generic_antenna(antenna_t type, double frequency,
   d_type(type),
   d_frequency(frequency),
   d_polarization(polarization),
-  d_pointing_error(utils::degrees_to_radians(pointing_error))
+  d_pointing_error(utils::degrees_to_radians(pointing_error)),
+  d_gain_rolloff(0)
 {
   my_id = base_unique_id++;
 }
@@ -59,6 +60,21 @@ void
 generic_antenna::set_pointing_error(double error)
 {
   d_pointing_error = utils::degrees_to_radians(error);
+  update_gain_rolloff();
+}
+
+void
+generic_antenna::update_gain_rolloff()
+{
+  d_gain_rolloff = get_gain_rolloff(d_pointing_error, 0);
+}
+
+double
+generic_antenna::get_gain_rolloff(double theta, double phi)
+{
+  /* Gaussian approximation of the main lobe */
+  const double x = utils::radians_to_degrees(theta) / get_beamwidth();
+  return 12 * x * x;
 }
 
 double
@@ -74,7 +90,7 @@ generic_antenna::get_polarization()
   return d_polarization;
 }
 
-int generic_antenna::base_unique_id = 1;
+std::atomic<int> generic_antenna::base_unique_id(1);
 
 int
 generic_antenna::unique_id()
@@ -24,14 +24,22 @@
 
 #include <gnuradio/io_signature.h>
 #include <gnuradio/leo/generic_attenuation.h>
+#include <algorithm>
+#include <exception>
+#include <numeric>
+#include <thread>
 
 namespace gr {
 namespace leo {
 
-double generic_attenuation::frequency = 0;
-double generic_attenuation::elevation_angle = 0;
-double generic_attenuation::slant_range = 0;
-polarization_t generic_attenuation::polarization = RHCP;
+thread_local double generic_attenuation::frequency = 0;
+thread_local double generic_attenuation::elevation_angle = 0;
+thread_local double generic_attenuation::slant_range = 0;
+thread_local polarization_t generic_attenuation::polarization = RHCP;
+thread_local double generic_attenuation::time = 0;
+
+/* Below this number of points per thread, spawning threads does not pay off */
+static const size_t MIN_POINTS_PER_THREAD = 4096;
 
 generic_attenuation::generic_attenuation_sptr
 generic_attenuation::make()
@@ -47,6 +55,154 @@ generic_attenuation::~generic_attenuation()
 {
 }
 
+void
+generic_attenuation::get_attenuation_batch(double *out,
+    const double *elevation, size_t n)
+{
+  const double elev = elevation_angle;
+  for (size_t i = 0; i < n; i++) {
+    elevation_angle = elevation[i];
+    out[i] = get_attenuation();
+  }
+  elevation_angle = elev;
+}
+
+std::vector<double>
+generic_attenuation::get_attenuation_batch(const std::vector<double>
+    &elevation)
+{
+  std::vector<double> out(elevation.size());
+  get_attenuation_batch(out.data(), elevation.data(), elevation.size());
+  return out;
+}
+
+void
+generic_attenuation::get_attenuation_batch(double *out,
+    const double *freq, const double *elevation, const double *range,
+    size_t n, size_t nthreads)
+{
+  /* The static variables of the calling thread are restored on return */
+  struct saved_geometry {
+    const double f;
+    const double elev;
+    const double range;
+    saved_geometry() :
+      f(frequency), elev(elevation_angle), range(slant_range)
+    {
+    }
+    ~saved_geometry()
+    {
+      frequency = f;
+      elevation_angle = elev;
+      slant_range = range;
+    }
+  } saved;
+
+  /* Models with a state are evaluated in the order of the points */
+  if (!is_reentrant()) {
+    for (size_t i = 0; i < n; i++) {
+      frequency = freq[i] / 1e9;
+      elevation_angle = elevation[i];
+      slant_range = range[i];
+      out[i] = get_attenuation();
+    }
+    return;
+  }
+
+  if (nthreads == 0) {
+    nthreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::vector<size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [freq](size_t a, size_t b) {
+    return freq[a] < freq[b];
+  });
+
+  const polarization_t polar = polarization;
+  const double t = time;
+  auto evaluate = [&](size_t begin, size_t end) {
+    frequency = freq[order[begin]] / 1e9;
+    polarization = polar;
+    time = t;
+    for (size_t k = begin; k < end; k++) {
+      const size_t i = order[k];
+      elevation_angle = elevation[i];
+      slant_range = range[i];
+      out[i] = get_attenuation();
+    }
+  };
+
+  size_t begin = 0;
+  while (begin < n) {
+    size_t end = begin + 1;
+    while (end < n && freq[order[end]] == freq[order[begin]]) {
+      end++;
+    }
+    /* The first point computes the frequency dependent terms */
+    evaluate(begin, begin + 1);
+    begin++;
+
+    const size_t workers = std::min(nthreads,
+                                    (end - begin) / MIN_POINTS_PER_THREAD);
+    if (workers <= 1) {
+      evaluate(begin, end);
+      begin = end;
+      continue;
+    }
+    const size_t chunk = (end - begin + workers - 1) / workers;
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(workers);
+    for (size_t w = 1; w < workers; w++) {
+      const size_t b = begin + w * chunk;
+      const size_t e = std::min(end, b + chunk);
+      threads.emplace_back([&, w, b, e]() {
+        try {
+          evaluate(b, e);
+        }
+        catch (...) {
+          errors[w] = std::current_exception();
+        }
+      });
+    }
+    try {
+      evaluate(begin, begin + chunk);
+    }
+    catch (...) {
+      errors[0] = std::current_exception();
+    }
+    for (std::thread &th : threads) {
+      th.join();
+    }
+    for (const std::exception_ptr &e : errors) {
+      if (e) {
+        std::rethrow_exception(e);
+      }
+    }
+    begin = end;
+  }
+}
+
+std::vector<double>
+generic_attenuation::get_attenuation_batch(const std::vector<double>
+    &freq, const std::vector<double> &elevation,
+    const std::vector<double> &range, size_t nthreads)
+{
+  if (elevation.size() != freq.size() || range.size() != freq.size()) {
+    throw std::invalid_argument(
+      "generic_attenuation: the frequencies, elevations and slant ranges differ in size");
+  }
+  std::vector<double> out(freq.size());
+  get_attenuation_batch(out.data(), freq.data(), elevation.data(),
+                        range.data(), freq.size(), nthreads);
+  return out;
+}
+
+bool
+generic_attenuation::is_reentrant() const
+{
+  return false;
+}
+
 void
 generic_attenuation::set_frequency(double freq)
 {
@@ -71,6 +227,12 @@ generic_attenuation::set_elevation_angle(double elev_angle)
   elevation_angle = elev_angle;
 }
 
+void
+generic_attenuation::set_time(double t)
+{
+  time = t;
+}
+
 } /* namespace leo */
 } /* namespace gr */
 
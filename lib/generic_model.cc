@@ -23,7 +23,10 @@
 #endif
 
 #include <gnuradio/leo/generic_model.h>
+#include <libsgp4/TimeSpan.h>
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 namespace gr {
 namespace leo {
@@ -36,7 +39,10 @@ generic_model::generic_model(std::string name,
   d_noise_floor(-174.0),
   d_tracker(tracker),
   d_link_margin(nullptr),
-  d_link_margin_db(0.0)
+  d_link_margin_db(0.0),
+  d_time_scale(1.0),
+  d_state(),
+  d_computed_state()
 {
   my_id = base_unique_id++;
 }
@@ -55,6 +61,64 @@ void
 generic_model::advance_time(double us)
 {
   d_tracker->advance_time(us);
+  update_state();
+  set_state(d_computed_state);
+}
+
+model_state_t
+generic_model::get_state() const
+{
+  return d_computed_state;
+}
+
+void
+generic_model::set_state(const model_state_t &state)
+{
+  d_state = state;
+}
+
+void
+generic_model::set_time_scale(double time_scale)
+{
+  if (time_scale <= 0.0) {
+    throw std::invalid_argument("generic_model: Invalid time scale");
+  }
+  d_time_scale = time_scale;
+}
+
+double
+generic_model::get_time_scale() const
+{
+  return d_time_scale;
+}
+
+std::map<std::string, stage_stats_t>
+generic_model::get_stats()
+{
+  return std::map<std::string, stage_stats_t>();
+}
+
+void
+generic_model::reset_stats()
+{
+}
+
+int
+generic_model::generic_general_work(const gr_complex *inbuffer,
+                                    int ninput_items, int &consumed,
+                                    gr_complex *outbuffer, int noutput_items,
+                                    double samp_rate)
+{
+  int n = std::min(ninput_items, noutput_items);
+  generic_work(inbuffer, outbuffer, n, samp_rate);
+  consumed = n;
+  return n;
+}
+
+int
+generic_model::forecast(int noutput_items)
+{
+  return noutput_items;
 }
 
 double
@@ -209,7 +273,7 @@ generic_model::get_satellite_antenna()
   }
 }
 
-int generic_model::base_unique_id = 1;
+std::atomic<int> generic_model::base_unique_id(1);
 
 int
 generic_model::unique_id()
@@ -220,7 +284,7 @@ generic_model::unique_id()
 double
 generic_model::get_noise_floor()
 {
-  return d_noise_floor;
+  return d_state.noise_floor;
 }
 
 /**
@@ -231,8 +295,7 @@ generic_model::get_noise_floor()
 bool
 generic_model::aos()
 {
-  const double elev = d_tracker->get_elevation_degrees();
-  return elev > 1.0;
+  return d_state.aos;
 }
 
 void
@@ -246,6 +309,9 @@ generic_model::orbit_update()
   generic_attenuation::set_frequency(get_frequency());
   generic_attenuation::set_polarization(polarization);
   generic_attenuation::set_slant_range(range);
+  generic_attenuation::set_time(
+    static_cast<double>(d_tracker->get_elapsed_time().Ticks())
+    / libsgp4::TicksPerSecond);
 }
 
 } /* namespace leo */
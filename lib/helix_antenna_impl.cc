@@ -50,8 +50,13 @@ helix_antenna_impl::helix_antenna_impl(antenna_t type, double frequency,
   generic_antenna(HELIX, frequency, polarization, pointing_error),
   d_turns(turns),
   d_turn_spacing(turn_spacing),
-  d_circumference(circumference)
+  d_circumference(circumference),
+  d_gain(10 * std::log10(15 * std::pow(circumference, 2) * turns
+                         * turn_spacing)),
+  d_beamwidth(115 / (circumference * std::sqrt(turns * turn_spacing))),
+  d_rolloff_scale(79.76 / d_beamwidth)
 {
+  update_gain_rolloff();
   LEO_DEBUG("HELIX");
   LEO_DEBUG("Maximum Gain: %f", get_gain());
   LEO_DEBUG("Beamwidth: %f", get_beamwidth());
@@ -64,16 +69,20 @@ helix_antenna_impl::~helix_antenna_impl()
 double
 helix_antenna_impl::get_gain()
 {
-  return 10
-         * std::log10(
-           15 * std::pow(d_circumference, 2) * d_turns * d_turn_spacing);
+  return d_gain;
 }
 
 double
 helix_antenna_impl::get_gain_rolloff()
 {
-  double error_deg = utils::radians_to_degrees(d_pointing_error);
-  double tmp = 2 * error_deg * (79.76 / get_beamwidth());
+  return d_gain_rolloff;
+}
+
+double
+helix_antenna_impl::get_gain_rolloff(double theta, double phi)
+{
+  double error_deg = utils::radians_to_degrees(theta);
+  double tmp = 2 * error_deg * d_rolloff_scale;
   if (error_deg > 0) {
     return -10
            * std::log10(
@@ -89,7 +98,7 @@ helix_antenna_impl::get_gain_rolloff()
 double
 helix_antenna_impl::get_beamwidth()
 {
-  return 115 / (d_circumference * std::sqrt(d_turns * d_turn_spacing));
+  return d_beamwidth;
 }
 
 } /* namespace antenna */
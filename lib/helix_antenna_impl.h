@@ -72,6 +72,9 @@ public:
   double
   get_gain_rolloff();
 
+  double
+  get_gain_rolloff(double theta, double phi);
+
   /*!
    * \brief Get the beamwidth of the helix antenna. This is the implementation
    * of the parent's pure virtual function for the helix antenna.
@@ -85,6 +88,9 @@ private:
   size_t d_turns;
   double d_turn_spacing;
   double d_circumference;
+  double d_gain;
+  double d_beamwidth;
+  double d_rolloff_scale;
 
 };
 } // namespace antenna
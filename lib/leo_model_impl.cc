@@ -23,10 +23,12 @@
 #endif
 
 #include "leo_model_impl.h"
+#include <algorithm>
 #include <cstring>
 #include <gnuradio/leo/free_space_path_loss.h>
 #include <gnuradio/leo/atmospheric_gases_itu.h>
 #include <gnuradio/leo/atmospheric_gases_regression.h>
+#include <gnuradio/leo/atmospheric_gases_itu_annex2.h>
 #include <gnuradio/leo/precipitation_itu.h>
 #include <gnuradio/leo/antenna_pointing_loss.h>
 #include <gnuradio/leo/utils/helper.h>
@@ -46,7 +48,12 @@ leo_model::make(tracker::tracker_sptr tracker, const link_mode_t mode,
                 const impairment_enum_t precipitation_attenuation,
                 const bool enable_link_margin,
                 const double surface_watervap_density,
-                const double temperature, const double rainfall_rate)
+                const double temperature, const double rainfall_rate,
+                const impairment_enum_t time_compression_enum,
+                rotator::rotator_sptr rotator,
+                attitude::attitude_sptr attitude, unsigned int seed,
+                const double rain_probability, const double fade_dynamics,
+                const bool topographic_altitude)
 {
   return generic_model::generic_model_sptr(
            new leo_model_impl(tracker, mode, fspl_attenuation_enum,
@@ -55,7 +62,9 @@ leo_model::make(tracker::tracker_sptr tracker, const link_mode_t mode,
                               precipitation_attenuation,
                               enable_link_margin,
                               surface_watervap_density, temperature,
-                              rainfall_rate));
+                              rainfall_rate, time_compression_enum, rotator,
+                              attitude, seed, rain_probability,
+                              fade_dynamics, topographic_altitude));
 }
 
 leo_model_impl::leo_model_impl(tracker::tracker_sptr tracker,
@@ -68,9 +77,17 @@ leo_model_impl::leo_model_impl(tracker::tracker_sptr tracker,
                                const bool enable_link_margin,
                                const double surface_watervap_density,
                                const double temperature,
-                               const double rainfall_rate) :
+                               const double rainfall_rate,
+                               const impairment_enum_t time_compression_enum,
+                               rotator::rotator_sptr rotator,
+                               attitude::attitude_sptr attitude,
+                               unsigned int seed,
+                               const double rain_probability,
+                               const double fade_dynamics,
+                               const bool topographic_altitude) :
   generic_model("leo_model", tracker, mode),
   d_doppler_shift_enum(doppler_shift_enum),
+  d_time_compression_enum(time_compression_enum),
   d_doppler_shift(0),
   d_phase(1.0, 0.0),
   d_atmo_attenuation(0.0),
@@ -87,7 +104,17 @@ leo_model_impl::leo_model_impl(tracker::tracker_sptr tracker,
   d_atmo_gases_attenuation(nullptr),
   d_precipitation_attenuation(nullptr),
   d_fspl_attenuation(nullptr),
-  d_pointing_loss_attenuation(nullptr)
+  d_pointing_loss_attenuation(nullptr),
+  d_rotator(rotator),
+  d_attitude(attitude),
+  d_epoch(tracker->get_elapsed_time()),
+  d_resampler(nullptr),
+  d_time_compression_updated(false),
+  d_profiler({
+  "sgp4", "atmo_attenuation", "precipitation_attenuation",
+  "fspl_attenuation", "pointing_attenuation", "link_margin",
+  "doppler_rotator", "gain", "resampler"
+})
 {
   orbit_update();
 
@@ -99,6 +126,16 @@ leo_model_impl::leo_model_impl(tracker::tracker_sptr tracker,
     throw std::runtime_error("Invalid Doppler shift enumeration!");
   }
 
+  switch (d_time_compression_enum) {
+  case TIME_COMPRESSION:
+    d_resampler.reset(new utils::polyphase_resampler());
+    break;
+  case IMPAIRMENT_NONE:
+    break;
+  default:
+    throw std::runtime_error("Invalid time compression enumeration!");
+  }
+
   switch (enable_link_margin) {
   case true:
     d_link_margin = link_margin::make();
@@ -121,6 +158,11 @@ leo_model_impl::leo_model_impl(tracker::tracker_sptr tracker,
       attenuation::atmospheric_gases_regression::make(
         d_surface_watervap_density, d_temperature);
     break;
+  case ATMO_GASES_ITU_ANNEX2:
+    d_atmo_gases_attenuation =
+      attenuation::atmospheric_gases_itu_annex2::make(
+        d_surface_watervap_density, d_temperature);
+    break;
   case IMPAIRMENT_NONE:
     break;
   default:
@@ -130,10 +172,12 @@ leo_model_impl::leo_model_impl(tracker::tracker_sptr tracker,
   switch (precipitation_enum) {
   case PRECIPITATION_ITU:
   case PRECIPITATION_CUSTOM:
+  case PRECIPITATION_STATISTICAL:
     d_precipitation_attenuation = attenuation::precipitation_itu::make(
                                     d_rainfall_rate, d_tracker->get_lontitude(),
                                     d_tracker->get_latitude(), d_tracker->get_altitude(),
-                                    precipitation_enum);
+                                    precipitation_enum, rain_probability,
+                                    fade_dynamics, seed, topographic_altitude);
     break;
   case IMPAIRMENT_NONE:
     break;
@@ -154,9 +198,11 @@ leo_model_impl::leo_model_impl(tracker::tracker_sptr tracker,
 
   switch (pointing_attenuation_enum) {
   case ANTENNA_POINTING_LOSS:
+  case ANTENNA_POINTING_LOSS_GEOMETRIC:
     d_pointing_loss_attenuation =
       attenuation::antenna_pointing_loss::make(
-        get_tracker_antenna(), get_satellite_antenna());
+        get_tracker_antenna(), get_satellite_antenna(),
+        pointing_attenuation_enum, d_rotator, d_attitude);
     break;
   case IMPAIRMENT_NONE:
     break;
@@ -164,6 +210,14 @@ leo_model_impl::leo_model_impl(tracker::tracker_sptr tracker,
     throw std::runtime_error(
       "Invalid antenna pointing loss enumeration!");
   }
+
+  /* Apply the state at the start of the observation */
+  update_state();
+  set_state(d_computed_state);
+  if (d_resampler) {
+    d_resampler->reset(d_state.time_compression_ratio);
+    d_time_compression_updated = false;
+  }
 }
 
 leo_model_impl::~leo_model_impl()
@@ -176,40 +230,59 @@ leo_model_impl::calculate_doppler_shift(double velocity)
   return (-1e3 * velocity * get_frequency()) / LIGHT_SPEED;
 }
 
+double
+leo_model_impl::calculate_time_compression(double velocity)
+{
+  return 1.0 - (1e3 * velocity) / LIGHT_SPEED;
+}
+
 double
 leo_model_impl::calculate_total_attenuation()
 {
   d_total_attenuation = 0;
 
-  orbit_update();
-
   if (d_atmo_gases_attenuation) {
+    LEO_PROFILE(d_profiler, STAGE_ATMO);
     d_atmo_attenuation = d_atmo_gases_attenuation->get_attenuation();
     d_total_attenuation += d_atmo_attenuation;
   }
   if (d_precipitation_attenuation) {
+    LEO_PROFILE(d_profiler, STAGE_PRECIPITATION);
     d_rainfall_attenuation =
       d_precipitation_attenuation->get_attenuation();
     d_total_attenuation += d_rainfall_attenuation;
   }
   if (d_fspl_attenuation) {
+    LEO_PROFILE(d_profiler, STAGE_FSPL);
     d_pathloss_attenuation = d_fspl_attenuation->get_attenuation();
     d_total_attenuation += d_pathloss_attenuation;
   }
   if (d_pointing_loss_attenuation) {
+    LEO_PROFILE(d_profiler, STAGE_POINTING);
+    const double t = (d_tracker->get_elapsed_time() - d_epoch).TotalSeconds();
+    if (d_rotator) {
+      /* The look angle of this time step is already cached by the tracker */
+      d_rotator->update(t, d_tracker->get_azimuth_degrees(),
+                        d_tracker->get_elevation_degrees());
+    }
+    if (d_attitude) {
+      d_attitude->update(t, d_tracker->get_eci_state());
+    }
     d_pointing_attenuation =
       d_pointing_loss_attenuation->get_attenuation();
     d_total_attenuation += d_pointing_attenuation;
   }
   if (d_link_margin) {
+    LEO_PROFILE(d_profiler, STAGE_LINK_MARGIN);
     estimate_link_margin();
   }
 
+  /* The arguments are evaluated only if the debug messages are enabled */
   LEO_DEBUG(
-    "Time: %s | Slant Range (km): %f | Elevation (degrees): %f | \
-    Path Loss (dB): %f | Atmospheric Loss (dB): %f | Rainfall Loss\
-    (dB): %f | Pointing Loss (dB): %f |  Doppler (Hz): %f | \
-    Link Margin (dB): %f",
+    "Time: %s | Slant Range (km): %f | Elevation (degrees): %f | "
+    "Path Loss (dB): %f | Atmospheric Loss (dB): %f | "
+    "Rainfall Loss (dB): %f | Pointing Loss (dB): %f | Doppler (Hz): %f | "
+    "Link Margin (dB): %f",
     d_tracker->get_elapsed_time().ToString().c_str(), d_slant_range,
     d_elev, d_pathloss_attenuation,
     d_atmo_attenuation, d_rainfall_attenuation, d_pointing_attenuation,
@@ -254,12 +327,12 @@ leo_model_impl::get_csv_log()
     d_write_csv_header = false;
   }
   else {
-    stringStream << d_tracker->get_elapsed_time().ToString().c_str()
-                 << "," << d_slant_range << ","
-                 << d_elev << ","
-                 << d_pathloss_attenuation << "," << d_atmo_attenuation << ","
-                 << d_rainfall_attenuation << "," << d_pointing_attenuation << ","
-                 << d_doppler_shift << "," << d_link_margin_db;
+    stringStream << libsgp4::DateTime(d_state.elapsed_ticks).ToString().c_str()
+                 << "," << d_state.slant_range << ","
+                 << d_state.elevation << ","
+                 << d_state.pathloss_attenuation << "," << d_state.atmo_attenuation << ","
+                 << d_state.rainfall_attenuation << "," << d_state.pointing_attenuation << ","
+                 << d_state.doppler_shift << "," << d_state.link_margin_db;
   }
   return stringStream.str();
 }
@@ -269,26 +342,26 @@ std::vector<std::pair<pmt::pmt_t, pmt::pmt_t>>
 {
   std::vector<std::pair<pmt::pmt_t, pmt::pmt_t>> vec;
   vec.push_back(std::pair<pmt::pmt_t, pmt::pmt_t>(pmt::intern("elapsed_time"),
-                pmt::intern(d_tracker->get_elapsed_time().ToString().c_str())));
+                pmt::intern(libsgp4::DateTime(d_state.elapsed_ticks).ToString().c_str())));
   vec.push_back(std::pair<pmt::pmt_t, pmt::pmt_t>(pmt::intern("slant_range"),
-                pmt::from_double(d_slant_range)));
+                pmt::from_double(d_state.slant_range)));
   vec.push_back(std::pair<pmt::pmt_t, pmt::pmt_t>(pmt::intern("elevation"),
-                pmt::from_double(d_elev)));
+                pmt::from_double(d_state.elevation)));
   vec.push_back(std::pair<pmt::pmt_t, pmt::pmt_t>
                 (pmt::intern("pathloss_attenuation"),
-                 pmt::from_double(d_pathloss_attenuation)));
+                 pmt::from_double(d_state.pathloss_attenuation)));
   vec.push_back(std::pair<pmt::pmt_t, pmt::pmt_t>(pmt::intern("atmo_attenuation"),
-                pmt::from_double(d_atmo_attenuation)));
+                pmt::from_double(d_state.atmo_attenuation)));
   vec.push_back(std::pair<pmt::pmt_t, pmt::pmt_t>
                 (pmt::intern("rainfall_attenuation"),
-                 pmt::from_double(d_rainfall_attenuation)));
+                 pmt::from_double(d_state.rainfall_attenuation)));
   vec.push_back(std::pair<pmt::pmt_t, pmt::pmt_t>
                 (pmt::intern("pointing_attenuation"),
-                 pmt::from_double(d_pointing_attenuation)));
+                 pmt::from_double(d_state.pointing_attenuation)));
   vec.push_back(std::pair<pmt::pmt_t, pmt::pmt_t>
-                (pmt::intern("doppler_shift_freq"), pmt::from_double(d_doppler_shift)));
+                (pmt::intern("doppler_shift_freq"), pmt::from_double(d_state.doppler_shift)));
   vec.push_back(std::pair<pmt::pmt_t, pmt::pmt_t>(pmt::intern("link_margin_db"),
-                pmt::from_double(d_link_margin_db)));
+                pmt::from_double(d_state.link_margin_db)));
   return vec;
 }
 
@@ -299,13 +372,53 @@ leo_model_impl::get_doppler_freq()
 }
 
 void
-leo_model_impl::advance_time(double us)
+leo_model_impl::update_state()
 {
-  d_tracker->advance_time(us);
+  double velocity;
+  {
+    LEO_PROFILE(d_profiler, STAGE_SGP4);
+    d_elev = d_tracker->get_elevation_degrees();
+    d_slant_range = d_tracker->get_slant_range();
+    velocity = d_tracker->get_velocity();
+    /* The geometry of the attenuation models */
+    orbit_update();
+  }
+  d_doppler_shift = calculate_doppler_shift(velocity);
   calculate_total_attenuation();
-  d_elev = d_tracker->get_elevation_degrees();
-  d_slant_range = d_tracker->get_slant_range();
-  d_doppler_shift = calculate_doppler_shift(d_tracker->get_velocity());
+
+  d_computed_state.aos = d_elev > 1.0;
+  d_computed_state.elapsed_ticks = d_tracker->get_elapsed_time().Ticks();
+  d_computed_state.slant_range = d_slant_range;
+  d_computed_state.elevation = d_elev;
+  d_computed_state.velocity = velocity;
+  d_computed_state.doppler_shift = d_doppler_shift;
+  d_computed_state.pathloss_attenuation = d_pathloss_attenuation;
+  d_computed_state.atmo_attenuation = d_atmo_attenuation;
+  d_computed_state.rainfall_attenuation = d_rainfall_attenuation;
+  d_computed_state.pointing_attenuation = d_pointing_attenuation;
+  d_computed_state.total_attenuation = d_total_attenuation;
+  d_computed_state.link_margin_db = d_link_margin_db;
+  d_computed_state.noise_floor = d_noise_floor;
+  d_computed_state.time_compression_ratio = calculate_time_compression(velocity);
+}
+
+std::map<std::string, stage_stats_t>
+leo_model_impl::get_stats()
+{
+  return d_profiler.get_stats();
+}
+
+void
+leo_model_impl::reset_stats()
+{
+  d_profiler.reset();
+}
+
+void
+leo_model_impl::set_state(const model_state_t &state)
+{
+  generic_model::set_state(state);
+  d_time_compression_updated = true;
 }
 
 double
@@ -363,10 +476,11 @@ leo_model_impl::generic_work(const gr_complex *inbuffer, gr_complex *outbuffer,
   const gr_complex *in = (const gr_complex *) inbuffer;
   gr_complex *out = (gr_complex *) outbuffer;
 
-  if (aos()) {
+  if (d_state.aos) {
     if (d_doppler_shift_enum == DOPPLER_SHIFT) {
+      LEO_PROFILE(d_profiler, STAGE_DOPPLER);
       volk_32fc_s32fc_x2_rotator_32fc(outbuffer, inbuffer,
-                                      std::polar<float>(1.0f, static_cast<float>(2.0f * M_PI * d_doppler_shift / samp_rate)),
+                                      std::polar<float>(1.0f, static_cast<float>(2.0f * M_PI * d_state.doppler_shift / samp_rate)),
                                       &d_phase, noutput_items);
       /* Change the pointer to simplify the rest of the logic */
       inbuffer = outbuffer;
@@ -375,8 +489,9 @@ leo_model_impl::generic_work(const gr_complex *inbuffer, gr_complex *outbuffer,
      * Get total attenuation in dB, convert it to linear and
      * multiply
      */
+    LEO_PROFILE(d_profiler, STAGE_GAIN);
     gr_complex attenuation_linear = gr_complex(1.0 / std::pow(10.0f,
-                                    (d_total_attenuation / 20.0f)), 0.0f);
+                                    (d_state.total_attenuation / 20.0f)), 0.0f);
     volk_32fc_s32fc_multiply_32fc(outbuffer, inbuffer, attenuation_linear,
                                   noutput_items);
   }
@@ -386,7 +501,61 @@ leo_model_impl::generic_work(const gr_complex *inbuffer, gr_complex *outbuffer,
   }
 }
 
+int
+leo_model_impl::generic_general_work(const gr_complex *inbuffer,
+                                     int ninput_items, int &consumed,
+                                     gr_complex *outbuffer, int noutput_items,
+                                     double samp_rate)
+{
+  if (!d_resampler) {
+    return generic_model::generic_general_work(inbuffer, ninput_items,
+           consumed, outbuffer,
+           noutput_items, samp_rate);
+  }
+
+  if (!d_state.aos) {
+    int n = std::min(ninput_items, noutput_items);
+    generic_work(inbuffer, outbuffer, n, samp_rate);
+    d_resampler->reset(d_state.time_compression_ratio);
+    d_time_compression_updated = false;
+    consumed = n;
+    return n;
+  }
+
+  /*
+   * Slew to the ratio of the new time step over the whole time window, so
+   * the time compression follows the range rate without discontinuities
+   */
+  if (d_time_compression_updated) {
+    d_resampler->set_ratio(d_state.time_compression_ratio,
+                           (samp_rate * d_tracker->get_time_resolution_us())
+                           / (1e6 * d_time_scale));
+    d_time_compression_updated = false;
+  }
+
+  size_t nconsumed = 0;
+  int produced;
+  {
+    LEO_PROFILE(d_profiler, STAGE_RESAMPLER);
+    produced = d_resampler->resample(outbuffer, noutput_items, inbuffer,
+                                     ninput_items, nconsumed);
+  }
+  consumed = nconsumed;
+
+  /* Doppler shift and attenuation are applied in place */
+  generic_work(outbuffer, outbuffer, produced, samp_rate);
+  return produced;
+}
+
+int
+leo_model_impl::forecast(int noutput_items)
+{
+  if (d_resampler) {
+    return d_resampler->ninput_required(noutput_items);
+  }
+  return noutput_items;
+}
+
 } /* namespace model */
 } /* namespace leo */
 } /* namespace gr */
-
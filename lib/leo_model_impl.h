@@ -23,6 +23,9 @@
 
 #include <pmt/pmt.h>
 #include <gnuradio/leo/leo_model.h>
+#include "utils/polyphase_resampler.h"
+#include "utils/stage_profiler.h"
+#include <memory>
 
 namespace gr {
 namespace leo {
@@ -31,6 +34,7 @@ class LEO_API leo_model_impl : public leo_model {
 
 private:
   const impairment_enum_t d_doppler_shift_enum;
+  const impairment_enum_t d_time_compression_enum;
 
   double d_temperature;
   double d_rainfall_rate;
@@ -51,6 +55,39 @@ private:
   generic_attenuation::generic_attenuation_sptr d_fspl_attenuation;
   generic_attenuation::generic_attenuation_sptr d_pointing_loss_attenuation;
 
+  /*!
+   * \brief The rotator of the ground station antenna, the attitude of the
+   * satellite and the time that their clock starts
+   */
+  rotator::rotator_sptr d_rotator;
+  attitude::attitude_sptr d_attitude;
+  libsgp4::DateTime d_epoch;
+
+  /*!
+   * \brief Resampler that applies the time compression of the signal
+   */
+  std::unique_ptr<utils::polyphase_resampler> d_resampler;
+
+  /*!
+   * \brief Set when a new state is applied, so the resampler slews to
+   * the new time compression ratio
+   */
+  bool d_time_compression_updated;
+
+  enum stage_t {
+    STAGE_SGP4 = 0,
+    STAGE_ATMO,
+    STAGE_PRECIPITATION,
+    STAGE_FSPL,
+    STAGE_POINTING,
+    STAGE_LINK_MARGIN,
+    STAGE_DOPPLER,
+    STAGE_GAIN,
+    STAGE_RESAMPLER
+  };
+
+  utils::stage_profiler d_profiler;
+
   /*!
    * Calculate the free-space path-loss attenuation for a
    * given slant range.
@@ -70,6 +107,16 @@ private:
   double
   calculate_doppler_shift(double velocity);
 
+  /*!
+   * Calculate the time compression of the signal for a given satellite
+   * range rate.
+   * \param velocity The range rate of the satellite expressed in
+   * kilometers/sec.
+   * @return the ratio between the input and the output samples.
+   */
+  double
+  calculate_time_compression(double velocity);
+
   double
   calculate_total_attenuation();
 
@@ -82,7 +129,12 @@ public:
                  const impairment_enum_t precipitation_attenuation,
                  const bool enable_link_margin,
                  const double surface_watervap_density,
-                 const double temperature, const double rainfall_rate);
+                 const double temperature, const double rainfall_rate,
+                 const impairment_enum_t time_compression_enum,
+                 rotator::rotator_sptr rotator,
+                 attitude::attitude_sptr attitude, unsigned int seed,
+                 const double rain_probability, const double fade_dynamics,
+                 const bool topographic_altitude);
 
   ~leo_model_impl();
 
@@ -90,6 +142,14 @@ public:
   generic_work(const gr_complex *inbuffer, gr_complex *outbuffer,
                int noutput_items, double samp_rate);
 
+  int
+  generic_general_work(const gr_complex *inbuffer, int ninput_items,
+                       int &consumed, gr_complex *outbuffer,
+                       int noutput_items, double samp_rate);
+
+  int
+  forecast(int noutput_items);
+
   void
   estimate_link_margin();
 
@@ -106,7 +166,16 @@ public:
   get_doppler_freq();
 
   void
-  advance_time(double us);
+  update_state();
+
+  std::map<std::string, stage_stats_t>
+  get_stats();
+
+  void
+  reset_stats();
+
+  void
+  set_state(const model_state_t &state);
 
   double
   get_atmo_attenuation();
@@ -0,0 +1,624 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/leo/log.h>
+#include <gnuradio/logger.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* The size of the encoded arguments of a record */
+const size_t RECORD_ARGS = 96;
+
+/*
+ * A fixed size binary log record. Only the pointers to the static strings
+ * of the call site, including the format, and the raw values of the
+ * arguments are kept, so recording neither formats nor allocates. The
+ * strings of %s arguments are copied, since they may not outlive the call.
+ */
+typedef struct {
+  int64_t timestamp_us;
+  const char *file;
+  const char *fmt;
+  int32_t line;
+  int16_t level;
+  uint8_t nargs_bytes;
+  bool truncated;
+  unsigned char args[RECORD_ARGS];
+} record_t;
+
+/* The types of the arguments of the printf conversions */
+enum arg_type_t {
+  ARG_NONE = 0, ARG_INT, ARG_LONG, ARG_LLONG, ARG_SIZE, ARG_INTMAX,
+  ARG_PTRDIFF, ARG_DOUBLE, ARG_LDOUBLE, ARG_STRING, ARG_POINTER
+};
+
+/*
+ * A conversion of a printf format: its specification [begin, end), its
+ * argument type and whether its width and precision are given as arguments
+ */
+typedef struct {
+  const char *begin;
+  const char *end;
+  arg_type_t type;
+  bool star_width;
+  bool star_precision;
+} conversion_t;
+
+/*
+ * Find the next conversion of a format, starting at p.
+ * Returns false at the end of the format.
+ */
+bool
+next_conversion(const char *&p, conversion_t &c)
+{
+  while (*p) {
+    if (*p != '%') {
+      p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      p += 2;
+      continue;
+    }
+    c.begin = p++;
+    c.star_width = false;
+    c.star_precision = false;
+    while (*p && std::strchr("-+ #0'", *p)) {
+      p++;
+    }
+    if (*p == '*') {
+      c.star_width = true;
+      p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+      p++;
+    }
+    if (*p == '.') {
+      p++;
+      if (*p == '*') {
+        c.star_precision = true;
+        p++;
+      }
+      while (*p >= '0' && *p <= '9') {
+        p++;
+      }
+    }
+    int longs = 0;
+    char size = 0;
+    while (*p && std::strchr("hlLzjt", *p)) {
+      if (*p == 'l') {
+        longs++;
+      }
+      else if (*p != 'h') {
+        size = *p;
+      }
+      p++;
+    }
+    if (!*p) {
+      return false;
+    }
+    switch (*p) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    case 'c':
+      c.type = size == 'z' ? ARG_SIZE : size == 'j' ? ARG_INTMAX
+               : size == 't' ? ARG_PTRDIFF : longs == 1 ? ARG_LONG
+               : longs > 1 ? ARG_LLONG : ARG_INT;
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      c.type = size == 'L' ? ARG_LDOUBLE : ARG_DOUBLE;
+      break;
+    case 's':
+      c.type = ARG_STRING;
+      break;
+    case 'p':
+      c.type = ARG_POINTER;
+      break;
+    default:
+      /* %n and unknown conversions are not supported */
+      c.type = ARG_NONE;
+      break;
+    }
+    c.end = ++p;
+    return true;
+  }
+  return false;
+}
+
+/* Appends a value to the arguments of a record, if it fits */
+template <typename T>
+bool
+put_arg(record_t &r, const T &v)
+{
+  if (r.nargs_bytes + sizeof(T) > RECORD_ARGS) {
+    r.truncated = true;
+    return false;
+  }
+  std::memcpy(r.args + r.nargs_bytes, &v, sizeof(T));
+  r.nargs_bytes += sizeof(T);
+  return true;
+}
+
+template <typename T>
+bool
+get_arg(const record_t &r, size_t &pos, T &v)
+{
+  if (pos + sizeof(T) > r.nargs_bytes) {
+    return false;
+  }
+  std::memcpy(&v, r.args + pos, sizeof(T));
+  pos += sizeof(T);
+  return true;
+}
+
+/*
+ * Records the arguments of a message without formatting it. A string that
+ * does not fit is cut, any other argument is dropped, and the record is
+ * marked as truncated.
+ */
+void
+encode_args(record_t &r, const char *fmt, va_list args)
+{
+  const char *p = fmt;
+  conversion_t c;
+  r.nargs_bytes = 0;
+  r.truncated = false;
+  while (!r.truncated && next_conversion(p, c)) {
+    if (c.star_width) {
+      put_arg(r, va_arg(args, int));
+    }
+    if (c.star_precision) {
+      put_arg(r, va_arg(args, int));
+    }
+    switch (c.type) {
+    case ARG_INT:
+      put_arg(r, va_arg(args, int));
+      break;
+    case ARG_LONG:
+      put_arg(r, va_arg(args, long));
+      break;
+    case ARG_LLONG:
+      put_arg(r, va_arg(args, long long));
+      break;
+    case ARG_SIZE:
+      put_arg(r, va_arg(args, size_t));
+      break;
+    case ARG_INTMAX:
+      put_arg(r, va_arg(args, intmax_t));
+      break;
+    case ARG_PTRDIFF:
+      put_arg(r, va_arg(args, ptrdiff_t));
+      break;
+    case ARG_DOUBLE:
+      put_arg(r, va_arg(args, double));
+      break;
+    case ARG_LDOUBLE:
+      put_arg(r, va_arg(args, long double));
+      break;
+    case ARG_POINTER:
+      put_arg(r, va_arg(args, void *));
+      break;
+    case ARG_STRING: {
+      const char *str = va_arg(args, const char *);
+      if (!str) {
+        str = "(null)";
+      }
+      const size_t len = std::strlen(str);
+      const size_t room = RECORD_ARGS - std::min<size_t>(RECORD_ARGS,
+                          r.nargs_bytes + 1);
+      const uint8_t n = static_cast<uint8_t>(std::min(len, room));
+      if (!put_arg(r, n)) {
+        break;
+      }
+      std::memcpy(r.args + r.nargs_bytes, str, n);
+      r.nargs_bytes += n;
+      if (n < len) {
+        r.truncated = true;
+      }
+      break;
+    }
+    default:
+      r.truncated = true;
+      break;
+    }
+  }
+}
+
+/* Formats one conversion of a record with its decoded argument */
+template <typename T>
+int
+format_arg(char *buf, size_t len, const std::string &spec, const record_t &r,
+           size_t &pos)
+{
+  T v;
+  if (!get_arg(r, pos, v)) {
+    return 0;
+  }
+  return snprintf(buf, len, spec.c_str(), v);
+}
+
+/*
+ * Formats the message of a record from its format and its encoded
+ * arguments, at dump time
+ */
+void
+decode_message(char *buf, size_t len, const record_t &r)
+{
+  const char *p = r.fmt;
+  const char *text = p;
+  size_t pos = 0;
+  size_t out = 0;
+  conversion_t c;
+  auto append = [&](const char *s, size_t n) {
+    n = std::min(n, len - 1 - out);
+    std::memcpy(buf + out, s, n);
+    out += n;
+  };
+  /* Copies the text between the conversions, where %% stands for % */
+  auto append_text = [&](const char *s, const char *e) {
+    for (; s < e; s++) {
+      append(s, 1);
+      if (*s == '%' && s + 1 < e && s[1] == '%') {
+        s++;
+      }
+    }
+  };
+
+  while (next_conversion(p, c)) {
+    append_text(text, c.begin);
+    text = c.end;
+
+    /* Substitute the width and the precision given as arguments */
+    std::string spec;
+    for (const char *s = c.begin; s != c.end; s++) {
+      int v;
+      if (*s == '*' && get_arg(r, pos, v)) {
+        spec += std::to_string(v);
+      }
+      else {
+        spec += *s;
+      }
+    }
+
+    char tmp[RECORD_ARGS + 64];
+    int n = 0;
+    switch (c.type) {
+    case ARG_INT:
+      n = format_arg<int>(tmp, sizeof(tmp), spec, r, pos);
+      break;
+    case ARG_LONG:
+      n = format_arg<long>(tmp, sizeof(tmp), spec, r, pos);
+      break;
+    case ARG_LLONG:
+      n = format_arg<long long>(tmp, sizeof(tmp), spec, r, pos);
+      break;
+    case ARG_SIZE:
+      n = format_arg<size_t>(tmp, sizeof(tmp), spec, r, pos);
+      break;
+    case ARG_INTMAX:
+      n = format_arg<intmax_t>(tmp, sizeof(tmp), spec, r, pos);
+      break;
+    case ARG_PTRDIFF:
+      n = format_arg<ptrdiff_t>(tmp, sizeof(tmp), spec, r, pos);
+      break;
+    case ARG_DOUBLE:
+      n = format_arg<double>(tmp, sizeof(tmp), spec, r, pos);
+      break;
+    case ARG_LDOUBLE:
+      n = format_arg<long double>(tmp, sizeof(tmp), spec, r, pos);
+      break;
+    case ARG_POINTER:
+      n = format_arg<void *>(tmp, sizeof(tmp), spec, r, pos);
+      break;
+    case ARG_STRING: {
+      uint8_t slen;
+      if (get_arg(r, pos, slen) && pos + slen <= r.nargs_bytes) {
+        char str[RECORD_ARGS + 1];
+        std::memcpy(str, r.args + pos, slen);
+        str[slen] = '\0';
+        pos += slen;
+        n = snprintf(tmp, sizeof(tmp), spec.c_str(), str);
+      }
+      break;
+    }
+    default:
+      break;
+    }
+    append(tmp, std::max(0, std::min<int>(n, sizeof(tmp) - 1)));
+  }
+  append_text(text, text + std::strlen(text));
+  buf[out] = '\0';
+}
+
+const char *level_names[] = {
+  "TRACE", "DEBUG", "INFO", "WARN", "ERROR", "OFF"
+};
+
+std::atomic<size_t> rate_limit(10);
+std::atomic<bool> forward(true);
+std::atomic<bool> recording(false);
+
+/* Guards the ring buffer and the forwarding of the messages */
+std::mutex mtx;
+std::vector<record_t> ring;
+size_t ring_head = 0;
+size_t ring_count = 0;
+
+gr::logger &
+gr_logger()
+{
+  static gr::logger l("gr-leo");
+  return l;
+}
+
+gr::log_level
+to_gr_level(log_level_t level)
+{
+  switch (level) {
+  case LOG_LEVEL_TRACE:
+    return gr::log_level::trace;
+  case LOG_LEVEL_DEBUG:
+    return gr::log_level::debug;
+  case LOG_LEVEL_INFO:
+    return gr::log_level::info;
+  case LOG_LEVEL_WARN:
+    return gr::log_level::warn;
+  case LOG_LEVEL_ERROR:
+    return gr::log_level::err;
+  default:
+    return gr::log_level::off;
+  }
+}
+
+/* Strip the directories, the call site is identified by the file name */
+const char *
+strip_path(const char *path)
+{
+  const char *b = path;
+  for (const char *p = path; *p; p++) {
+    if (*p == '/' || *p == '\\') {
+      b = p + 1;
+    }
+  }
+  return b;
+}
+
+void
+format_record(char *buf, size_t len, const record_t &r)
+{
+  const std::time_t sec = static_cast<std::time_t>(r.timestamp_us / 1000000);
+  std::tm tm;
+  gmtime_r(&sec, &tm);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &tm);
+  char msg[512];
+  decode_message(msg, sizeof(msg), r);
+  snprintf(buf, len, "%s.%06lldZ [%s] %s:%d: %s%s", date,
+           static_cast<long long>(r.timestamp_us % 1000000),
+           level_names[r.level], r.file, r.line, msg,
+           r.truncated ? " [truncated]" : "");
+}
+
+} // namespace
+
+/* Warnings and errors are reported by default, as before */
+std::atomic<int> logging::s_level(LOG_LEVEL_WARN);
+
+logging::rate_limiter::rate_limiter() :
+  d_window(-1),
+  d_count(0),
+  d_suppressed(0)
+{
+}
+
+bool
+logging::rate_limiter::allow()
+{
+  const size_t limit = rate_limit.load(std::memory_order_relaxed);
+  if (limit == 0) {
+    return true;
+  }
+  const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count();
+  int64_t window = d_window.load(std::memory_order_relaxed);
+  if (window != now
+      && d_window.compare_exchange_strong(window, now,
+                                          std::memory_order_relaxed)) {
+    d_count.store(0, std::memory_order_relaxed);
+  }
+  if (d_count.fetch_add(1, std::memory_order_relaxed) < limit) {
+    return true;
+  }
+  d_suppressed.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+uint64_t
+logging::rate_limiter::take_suppressed()
+{
+  return d_suppressed.exchange(0, std::memory_order_relaxed);
+}
+
+void
+logging::set_level(log_level_t level)
+{
+  s_level.store(level, std::memory_order_relaxed);
+  gr_logger().set_level(to_gr_level(level));
+}
+
+log_level_t
+logging::get_level()
+{
+  return static_cast<log_level_t>(s_level.load(std::memory_order_relaxed));
+}
+
+void
+logging::set_rate_limit(size_t messages_per_sec)
+{
+  rate_limit.store(messages_per_sec, std::memory_order_relaxed);
+}
+
+size_t
+logging::get_rate_limit()
+{
+  return rate_limit.load(std::memory_order_relaxed);
+}
+
+void
+logging::set_forward(bool fwd)
+{
+  forward.store(fwd, std::memory_order_relaxed);
+}
+
+void
+logging::set_ring_buffer(size_t nrecords)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  ring.assign(nrecords, record_t());
+  ring_head = 0;
+  ring_count = 0;
+  recording.store(nrecords > 0, std::memory_order_relaxed);
+}
+
+void
+logging::dump_ring_buffer(const std::string &filename)
+{
+  std::ofstream file;
+  if (!filename.empty()) {
+    file.open(filename);
+    if (!file.is_open()) {
+      throw std::runtime_error("logging: could not open " + filename);
+    }
+  }
+  std::ostream &os = filename.empty() ? std::cerr : file;
+
+  std::lock_guard<std::mutex> lock(mtx);
+  char line[768];
+  for (size_t i = 0; i < ring_count; i++) {
+    const size_t idx = (ring_head + ring.size() - ring_count + i)
+                       % ring.size();
+    format_record(line, sizeof(line), ring[idx]);
+    os << line << std::endl;
+  }
+}
+
+void
+logging::write(log_level_t level, const char *file, int line,
+               uint64_t suppressed, const char *fmt, ...)
+{
+  const bool record = recording.load(std::memory_order_relaxed);
+  const bool fwd = forward.load(std::memory_order_relaxed);
+  if (!record && !fwd) {
+    return;
+  }
+  file = strip_path(file);
+
+  va_list args;
+  va_start(args, fmt);
+  if (record) {
+    record_t r;
+    r.timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch()).count();
+    r.file = file;
+    r.fmt = fmt;
+    r.line = line;
+    r.level = level;
+    va_list rec_args;
+    va_copy(rec_args, args);
+    encode_args(r, fmt, rec_args);
+    va_end(rec_args);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!ring.empty()) {
+      ring[ring_head] = r;
+      ring_head = (ring_head + 1) % ring.size();
+      ring_count = std::min(ring_count + 1, ring.size());
+    }
+  }
+  if (!fwd) {
+    va_end(args);
+    return;
+  }
+
+  char msg[512];
+  const int n = vsnprintf(msg, sizeof(msg), fmt, args);
+  va_end(args);
+  std::string text = std::string(file) + ":" + std::to_string(line) + ": "
+                     + msg;
+  if (n >= static_cast<int>(sizeof(msg))) {
+    text += " [truncated]";
+  }
+  if (suppressed) {
+    text += " (" + std::to_string(suppressed) + " similar messages suppressed)";
+  }
+  std::lock_guard<std::mutex> lock(mtx);
+  gr::logger &l = gr_logger();
+  switch (level) {
+  case LOG_LEVEL_TRACE:
+    l.trace("{:s}", text);
+    break;
+  case LOG_LEVEL_DEBUG:
+    l.debug("{:s}", text);
+    break;
+  case LOG_LEVEL_INFO:
+    l.info("{:s}", text);
+    break;
+  case LOG_LEVEL_WARN:
+    l.warn("{:s}", text);
+    break;
+  default:
+    l.error("{:s}", text);
+    break;
+  }
+}
+
+} // namespace leo
+} // namespace gr
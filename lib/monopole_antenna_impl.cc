@@ -47,6 +47,7 @@ monopole_antenna_impl::monopole_antenna_impl(antenna_t type,
     double pointing_error) :
   generic_antenna(MONOPOLE, frequency, polarization, pointing_error)
 {
+  update_gain_rolloff();
   LEO_DEBUG("MONOPOLE");
   LEO_DEBUG("Maximum Gain: %f", get_gain());
   LEO_DEBUG("Beamwidth: %f", get_beamwidth());
@@ -65,7 +66,13 @@ monopole_antenna_impl::get_gain()
 double
 monopole_antenna_impl::get_gain_rolloff()
 {
-  double error_deg = utils::radians_to_degrees(d_pointing_error);
+  return d_gain_rolloff;
+}
+
+double
+monopole_antenna_impl::get_gain_rolloff(double theta, double phi)
+{
+  double error_deg = utils::radians_to_degrees(theta);
   if (error_deg < 100) {
     if (!error_deg) {
       return 162.1;
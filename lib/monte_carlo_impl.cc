@@ -0,0 +1,300 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "monte_carlo_impl.h"
+#include "utils/parallel_for.h"
+#include "utils/tle.h"
+#include <gnuradio/leo/log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* The histograms of the link margin and the outage fraction */
+const double MARGIN_LO = -200;
+const double MARGIN_HI = 200;
+const size_t MARGIN_BINS = 8000;
+const size_t OUTAGE_BINS = 1000;
+
+/*
+ * The realizations are accumulated in blocks of consecutive realizations,
+ * independent of the number of threads
+ */
+const size_t REALIZATIONS_PER_BLOCK = 16;
+
+bool
+is_leap(int year)
+{
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+} // namespace
+
+std::string
+shift_tle_epoch(const std::string &tle_1, double seconds)
+{
+  if (tle_1.size() < 69 || tle_1[0] != '1') {
+    throw std::invalid_argument("shift_tle_epoch: Invalid TLE line 1");
+  }
+
+  /* Columns 19-20 hold the year and 21-32 the fractional day of the year */
+  const int yy = std::stoi(tle_1.substr(18, 2));
+  int year = yy < 57 ? 2000 + yy : 1900 + yy;
+  double day = std::stod(tle_1.substr(20, 12)) + seconds / 86400.0;
+  while (day < 1) {
+    year--;
+    day += is_leap(year) ? 366 : 365;
+  }
+  while (day >= (is_leap(year) ? 367 : 366)) {
+    day -= is_leap(year) ? 366 : 365;
+    year++;
+  }
+
+  char epoch[16];
+  snprintf(epoch, sizeof(epoch), "%02d%012.8f", year % 100, day);
+  std::string line(tle_1);
+  line.replace(18, 14, epoch);
+  line[68] = static_cast<char>('0' + utils::tle_checksum(line));
+  return line;
+}
+
+monte_carlo::monte_carlo_sptr
+monte_carlo::make(const scenario_t &scenario,
+                  const perturbation_t &perturbation, size_t realizations,
+                  double outage_threshold_db, unsigned int seed)
+{
+  return monte_carlo::monte_carlo_sptr(
+           new monte_carlo_impl(scenario, perturbation, realizations,
+                                outage_threshold_db, seed));
+}
+
+monte_carlo_impl::accumulators::accumulators() :
+  margin(MARGIN_LO, MARGIN_HI, MARGIN_BINS),
+  min_margin(MARGIN_LO, MARGIN_HI, MARGIN_BINS),
+  outage(0, 1, OUTAGE_BINS),
+  passes(0),
+  outages(0)
+{
+}
+
+void
+monte_carlo_impl::accumulators::merge(const accumulators &other)
+{
+  margin.merge(other.margin);
+  min_margin.merge(other.min_margin);
+  outage.merge(other.outage);
+  passes += other.passes;
+  outages += other.outages;
+}
+
+monte_carlo_impl::monte_carlo_impl(const scenario_t &scenario,
+                                   const perturbation_t &perturbation,
+                                   size_t realizations,
+                                   double outage_threshold_db,
+                                   unsigned int seed) :
+  d_scenario(scenario),
+  d_perturbation(perturbation),
+  d_realizations(realizations),
+  d_outage_threshold_db(outage_threshold_db),
+  d_seed(seed)
+{
+  if (realizations == 0) {
+    throw std::invalid_argument("monte_carlo: No realizations");
+  }
+  if (perturbation.rainfall_rate_sigma < 0
+      || perturbation.pointing_error_sigma < 0
+      || perturbation.tle_epoch_sigma < 0) {
+    throw std::invalid_argument("monte_carlo: Negative perturbation spread");
+  }
+  if (!(scenario.time_step_us > 0)) {
+    throw std::invalid_argument("monte_carlo: Invalid time step");
+  }
+}
+
+monte_carlo_impl::~monte_carlo_impl()
+{
+}
+
+scenario_t
+monte_carlo_impl::perturb(size_t realization) const
+{
+  std::seed_seq seq{d_seed, static_cast<unsigned int>(realization),
+                    static_cast<unsigned int>(uint64_t(realization) >> 32)};
+  std::mt19937_64 rng(seq);
+  std::normal_distribution<double> normal;
+  /* Seed 0 selects a time based seed, so it is excluded */
+  std::uniform_int_distribution<unsigned int> seed_dist(1,
+      std::numeric_limits<unsigned int>::max());
+
+  /* All the deviates are drawn, so each parameter has a fixed stream */
+  const double rain = normal(rng);
+  const double pointing = normal(rng);
+  const double epoch = normal(rng);
+
+  scenario_t s(d_scenario);
+  const double sr = d_perturbation.rainfall_rate_sigma;
+  s.rainfall_rate *= std::exp(sr * rain - sr * sr / 2);
+  s.gs_antenna.pointing_error +=
+    std::abs(d_perturbation.pointing_error_sigma * pointing);
+  if (d_perturbation.tle_epoch_sigma > 0) {
+    s.tle_1 = shift_tle_epoch(s.tle_1, d_perturbation.tle_epoch_sigma * epoch);
+  }
+  s.seed = seed_dist(rng);
+  return s;
+}
+
+void
+monte_carlo_impl::simulate(size_t realization, accumulators &acc) const
+{
+  const scenario_t s = perturb(realization);
+  generic_model::generic_model_sptr model = scenario::make_model(s);
+  tracker::tracker_sptr trk = model->get_tracker();
+
+  size_t visible = 0;
+  size_t out = 0;
+  double min_margin = std::numeric_limits<double>::infinity();
+  while (!trk->is_observation_over()) {
+    const model_state_t state = model->get_state();
+    if (state.aos) {
+      visible++;
+      acc.margin.add(state.link_margin_db);
+      min_margin = std::min(min_margin, state.link_margin_db);
+      if (state.link_margin_db < d_outage_threshold_db) {
+        out++;
+      }
+    }
+    model->advance_time(s.time_step_us);
+  }
+
+  if (visible) {
+    acc.passes++;
+    acc.min_margin.add(min_margin);
+    acc.outage.add(static_cast<double>(out) / visible);
+    if (out) {
+      acc.outages++;
+    }
+  }
+}
+
+void
+monte_carlo_impl::run(size_t nthreads)
+{
+  const size_t blocks = (d_realizations + REALIZATIONS_PER_BLOCK - 1)
+                        / REALIZATIONS_PER_BLOCK;
+  const size_t workers = utils::worker_count(blocks, nthreads);
+
+  /*
+   * The blocks are merged in their order, as soon as all the previous ones
+   * are merged, so the rounding of the merged means and variances does not
+   * depend on the number of threads or on their scheduling. Only the blocks
+   * that finish ahead of a slower one are kept in the meantime.
+   */
+  std::mutex lock;
+  std::map<size_t, accumulators> pending;
+  size_t next_block = 0;
+  d_results = accumulators();
+  utils::parallel_for(blocks, workers, [&](size_t b, size_t) {
+    accumulators acc;
+    const size_t end = std::min(d_realizations,
+                                (b + 1) * REALIZATIONS_PER_BLOCK);
+    for (size_t i = b * REALIZATIONS_PER_BLOCK; i < end; i++) {
+      simulate(i, acc);
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    pending.emplace(b, std::move(acc));
+    std::map<size_t, accumulators>::iterator it;
+    while ((it = pending.find(next_block)) != pending.end()) {
+      d_results.merge(it->second);
+      pending.erase(it);
+      next_block++;
+    }
+  });
+
+  LEO_DEBUG("monte_carlo: %zu realizations, %zu passes, %zu with outage",
+            d_realizations, d_results.passes, d_results.outages);
+}
+
+size_t
+monte_carlo_impl::get_passes() const
+{
+  return d_results.passes;
+}
+
+link_statistics_t
+monte_carlo_impl::summarize(const utils::running_stats &stats,
+                            const std::vector<double> &percentiles)
+{
+  link_statistics_t res;
+  res.count = stats.count();
+  res.mean = stats.mean();
+  res.stddev = std::sqrt(stats.variance());
+  res.min = stats.min();
+  res.max = stats.max();
+  for (double p : percentiles) {
+    res.percentiles.push_back(stats.percentile(p));
+  }
+  return res;
+}
+
+link_statistics_t
+monte_carlo_impl::get_link_margin(const std::vector<double> &percentiles)
+const
+{
+  return summarize(d_results.margin, percentiles);
+}
+
+link_statistics_t
+monte_carlo_impl::get_min_link_margin(const std::vector<double> &percentiles)
+const
+{
+  return summarize(d_results.min_margin, percentiles);
+}
+
+link_statistics_t
+monte_carlo_impl::get_outage_fraction(const std::vector<double> &percentiles)
+const
+{
+  return summarize(d_results.outage, percentiles);
+}
+
+double
+monte_carlo_impl::get_outage_probability() const
+{
+  if (d_results.passes == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(d_results.outages) / d_results.passes;
+}
+
+} // namespace leo
+} // namespace gr
@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_MONTE_CARLO_IMPL_H
+#define INCLUDED_LEO_MONTE_CARLO_IMPL_H
+
+#include <gnuradio/leo/monte_carlo.h>
+#include "utils/running_stats.h"
+#include <cstdint>
+#include <random>
+
+namespace gr {
+namespace leo {
+
+class monte_carlo_impl : public monte_carlo {
+
+public:
+  monte_carlo_impl(const scenario_t &scenario,
+                   const perturbation_t &perturbation, size_t realizations,
+                   double outage_threshold_db, unsigned int seed);
+
+  ~monte_carlo_impl();
+
+  void
+  run(size_t nthreads);
+
+  size_t
+  get_passes() const;
+
+  link_statistics_t
+  get_link_margin(const std::vector<double> &percentiles) const;
+
+  link_statistics_t
+  get_min_link_margin(const std::vector<double> &percentiles) const;
+
+  link_statistics_t
+  get_outage_fraction(const std::vector<double> &percentiles) const;
+
+  double
+  get_outage_probability() const;
+
+  /*!
+   * \brief The scenario of a realization
+   */
+  scenario_t
+  perturb(size_t realization) const;
+
+private:
+  /*!
+   * \brief The statistics of a set of realizations. Each thread keeps its
+   * own, which are merged when all the realizations have finished.
+   */
+  struct accumulators {
+    utils::running_stats margin;
+    utils::running_stats min_margin;
+    utils::running_stats outage;
+    size_t passes;
+    size_t outages;
+
+    accumulators();
+
+    void
+    merge(const accumulators &other);
+  };
+
+  const scenario_t d_scenario;
+  const perturbation_t d_perturbation;
+  const size_t d_realizations;
+  const double d_outage_threshold_db;
+  const unsigned int d_seed;
+  accumulators d_results;
+
+  void
+  simulate(size_t realization, accumulators &acc) const;
+
+  static link_statistics_t
+  summarize(const utils::running_stats &stats,
+            const std::vector<double> &percentiles);
+};
+
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_MONTE_CARLO_IMPL_H */
@@ -49,9 +49,14 @@ parabolic_reflector_antenna_impl::parabolic_reflector_antenna_impl(
   double aperture_efficiency) :
   generic_antenna(PARABOLIC_REFLECTOR, frequency, polarization, pointing_error),
   d_diameter(diameter),
-  d_aperture_efficiency(aperture_efficiency)
-
+  d_aperture_efficiency(aperture_efficiency),
+  d_gain(20.4 + 20 * std::log10(diameter)
+         + 20 * std::log10(frequency / 1e6 / 1000)
+         + 10 * std::log10(aperture_efficiency / 100)),
+  d_beamwidth(21 / (diameter * (frequency / 1e6 / 1000))),
+  d_rolloff_scale(79.76 / d_beamwidth)
 {
+  update_gain_rolloff();
   LEO_DEBUG("Parabolic Reflector");
   LEO_DEBUG("Maximum Gain: %f", get_gain());
   LEO_DEBUG("Beamwidth: %f", get_beamwidth());
@@ -64,17 +69,21 @@ parabolic_reflector_antenna_impl::~parabolic_reflector_antenna_impl()
 double
 parabolic_reflector_antenna_impl::get_gain()
 {
-  return 20.4 + 20 * std::log10(d_diameter)
-         + 20 * std::log10(d_frequency / 1e6 / 1000)
-         + 10 * std::log10(d_aperture_efficiency / 100);
+  return d_gain;
 }
 
 
 double
 parabolic_reflector_antenna_impl::get_gain_rolloff()
 {
-  double error_deg = utils::radians_to_degrees(d_pointing_error);
-  double tmp = 2 * (error_deg * (79.76 / get_beamwidth()));
+  return d_gain_rolloff;
+}
+
+double
+parabolic_reflector_antenna_impl::get_gain_rolloff(double theta, double phi)
+{
+  double error_deg = utils::radians_to_degrees(theta);
+  double tmp = 2 * error_deg * d_rolloff_scale;
   if (!error_deg) {
     return 0;
   }
@@ -87,7 +96,7 @@ parabolic_reflector_antenna_impl::get_gain_rolloff()
 double
 parabolic_reflector_antenna_impl::get_beamwidth()
 {
-  return 21 / (d_diameter * (d_frequency / 1e6 / 1000));
+  return d_beamwidth;
 }
 
 } /* namespace antenna */
@@ -81,10 +81,16 @@ public:
   double
   get_gain_rolloff();
 
+  double
+  get_gain_rolloff(double theta, double phi);
+
 private:
 
   double d_diameter;
   double d_aperture_efficiency;
+  double d_gain;
+  double d_beamwidth;
+  double d_rolloff_scale;
 
 };
 } // namespace antenna
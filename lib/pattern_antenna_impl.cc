@@ -0,0 +1,102 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pattern_antenna_impl.h"
+#include <gnuradio/leo/log.h>
+#include <gnuradio/leo/utils/helper.h>
+#include <stdexcept>
+
+namespace gr {
+namespace leo {
+namespace antenna {
+
+generic_antenna::generic_antenna_sptr
+pattern_antenna::make(antenna_t type, double frequency,
+                      polarization_t polarization, double pointing_error,
+                      const std::string &filename)
+{
+  if (type != PATTERN) {
+    throw std::invalid_argument("Invalid pattern antenna type");
+  }
+  return generic_antenna::generic_antenna_sptr(
+           new pattern_antenna_impl(type, frequency, polarization,
+                                    pointing_error, filename));
+}
+
+pattern_antenna_impl::pattern_antenna_impl(antenna_t type, double frequency,
+    polarization_t polarization,
+    double pointing_error,
+    const std::string &filename) :
+  generic_antenna(type, frequency, polarization, pointing_error),
+  d_pattern(utils::itu_grid::load_table(filename)),
+  d_gain(d_pattern->max()),
+  d_beamwidth(360)
+{
+  /* The first half power crossing of the zero azimuth cut */
+  const double boresight = d_pattern->value(0, 0);
+  for (double theta = 0; theta <= 180; theta += 0.05) {
+    if (d_pattern->value(theta, 0) < boresight - 3) {
+      d_beamwidth = 2 * theta;
+      break;
+    }
+  }
+
+  update_gain_rolloff();
+  LEO_DEBUG("PATTERN");
+  LEO_DEBUG("Maximum Gain: %f", get_gain());
+  LEO_DEBUG("Beamwidth: %f", get_beamwidth());
+}
+
+pattern_antenna_impl::~pattern_antenna_impl()
+{
+}
+
+double
+pattern_antenna_impl::get_gain()
+{
+  return d_gain;
+}
+
+double
+pattern_antenna_impl::get_gain_rolloff()
+{
+  return d_gain_rolloff;
+}
+
+double
+pattern_antenna_impl::get_gain_rolloff(double theta, double phi)
+{
+  return d_gain - d_pattern->value(utils::radians_to_degrees(theta),
+                                   utils::radians_to_degrees(phi));
+}
+
+double
+pattern_antenna_impl::get_beamwidth()
+{
+  return d_beamwidth;
+}
+
+} /* namespace antenna */
+} /* namespace leo */
+} /* namespace gr */
@@ -0,0 +1,81 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_PATTERN_ANTENNA_IMPL_H
+#define INCLUDED_LEO_PATTERN_ANTENNA_IMPL_H
+
+#include "../include/gnuradio/leo/pattern_antenna.h"
+#include "utils/itu_grid.h"
+
+namespace gr {
+namespace leo {
+namespace antenna {
+
+/*!
+ * \brief Class that represents an antenna with a tabulated radiation
+ * pattern.
+ * \ingroup antenna
+ */
+class LEO_API pattern_antenna_impl : public pattern_antenna {
+
+public:
+  pattern_antenna_impl(antenna_t type, double frequency,
+                       polarization_t polarization, double pointing_error,
+                       const std::string &filename);
+
+  ~pattern_antenna_impl();
+
+  /*!
+   * \brief Get the peak gain of the pattern.
+   * \return the gain in dBi.
+   */
+  double
+  get_gain();
+
+  /*!
+   * \brief Get the gain roll-off at the pointing error of the antenna,
+   * for the zero azimuth around the boresight.
+   * \return the gain roll-off in dB.
+   */
+  double
+  get_gain_rolloff();
+
+  double
+  get_gain_rolloff(double theta, double phi);
+
+  /*!
+   * \brief Get the half power beamwidth of the pattern, at the zero
+   * azimuth around the boresight.
+   * \return the beamwidth in degrees.
+   */
+  double
+  get_beamwidth();
+
+private:
+  utils::itu_grid::sptr d_pattern;
+  double d_gain;
+  double d_beamwidth;
+};
+
+} // namespace antenna
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_PATTERN_ANTENNA_IMPL_H */
@@ -23,10 +23,11 @@
 #endif
 
 #include "precipitation_itu_impl.h"
+#include "utils/itu_grid.h"
+#include <algorithm>
 #include <cmath>
 #include <filesystem>
 #include <string>
-#include <gnuradio/constants.h>
 #include <gnuradio/leo/utils/helper.h>
 #include <gnuradio/leo/log.h>
 
@@ -37,31 +38,90 @@ namespace attenuation {
 generic_attenuation::generic_attenuation_sptr
 precipitation_itu::make(double rainfall_rate, double tracker_lontitude,
                         double tracker_latitude, double tracker_altitude,
-                        impairment_enum_t mode)
+                        impairment_enum_t mode, double rain_probability,
+                        double fade_dynamics, unsigned int seed,
+                        bool topographic_altitude)
 {
   return generic_attenuation::generic_attenuation_sptr(
            new precipitation_itu_impl(rainfall_rate, tracker_lontitude,
                                       tracker_latitude, tracker_altitude,
-                                      mode));
+                                      mode, rain_probability, fade_dynamics,
+                                      seed, topographic_altitude));
+}
+
+/*
+ * The lower limit of the exceedance probabilities in percent, that the
+ * P.618 scaling supports
+ */
+static const double MIN_EXCEEDANCE = 0.001;
+
+/* Exceedance probability in percent of a standard Gaussian */
+static double
+exceedance(double x)
+{
+  return 50 * std::erfc(x / std::sqrt(2.0));
+}
+
+/* The standard Gaussian value exceeded with probability p percent */
+static double
+inverse_exceedance(double p)
+{
+  double lo = -10;
+  double hi = 10;
+  for (size_t i = 0; i < 100; i++) {
+    const double mid = (lo + hi) / 2;
+    if (exceedance(mid) > p) {
+      lo = mid;
+    }
+    else {
+      hi = mid;
+    }
+  }
+  return (lo + hi) / 2;
 }
 
 precipitation_itu_impl::precipitation_itu_impl(
   double rainfall_rate, double tracker_lontitude, double tracker_latitude,
-  double tracker_altitude, impairment_enum_t mode) :
+  double tracker_altitude, impairment_enum_t mode, double rain_probability,
+  double fade_dynamics, unsigned int seed, bool topographic_altitude) :
   generic_attenuation(),
   d_rainfall_rate(rainfall_rate),
   d_tracker_lontitude(tracker_lontitude),
   d_tracker_latitude(tracker_latitude),
   d_tracker_altitude(tracker_altitude),
   d_mode(mode),
-  d_hs(tracker_altitude)
+  d_hs(tracker_altitude),
+  d_cached_frequency(-1),
+  d_k_h(0),
+  d_k_v(0),
+  d_alpha_h(0),
+  d_alpha_v(0),
+  d_rain_probability(rain_probability),
+  d_fade_dynamics(fade_dynamics),
+  d_rng(seed),
+  d_fade_x(0),
+  d_fade_time(0),
+  d_fade_started(false),
+  d_fade_x_min(0),
+  d_fade_x_max(0),
+  d_fade_frequency(-1),
+  d_fade_polarization(RHCP)
 {
+  if (d_mode == PRECIPITATION_STATISTICAL) {
+    if (!(rain_probability > MIN_EXCEEDANCE && rain_probability <= 5)) {
+      throw std::invalid_argument(
+        "precipitation_itu: the rain probability must be in (0.001, 5] %");
+    }
+    if (!(fade_dynamics > 0)) {
+      throw std::invalid_argument(
+        "precipitation_itu: the fade dynamics must be positive");
+    }
+    d_fade_x_min = inverse_exceedance(d_rain_probability);
+    d_fade_x_max = inverse_exceedance(MIN_EXCEEDANCE);
+    d_fade_table.resize(FADE_ELEVATIONS * FADE_STEPS);
+  }
 
-  /**
-   * TODO: Extract info about Height above sea-level d_h ITU data
-   */
-  std::filesystem::path gr_prefix = gr::prefix();
-  std::filesystem::path data_path = (gr_prefix / GR_LEO_REL_DATA_PATH).lexically_normal();
+  const std::filesystem::path data_path = utils::data_path();
 
   d_isotherm_height = utils::parser_ITU_heatmap(
                         (data_path / "ITU_RREC_P839" / "Lat.txt").string(),
@@ -69,10 +129,10 @@ precipitation_itu_impl::precipitation_itu_impl(
                         (data_path / "ITU_RREC_P839" / "ITU_R-REC-P.839-4.txt").string(),
                         d_tracker_lontitude, d_tracker_latitude);
 
-  /**
-   * TODO: Parse ITU data P.1511 to extract height above sea level
-   */
-
+  if (topographic_altitude) {
+    d_hs = utils::topographic_altitude(d_tracker_latitude,
+                                       d_tracker_lontitude);
+  }
 
   if (d_mode == PRECIPITATION_ITU) {
     d_rainfall_rate = utils::parser_ITU_heatmap(
@@ -89,6 +149,130 @@ precipitation_itu_impl::~precipitation_itu_impl()
 
 double
 precipitation_itu_impl::get_attenuation()
+{
+  double res;
+  get_attenuation_batch(&res, &elevation_angle, 1);
+  return res;
+}
+
+/* The rain fade advances with every evaluation */
+bool
+precipitation_itu_impl::is_reentrant() const
+{
+  return d_mode != PRECIPITATION_STATISTICAL;
+}
+
+void
+precipitation_itu_impl::get_attenuation_batch(double *out,
+    const double *elevation, size_t n)
+{
+  if (frequency != d_cached_frequency) {
+    update_frequency();
+  }
+  if (d_mode == PRECIPITATION_STATISTICAL) {
+    if (frequency != d_fade_frequency || polarization != d_fade_polarization) {
+      update_fade_table();
+    }
+    advance_fade();
+    for (size_t i = 0; i < n; i++) {
+      out[i] = fade_attenuation(elevation[i]);
+    }
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    out[i] = attenuation_at(elevation[i]);
+  }
+}
+
+/*
+ * Tabulates the attenuation exceeded for each fade level, scaling the
+ * attenuation exceeded for 0.01% of the time with the step 10 of the P.618
+ * method
+ */
+void
+precipitation_itu_impl::update_fade_table()
+{
+  const double abs_lat = std::abs(d_tracker_latitude);
+  const double dx = (d_fade_x_max - d_fade_x_min) / (FADE_STEPS - 1);
+
+  for (size_t i = 0; i < FADE_ELEVATIONS; i++) {
+    const double elev = utils::degrees_to_radians(i);
+    const double sin_elev = std::sin(elev);
+    const double a001 = attenuation_at(elev);
+    double *row = &d_fade_table[i * FADE_STEPS];
+
+    for (size_t j = 0; j < FADE_STEPS; j++) {
+      const double p = exceedance(d_fade_x_min + j * dx);
+      double beta;
+      if (a001 <= 0) {
+        row[j] = 0;
+        continue;
+      }
+      if (p >= 1 || abs_lat >= 36) {
+        beta = 0;
+      }
+      else if (i >= 25) {
+        beta = -0.005 * (abs_lat - 36);
+      }
+      else {
+        beta = -0.005 * (abs_lat - 36) + 1.8 - 4.25 * sin_elev;
+      }
+      row[j] = a001 * std::pow(p / 0.01,
+                               -(0.655 + 0.033 * std::log(p)
+                                 - 0.045 * std::log(a001)
+                                 - beta * (1 - p) * sin_elev));
+    }
+  }
+  d_fade_frequency = frequency;
+  d_fade_polarization = polarization;
+}
+
+/*
+ * Maseng-Bakken synthesizer. The Gaussian fade variable is a first order
+ * Gauss-Markov process, so it is advanced exactly for any time step. A
+ * backwards step restarts the process from its stationary distribution.
+ */
+void
+precipitation_itu_impl::advance_fade()
+{
+  const double dt = time - d_fade_time;
+  if (!d_fade_started || dt < 0) {
+    d_fade_x = d_rng.gasdev();
+    d_fade_started = true;
+  }
+  else if (dt > 0) {
+    const double rho = std::exp(-d_fade_dynamics * dt);
+    d_fade_x = rho * d_fade_x + std::sqrt(1 - rho * rho) * d_rng.gasdev();
+  }
+  d_fade_time = time;
+}
+
+double
+precipitation_itu_impl::fade_attenuation(double elevation) const
+{
+  /* No rain for this fade level */
+  if (d_fade_x < d_fade_x_min) {
+    return 0;
+  }
+
+  const double e = std::min(std::max(utils::radians_to_degrees(elevation),
+                                     0.0), FADE_ELEVATIONS - 1.0);
+  const size_t i = std::min(static_cast<size_t>(e), FADE_ELEVATIONS - 2);
+  const double we = e - i;
+
+  const double x = (std::min(d_fade_x, d_fade_x_max) - d_fade_x_min)
+                   / (d_fade_x_max - d_fade_x_min) * (FADE_STEPS - 1);
+  const size_t j = std::min(static_cast<size_t>(x), FADE_STEPS - 2);
+  const double wx = x - j;
+
+  const double *r0 = &d_fade_table[i * FADE_STEPS + j];
+  const double *r1 = r0 + FADE_STEPS;
+  return (1 - we) * ((1 - wx) * r0[0] + wx * r0[1])
+         + we * ((1 - wx) * r1[0] + wx * r1[1]);
+}
+
+double
+precipitation_itu_impl::attenuation_at(double elevation)
 {
   double Ls;
   double LG;
@@ -101,101 +285,97 @@ precipitation_itu_impl::get_attenuation()
     return 0;
   }
 
-  if (utils::radians_to_degrees(elevation_angle) < 5) {
+  if (utils::radians_to_degrees(elevation) < 5) {
     Ls = 2 * height_tmp
          / (std::pow(
-              (std::pow(std::sin(elevation_angle), 2)
+              (std::pow(std::sin(elevation), 2)
                + (2 * height_tmp) / EARTH_RADIUS),
-              0.5) + std::sin(elevation_angle));
+              0.5) + std::sin(elevation));
   }
   else {
-    Ls = height_tmp / std::cos(elevation_angle);
+    Ls = height_tmp / std::cos(elevation);
   }
 
-  LG = Ls * std::cos(elevation_angle);
-  gammar = get_specific_attenuation();
-  LE = calculate_effective_path_len(LG, d_isotherm_height, gammar);
+  LG = Ls * std::cos(elevation);
+  gammar = get_specific_attenuation(elevation);
+  LE = calculate_effective_path_len(LG, d_isotherm_height, gammar, elevation);
   Aaverage = gammar * LE;
 
   return Aaverage;
 }
 
-double
-precipitation_itu_impl::get_specific_attenuation()
+/*
+ * The k and alpha coefficients of P.838 depend only on the frequency, so
+ * the Gaussian series are evaluated once per frequency
+ */
+void
+precipitation_itu_impl::update_frequency()
 {
-  double gammar = 0;
-  double k = 0;
+  const double logf = std::log10(frequency);
   double logkh = 0;
   double logkv = 0;
-  double a = 0;
   double av = 0;
   double ah = 0;
-  /**
-   * TODO: Move tilt in generic_attenuation class and
-   * remove constant value
-   */
-  double tilt = 45;
 
   for (size_t j = 0; j < d_kh.size(); j++) {
     logkh += d_kh[j][0]
-             * std::exp(
-               -std::pow((std::log10(frequency) - d_kh[j][1]) / d_kh[j][2],
-                         2));
+             * std::exp(-std::pow((logf - d_kh[j][1]) / d_kh[j][2], 2));
     logkv += d_kv[j][0]
-             * std::exp(
-               -std::pow((std::log10(frequency) - d_kv[j][1]) / d_kv[j][2],
-                         2));
+             * std::exp(-std::pow((logf - d_kv[j][1]) / d_kv[j][2], 2));
     av += d_av[j][0]
-          * std::exp(
-            -std::pow((std::log10(frequency) - d_av[j][1]) / d_av[j][2],
-                      2));
+          * std::exp(-std::pow((logf - d_av[j][1]) / d_av[j][2], 2));
     ah += d_ah[j][0]
-          * std::exp(
-            -std::pow((std::log10(frequency) - d_ah[j][1]) / d_ah[j][2],
-                      2));
+          * std::exp(-std::pow((logf - d_ah[j][1]) / d_ah[j][2], 2));
   }
-  logkh += (d_kh[0][3] * std::log10(frequency) + d_kh[0][4]);
-  logkv += (d_kv[0][3] * std::log10(frequency) + d_kv[0][4]);
+  logkh += (d_kh[0][3] * logf + d_kh[0][4]);
+  logkv += (d_kv[0][3] * logf + d_kv[0][4]);
+
+  av += d_av[4][0] * std::exp(-std::pow((logf - d_av[4][1]) / d_av[4][2], 2));
+  av += d_av[0][3] * logf + d_av[0][4];
 
-  av += d_av[4][0]
-        * std::exp(
-          -std::pow((std::log10(frequency) - d_av[4][1]) / d_av[4][2],
-                    2));
-  av += d_av[0][3] * std::log10(frequency) + d_av[0][4];
+  ah += d_ah[4][0] * std::exp(-std::pow((logf - d_ah[4][1]) / d_ah[4][2], 2));
+  ah += d_ah[0][3] * logf + d_ah[0][4];
+
+  d_k_h = std::pow(10, logkh);
+  d_k_v = std::pow(10, logkv);
+  d_alpha_h = ah;
+  d_alpha_v = av;
+  d_cached_frequency = frequency;
+}
 
-  ah += d_ah[4][0]
-        * std::exp(
-          -std::pow((std::log10(frequency) - d_ah[4][1]) / d_ah[4][2],
-                    2));
-  ah += d_ah[0][3] * std::log10(frequency) + d_ah[0][4];
+double
+precipitation_itu_impl::get_specific_attenuation(double elevation)
+{
+  double k = 0;
+  double a = 0;
+  /**
+   * TODO: Move tilt in generic_attenuation class and
+   * remove constant value
+   */
+  static const double cos_2tilt = std::cos(2 * utils::degrees_to_radians(45));
 
   switch (polarization) {
   case LINEAR_VERTICAL:
-    k = std::pow(10, logkv);
-    a = av;
+    k = d_k_v;
+    a = d_alpha_v;
     break;
   case LINEAR_HORIZONTAL:
-    k = std::pow(10, logkh);
-    a = ah;
+    k = d_k_h;
+    a = d_alpha_h;
     break;
   case LHCP:
-  case RHCP:
-    k = (std::pow(10, logkh) + std::pow(10, logkv)
-         + (std::pow(10, logkh) - std::pow(10, logkv))
-         * std::pow(std::cos(elevation_angle), 2)
-         * std::cos(2 * utils::degrees_to_radians(tilt))) / 2;
-    a = (std::pow(10, logkh) * ah + std::pow(10, logkv) * av
-         + (std::pow(10, logkh) * ah - std::pow(10, logkv) * av)
-         * std::pow(std::cos(elevation_angle), 2)
-         * std::cos(2 * utils::degrees_to_radians(tilt)))
-        / (2 * k);
+  case RHCP: {
+    const double c = std::pow(std::cos(elevation), 2) * cos_2tilt;
+    k = (d_k_h + d_k_v + (d_k_h - d_k_v) * c) / 2;
+    a = (d_k_h * d_alpha_h + d_k_v * d_alpha_v
+         + (d_k_h * d_alpha_h - d_k_v * d_alpha_v) * c) / (2 * k);
     break;
+  }
   default:
     throw std::runtime_error("Invalid antenna polarization!");
   }
 
-  gammar = k * std::pow(d_rainfall_rate, a);
-  return gammar;
+  return k * std::pow(d_rainfall_rate, a);
 }
 
 double
@@ -209,7 +389,7 @@ precipitation_itu_impl::get_horizontal_reduction_factor(
 
 double
 precipitation_itu_impl::calculate_effective_path_len(double LG, double hr,
-    double gammar)
+    double gammar, double elevation)
 {
   double zeta;
   double hrf;
@@ -220,11 +400,11 @@ precipitation_itu_impl::calculate_effective_path_len(double LG, double hr,
   zeta = std::pow(std::tan((hr - d_hs) / (LG * hrf)), -1);
 
   if (utils::radians_to_degrees(zeta)
-      > utils::radians_to_degrees(elevation_angle)) {
-    LR = LG * hrf / std::cos(elevation_angle);
+      > utils::radians_to_degrees(elevation)) {
+    LR = LG * hrf / std::cos(elevation);
   }
   else {
-    LR = (hr - d_hs) / std::sin(elevation_angle);
+    LR = (hr - d_hs) / std::sin(elevation);
   }
 
   if (d_tracker_latitude > 36) {
@@ -237,8 +417,8 @@ precipitation_itu_impl::calculate_effective_path_len(double LG, double hr,
   return LR
          * (1
             / (1
-               + std::sqrt(std::sin(elevation_angle))
-               * (31 * (1 - std::exp(-elevation_angle / (1 + x)))
+               + std::sqrt(std::sin(elevation))
+               * (31 * (1 - std::exp(-elevation / (1 + x)))
                   * (std::sqrt(LR * gammar) / std::pow(frequency, 2))
                   - 0.45)));
 }
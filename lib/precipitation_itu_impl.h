@@ -22,6 +22,7 @@
 #define INCLUDED_LEO_PRECIPITATION_ITU_IMPL_H
 
 #include <vector>
+#include <gnuradio/random.h>
 #include "../include/gnuradio/leo/precipitation_itu.h"
 
 namespace gr {
@@ -33,13 +34,24 @@ class LEO_API precipitation_itu_impl : public precipitation_itu {
 public:
   precipitation_itu_impl(double rainfall_rate, double tracker_lontitude,
                          double tracker_latitude, double tracker_altitude,
-                         impairment_enum_t mode);
+                         impairment_enum_t mode, double rain_probability,
+                         double fade_dynamics, unsigned int seed,
+                         bool topographic_altitude);
 
   ~precipitation_itu_impl();
 
   double
   get_attenuation();
 
+  using generic_attenuation::get_attenuation_batch;
+
+  void
+  get_attenuation_batch(double *out, const double *elevation, size_t n);
+
+protected:
+  bool
+  is_reentrant() const override;
+
 private:
 
   double d_rainfall_rate;
@@ -50,6 +62,35 @@ private:
   double d_isotherm_height;
   impairment_enum_t d_mode;
 
+  /* The P.838 coefficients, valid for d_cached_frequency */
+  double d_cached_frequency;
+  double d_k_h;
+  double d_k_v;
+  double d_alpha_h;
+  double d_alpha_v;
+
+  /*
+   * The rain fade synthesizer of the PRECIPITATION_STATISTICAL mode. The
+   * attenuation table has FADE_ELEVATIONS rows, one per degree of elevation,
+   * and FADE_STEPS columns, uniformly spaced in the Gaussian fade variable
+   * between d_fade_x_min and d_fade_x_max. It is valid for
+   * d_fade_frequency and d_fade_polarization.
+   */
+  static const size_t FADE_ELEVATIONS = 91;
+  static const size_t FADE_STEPS = 64;
+
+  double d_rain_probability;
+  double d_fade_dynamics;
+  gr::random d_rng;
+  double d_fade_x;
+  double d_fade_time;
+  bool d_fade_started;
+  double d_fade_x_min;
+  double d_fade_x_max;
+  double d_fade_frequency;
+  polarization_t d_fade_polarization;
+  std::vector<double> d_fade_table;
+
   /**
    * Coefficient kH
    * Rec. ITU-R P.838-3
@@ -77,14 +118,30 @@ private:
   double
   get_zero_degree_isotherm_height(double lat, double lon);
 
+  void
+  update_frequency();
+
+  double
+  attenuation_at(double elevation);
+
+  void
+  update_fade_table();
+
+  void
+  advance_fade();
+
+  double
+  fade_attenuation(double elevation) const;
+
   double
-  get_specific_attenuation();
+  get_specific_attenuation(double elevation);
 
   double
   get_horizontal_reduction_factor(double LG, double specific_attenuation);
 
   double
-  calculate_effective_path_len(double LG, double hr, double gammar);
+  calculate_effective_path_len(double LG, double hr, double gammar,
+                               double elevation);
 
 };
 
@@ -0,0 +1,286 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Validates the cached gain roll-off of the antennas, the tabulated
+ * radiation pattern antenna against the analytic pattern it is built from,
+ * and the geometric antenna pointing loss against the nadir angle of the
+ * satellite.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/leo/antenna_pointing_loss.h>
+#include <gnuradio/leo/custom_antenna.h>
+#include <gnuradio/leo/dipole_antenna.h>
+#include <gnuradio/leo/helix_antenna.h>
+#include <gnuradio/leo/monopole_antenna.h>
+#include <gnuradio/leo/parabolic_reflector_antenna.h>
+#include <gnuradio/leo/pattern_antenna.h>
+#include <gnuradio/leo/quadrifilar_helix_antenna.h>
+#include <gnuradio/leo/yagi_antenna.h>
+#include <gnuradio/leo/utils/helper.h>
+#include "qa_scenarios.h"
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* Relative tolerance in percent, the pattern is stored in single precision */
+const double TOLERANCE = 1e-4;
+
+const double freq = 435e6;
+
+/* The peak gain is 10 dBi at the boresight and the pattern is not symmetric */
+double
+analytic_gain(double theta_deg, double phi_deg)
+{
+  return 10 - std::pow(theta_deg / 60, 2)
+         * (12 - std::cos(utils::degrees_to_radians(phi_deg)));
+}
+
+/*
+ * Writes the pattern every 1 degree in theta and 5 degrees in phi, without
+ * the phi = 360 end point
+ */
+std::string
+write_pattern()
+{
+  const std::filesystem::path p = std::filesystem::temp_directory_path()
+                                  / "qa_pattern_antenna.csv";
+  std::ofstream f(p);
+  f << "# theta (deg), phi (deg), gain (dBi)" << std::endl;
+  f.precision(17);
+  for (int phi = 0; phi < 360; phi += 5) {
+    for (int theta = 0; theta <= 180; theta++) {
+      f << theta << "," << phi << "," << analytic_gain(theta, phi) << std::endl;
+    }
+  }
+  return p.string();
+}
+
+generic_antenna::generic_antenna_sptr
+make_pattern_antenna(double pointing_error = 0)
+{
+  static const std::string file = write_pattern();
+  return antenna::pattern_antenna::make(PATTERN, freq, RHCP, pointing_error,
+                                        file);
+}
+
+/* An antenna that relies on the default directional roll-off */
+class beam_antenna : public generic_antenna {
+public:
+  beam_antenna() : generic_antenna(CUSTOM, freq, RHCP, 1)
+  {
+    update_gain_rolloff();
+  }
+
+  double
+  get_gain()
+  {
+    return 10;
+  }
+
+  double
+  get_beamwidth()
+  {
+    return 20;
+  }
+
+  double
+  get_gain_rolloff()
+  {
+    return d_gain_rolloff;
+  }
+
+  using generic_antenna::get_gain_rolloff;
+};
+
+} // namespace
+
+/* Keep the grid caches of the tests out of the user cache directory */
+using qa::temp_cache_dir;
+BOOST_TEST_GLOBAL_FIXTURE(temp_cache_dir);
+
+BOOST_AUTO_TEST_CASE(t_pattern_antenna_grid)
+{
+  generic_antenna::generic_antenna_sptr ant = make_pattern_antenna();
+  BOOST_CHECK_CLOSE(ant->get_gain(), 10, TOLERANCE);
+
+  /* Grid points */
+  for (int theta = 0; theta <= 180; theta += 15) {
+    for (int phi = 0; phi < 360; phi += 45) {
+      BOOST_CHECK_SMALL(ant->get_gain_rolloff(utils::degrees_to_radians(theta),
+                                              utils::degrees_to_radians(phi))
+                        - (10 - analytic_gain(theta, phi)), 1e-5);
+    }
+  }
+
+  /* The pointing error is evaluated at the zero azimuth */
+  ant->set_pointing_error(30);
+  BOOST_CHECK_CLOSE(ant->get_gain_rolloff(), 10 - analytic_gain(30, 0),
+                    TOLERANCE);
+
+  /* Half power beamwidth of the zero azimuth cut */
+  BOOST_CHECK_CLOSE(ant->get_beamwidth(), 2 * 60 * std::sqrt(3.0 / 11),
+                    0.5);
+}
+
+BOOST_AUTO_TEST_CASE(t_pattern_antenna_interpolation)
+{
+  generic_antenna::generic_antenna_sptr ant = make_pattern_antenna();
+
+  /* Bilinear interpolation, across the phi = 360 wrap around */
+  const double theta = 30.25;
+  const double phi = 357.5;
+  const double wt = 0.25;
+  const double wp = 0.5;
+  const double expected = 10
+                          - ((1 - wt) * ((1 - wp) * analytic_gain(30, 355)
+                                         + wp * analytic_gain(30, 0))
+                             + wt * ((1 - wp) * analytic_gain(31, 355)
+                                     + wp * analytic_gain(31, 0)));
+  BOOST_CHECK_CLOSE(ant->get_gain_rolloff(utils::degrees_to_radians(theta),
+                                          utils::degrees_to_radians(phi)),
+                    expected, TOLERANCE);
+  BOOST_CHECK_CLOSE(ant->get_gain_rolloff(utils::degrees_to_radians(theta),
+                                          utils::degrees_to_radians(phi - 360)),
+                    expected, TOLERANCE);
+}
+
+BOOST_AUTO_TEST_CASE(t_pattern_antenna_invalid)
+{
+  const std::filesystem::path p = std::filesystem::temp_directory_path()
+                                  / "qa_pattern_antenna_invalid.csv";
+  {
+    std::ofstream f(p);
+    f << "0,0,10\n0,90,9\n10,0,8\n";
+  }
+  BOOST_CHECK_THROW(antenna::pattern_antenna::make(PATTERN, freq, RHCP, 0,
+                    p.string()), std::runtime_error);
+  BOOST_CHECK_THROW(antenna::pattern_antenna::make(DIPOLE, freq, RHCP, 0,
+                    p.string()), std::invalid_argument);
+}
+
+/*
+ * The roll-off at the pointing error is computed at construction and by
+ * set_pointing_error(), it must always match the roll-off formula
+ */
+BOOST_AUTO_TEST_CASE(t_antenna_rolloff_cache)
+{
+  const std::vector<generic_antenna::generic_antenna_sptr> antennas = {
+    antenna::yagi_antenna::make(YAGI, freq, RHCP, 3, 2.35),
+    antenna::helix_antenna::make(HELIX, freq, RHCP, 3, 10, 0.25, 1.0),
+    antenna::parabolic_reflector_antenna::make(PARABOLIC_REFLECTOR, freq,
+        RHCP, 3, 3, 0.55),
+    antenna::monopole_antenna::make(MONOPOLE, freq, LINEAR_VERTICAL, 3),
+    antenna::dipole_antenna::make(DIPOLE, freq, LINEAR_VERTICAL, 3),
+    antenna::quadrifilar_helix_antenna::make(QUADRIFILAR_HELIX, freq, RHCP, 3,
+        0.5),
+    antenna::custom_antenna::make(CUSTOM, freq, RHCP, 3, 12, 30, -1.5),
+    make_pattern_antenna(3)
+  };
+  for (const generic_antenna::generic_antenna_sptr &ant : antennas) {
+    BOOST_CHECK_EQUAL(ant->get_gain_rolloff(),
+                      ant->get_gain_rolloff(utils::degrees_to_radians(3), 0));
+    for (double error : {
+           0.0, 0.5, 10.0, 45.0
+         }) {
+      ant->set_pointing_error(error);
+      BOOST_CHECK_EQUAL(ant->get_gain_rolloff(),
+                        ant->get_gain_rolloff(utils::degrees_to_radians(error), 0));
+    }
+  }
+
+  /* The yagi gain, beamwidth and roll-off of the ARRL table */
+  generic_antenna::generic_antenna_sptr yagi =
+    antenna::yagi_antenna::make(YAGI, freq, RHCP, 5, 2.35);
+  const double beamwidth = std::sqrt(40000 / std::pow(10, 14.4 / 10));
+  const double x = 2 * 5 * 79.76 / beamwidth;
+  BOOST_CHECK_CLOSE(yagi->get_gain(), 14.4, TOLERANCE);
+  BOOST_CHECK_CLOSE(yagi->get_beamwidth(), beamwidth, TOLERANCE);
+  BOOST_CHECK_CLOSE(yagi->get_gain_rolloff(),
+                    -10 * std::log10(3282.81 * std::pow(std::sin(
+                                       utils::degrees_to_radians(x)), 2) / (x * x)),
+                    TOLERANCE);
+}
+
+/* The symmetric antennas evaluate their roll-off formula at theta */
+BOOST_AUTO_TEST_CASE(t_antenna_rolloff_direction)
+{
+  generic_antenna::generic_antenna_sptr ant =
+    antenna::yagi_antenna::make(YAGI, freq, RHCP, 1, 2.35);
+  generic_antenna::generic_antenna_sptr ref =
+    antenna::yagi_antenna::make(YAGI, freq, RHCP, 5, 2.35);
+  BOOST_CHECK_CLOSE(ant->get_gain_rolloff(utils::degrees_to_radians(5), 1),
+                    ref->get_gain_rolloff(), TOLERANCE);
+  /* The pointing error of the antenna is not affected */
+  BOOST_CHECK_CLOSE(ant->get_pointing_error(), utils::degrees_to_radians(1),
+                    TOLERANCE);
+
+  /* The default roll-off approximates the main lobe with a Gaussian beam */
+  beam_antenna beam;
+  BOOST_CHECK_CLOSE(beam.get_gain_rolloff(), 12 * std::pow(1.0 / 20, 2),
+                    TOLERANCE);
+  BOOST_CHECK_CLOSE(beam.get_gain_rolloff(utils::degrees_to_radians(10), 1),
+                    3, TOLERANCE);
+  BOOST_CHECK_CLOSE(beam.get_pointing_error(), utils::degrees_to_radians(1),
+                    TOLERANCE);
+}
+
+BOOST_AUTO_TEST_CASE(t_antenna_pointing_loss_geometric)
+{
+  generic_antenna::generic_antenna_sptr gs_ant =
+    antenna::custom_antenna::make(CUSTOM, freq, RHCP, 0, 12, 30, 0);
+  generic_antenna::generic_antenna_sptr sat_ant = make_pattern_antenna();
+  generic_attenuation::generic_attenuation_sptr loss =
+    attenuation::antenna_pointing_loss::make(gs_ant, sat_ant,
+        ANTENNA_POINTING_LOSS_GEOMETRIC);
+
+  const double h = 500;
+  const double r = EARTH_RADIUS + h;
+
+  /* At the zenith the ground station is at the nadir of the satellite */
+  generic_attenuation::set_elevation_angle(MATH_PI / 2);
+  generic_attenuation::set_slant_range(h);
+  BOOST_CHECK_SMALL(loss->get_attenuation(), 1e-5);
+
+  /* At the horizon the line of sight is tangent to the Earth */
+  generic_attenuation::set_elevation_angle(0);
+  generic_attenuation::set_slant_range(std::sqrt(r * r - EARTH_RADIUS *
+                                       EARTH_RADIUS));
+  const double nadir = std::asin(EARTH_RADIUS / r);
+  BOOST_CHECK_CLOSE(loss->get_attenuation(),
+                    sat_ant->get_gain_rolloff(nadir, 0), TOLERANCE);
+  BOOST_CHECK_GT(loss->get_attenuation(), 3);
+
+  BOOST_CHECK_THROW(attenuation::antenna_pointing_loss::make(gs_ant, sat_ant,
+                    DOPPLER_SHIFT), std::invalid_argument);
+}
+
+} /* namespace leo */
+} /* namespace gr */
@@ -0,0 +1,325 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Reference outputs of the atmospheric gases attenuation models, as produced
+ * by the exact scalar implementations. Any cached, interpolated or
+ * vectorized variant of the models must reproduce them within TOLERANCE.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/leo/atmospheric_gases_itu.h>
+#include <gnuradio/leo/atmospheric_gases_itu_annex2.h>
+#include <gnuradio/leo/atmospheric_gases_regression.h>
+#include <gnuradio/leo/utils/helper.h>
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* Relative tolerance in percent, as BOOST_CHECK_CLOSE expects it */
+const double TOLERANCE = 1e-7;
+
+typedef struct {
+  double freq_ghz;
+  double elevation_deg;
+  double attenuation_db;
+} atmo_reference_t;
+
+/* Surface water vapour density 7.5 g/m^3 */
+const atmo_reference_t itu_reference[] = {
+  { 0.435, 5, 0.025722031747508995 },
+  { 0.435, 10, 0.025410303843765511 },
+  { 0.435, 30, 0.025283872042471702 },
+  { 0.435, 60, 0.025274195493579083 },
+  { 0.435, 90, 0.025273884621548646 },
+  { 2.4, 5, 0.042243716961580094 },
+  { 2.4, 10, 0.041392126984327038 },
+  { 2.4, 30, 0.041046123349108982 },
+  { 2.4, 60, 0.041019611215020901 },
+  { 2.4, 90, 0.041018759199763027 },
+  { 8.4, 5, 0.049647585846654789 },
+  { 8.4, 10, 0.048500203079999075 },
+  { 8.4, 30, 0.048033541262627523 },
+  { 8.4, 60, 0.047997759905621308 },
+  { 8.4, 90, 0.047996609788560955 },
+  { 12, 5, 0.059624628350353939 },
+  { 12, 10, 0.058024498609903885 },
+  { 12, 30, 0.05737301656591122 },
+  { 12, 60, 0.057323029997444229 },
+  { 12, 90, 0.057321422972145417 },
+  { 22.235, 5, 0.56348041774746216 },
+  { 22.235, 10, 0.54165797119982861 },
+  { 22.235, 30, 0.53277006006406036 },
+  { 22.235, 60, 0.53208796593238772 },
+  { 22.235, 90, 0.53206603587242796 },
+  { 30, 5, 0.20170275498497817 },
+  { 30, 10, 0.19419760028218461 },
+  { 30, 30, 0.19113656418871472 },
+  { 30, 60, 0.19090143003202475 },
+  { 30, 90, 0.19089386822011975 }
+};
+
+/*
+ * Surface water vapour density 7.5 g/m^3, temperature 20 C.
+ * Above the last tabulated frequency the first coefficients are used.
+ */
+const atmo_reference_t regression_reference[] = {
+  { 2.4, 5, 2.0963581286035438 },
+  { 2.4, 10, 1.1096324982181289 },
+  { 2.4, 30, 0.38537132239116284 },
+  { 2.4, 60, 0.22249423672049989 },
+  { 2.4, 90, 0.19268566119558139 },
+  { 8.4, 5, 2.1957613528572355 },
+  { 8.4, 10, 1.1480202436075919 },
+  { 8.4, 30, 0.39870324645440758 },
+  { 8.4, 60, 0.23019142666722989 },
+  { 8.4, 90, 0.19935162322720376 },
+  { 12, 5, 2.4230828176838304 },
+  { 12, 10, 1.2596607218458529 },
+  { 12, 30, 0.4374755776542848 },
+  { 12, 60, 0.25257664252258832 },
+  { 12, 90, 0.21873778882714237 },
+  { 22.235, 5, 2.1112090871122313 },
+  { 22.235, 10, 1.1243868423993366 },
+  { 22.235, 30, 0.39049545235063765 },
+  { 22.235, 60, 0.22545265453196531 },
+  { 22.235, 90, 0.1952477261753188 },
+  { 30, 5, 2.1112090871122313 },
+  { 30, 10, 1.1243868423993366 },
+  { 30, 30, 0.39049545235063765 },
+  { 30, 60, 0.22545265453196531 },
+  { 30, 90, 0.1952477261753188 }
+};
+
+/*
+ * Surface water vapour density 7.5 g/m^3, temperature 20 C, pressure
+ * 1013.25 hPa
+ */
+const atmo_reference_t annex2_reference[] = {
+  { 0.435, 2, 0.28333037244030179 },
+  { 0.435, 5, 0.14965074646768819 },
+  { 0.435, 10, 0.075111194003717713 },
+  { 0.435, 30, 0.026085843922265695 },
+  { 0.435, 90, 0.013042921961132846 },
+  { 2.4, 2, 0.75204114925304388 },
+  { 2.4, 5, 0.39624059524621602 },
+  { 2.4, 10, 0.19887708497406792 },
+  { 2.4, 30, 0.069069286770916311 },
+  { 2.4, 90, 0.034534643385458148 },
+  { 8.4, 2, 1.0085625049937028 },
+  { 8.4, 5, 0.51873161718595451 },
+  { 8.4, 10, 0.26035654384610141 },
+  { 8.4, 30, 0.090420878765071516 },
+  { 8.4, 90, 0.045210439382535751 },
+  { 12, 2, 1.3329926615449206 },
+  { 12, 5, 0.67053197428715383 },
+  { 12, 10, 0.33654664874827539 },
+  { 12, 30, 0.11688142451010106 },
+  { 12, 90, 0.058440712255050521 },
+  { 22.235, 2, 12.459874235112464 },
+  { 22.235, 5, 5.9710388724333763 },
+  { 22.235, 10, 2.9969236354455417 },
+  { 22.235, 30, 1.0408206558041406 },
+  { 22.235, 90, 0.5204103279020702 },
+  { 30, 2, 5.5790122611594208 },
+  { 30, 5, 2.6899671419058566 },
+  { 30, 10, 1.3501211896924397 },
+  { 30, 30, 0.46889216843920029 },
+  { 30, 90, 0.23444608421960011 },
+  { 60, 2, 2870.6789606552697 },
+  { 60, 5, 1766.4473864624765 },
+  { 60, 10, 886.59746425381695 },
+  { 60, 30, 307.91206798359349 },
+  { 60, 90, 153.95603399179672 }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t_atmospheric_gases_itu_reference)
+{
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::atmospheric_gases_itu::make(7.5);
+  for (const atmo_reference_t &r : itu_reference) {
+    generic_attenuation::set_frequency(r.freq_ghz * 1e9);
+    generic_attenuation::set_elevation_angle(
+      utils::degrees_to_radians(r.elevation_deg));
+    BOOST_TEST_CONTEXT("f=" << r.freq_ghz << " GHz, el=" << r.elevation_deg) {
+      BOOST_CHECK_CLOSE(att->get_attenuation(), r.attenuation_db, TOLERANCE);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(t_atmospheric_gases_regression_reference)
+{
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::atmospheric_gases_regression::make(7.5, 20);
+  for (const atmo_reference_t &r : regression_reference) {
+    generic_attenuation::set_frequency(r.freq_ghz * 1e9);
+    generic_attenuation::set_elevation_angle(
+      utils::degrees_to_radians(r.elevation_deg));
+    BOOST_TEST_CONTEXT("f=" << r.freq_ghz << " GHz, el=" << r.elevation_deg) {
+      BOOST_CHECK_CLOSE(att->get_attenuation(), r.attenuation_db, TOLERANCE);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(t_atmospheric_gases_itu_annex2_reference)
+{
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::atmospheric_gases_itu_annex2::make(7.5, 20);
+  for (const atmo_reference_t &r : annex2_reference) {
+    generic_attenuation::set_frequency(r.freq_ghz * 1e9);
+    generic_attenuation::set_elevation_angle(
+      utils::degrees_to_radians(r.elevation_deg));
+    BOOST_TEST_CONTEXT("f=" << r.freq_ghz << " GHz, el=" << r.elevation_deg) {
+      BOOST_CHECK_CLOSE(att->get_attenuation(), r.attenuation_db, TOLERANCE);
+    }
+  }
+}
+
+/* The cached frequency terms must follow any change of the frequency */
+BOOST_AUTO_TEST_CASE(t_atmospheric_gases_itu_annex2_frequency_change)
+{
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::atmospheric_gases_itu_annex2::make(7.5, 20);
+  const size_t n = sizeof(annex2_reference) / sizeof(annex2_reference[0]);
+  for (size_t i = 0; i < n; i++) {
+    const atmo_reference_t &r = annex2_reference[(i * 11) % n];
+    generic_attenuation::set_frequency(r.freq_ghz * 1e9);
+    generic_attenuation::set_elevation_angle(
+      utils::degrees_to_radians(r.elevation_deg));
+    BOOST_CHECK_CLOSE(att->get_attenuation(), r.attenuation_db, TOLERANCE);
+  }
+}
+
+/*
+ * The regression coefficients are resolved lazily, so models created before
+ * the frequency is known, or evaluated in turns at different frequencies,
+ * must agree with the reference
+ */
+BOOST_AUTO_TEST_CASE(t_atmospheric_gases_regression_frequency_change)
+{
+  generic_attenuation::set_frequency(0);
+  generic_attenuation::generic_attenuation_sptr a =
+    attenuation::atmospheric_gases_regression::make(7.5, 20);
+  generic_attenuation::generic_attenuation_sptr b =
+    attenuation::atmospheric_gases_regression::make(7.5, 20);
+  const size_t n = sizeof(regression_reference) /
+                   sizeof(regression_reference[0]);
+  for (size_t i = 0; i < n; i++) {
+    const atmo_reference_t &ra = regression_reference[i];
+    const atmo_reference_t &rb = regression_reference[n - 1 - i];
+    generic_attenuation::set_frequency(ra.freq_ghz * 1e9);
+    generic_attenuation::set_elevation_angle(
+      utils::degrees_to_radians(ra.elevation_deg));
+    BOOST_CHECK_CLOSE(a->get_attenuation(), ra.attenuation_db, TOLERANCE);
+    generic_attenuation::set_frequency(rb.freq_ghz * 1e9);
+    generic_attenuation::set_elevation_angle(
+      utils::degrees_to_radians(rb.elevation_deg));
+    BOOST_CHECK_CLOSE(b->get_attenuation(), rb.attenuation_db, TOLERANCE);
+  }
+}
+
+/* The ITU model must not depend on the order of the evaluations */
+BOOST_AUTO_TEST_CASE(t_atmospheric_gases_itu_stateless)
+{
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::atmospheric_gases_itu::make(7.5);
+  const size_t n = sizeof(itu_reference) / sizeof(itu_reference[0]);
+  for (size_t i = n; i-- > 0;) {
+    const atmo_reference_t &r = itu_reference[i];
+    generic_attenuation::set_frequency(r.freq_ghz * 1e9);
+    generic_attenuation::set_elevation_angle(
+      utils::degrees_to_radians(r.elevation_deg));
+    BOOST_CHECK_CLOSE(att->get_attenuation(), r.attenuation_db, TOLERANCE);
+  }
+}
+
+/*
+ * The batch over arbitrary geometries groups the points by frequency and
+ * splits them across threads, so it must agree with the scalar evaluation
+ * and leave the static variables of the caller intact
+ */
+BOOST_AUTO_TEST_CASE(t_atmospheric_gases_batch_geometry)
+{
+  const generic_attenuation::generic_attenuation_sptr models[] = {
+    attenuation::atmospheric_gases_regression::make(7.5, 20),
+    attenuation::atmospheric_gases_itu_annex2::make(7.5, 20)
+  };
+  const double freqs[] = {12e9, 2.4e9, 30e9};
+  const size_t n = 30000;
+  std::vector<double> freq(n);
+  std::vector<double> elevation(n);
+  std::vector<double> range(n, 1000);
+  for (size_t i = 0; i < n; i++) {
+    freq[i] = freqs[(i * 7) % 3];
+    elevation[i] = utils::degrees_to_radians(1 + (i * 0.003));
+  }
+
+  for (const generic_attenuation::generic_attenuation_sptr &att : models) {
+    generic_attenuation::set_frequency(8.4e9);
+    generic_attenuation::set_elevation_angle(0.5);
+    const double expected = att->get_attenuation();
+    const std::vector<double> res = att->get_attenuation_batch(freq,
+                                    elevation, range, 4);
+    BOOST_CHECK_EQUAL(att->get_attenuation(), expected);
+
+    BOOST_REQUIRE_EQUAL(res.size(), n);
+    for (size_t i = 0; i < n; i += 97) {
+      generic_attenuation::set_frequency(freq[i]);
+      generic_attenuation::set_elevation_angle(elevation[i]);
+      BOOST_CHECK_EQUAL(res[i], att->get_attenuation());
+    }
+  }
+
+  /*
+   * The layered ITU model keeps the state of its layers local, so its batch
+   * is split across threads as well. It is expensive, so fewer points.
+   */
+  generic_attenuation::generic_attenuation_sptr itu =
+    attenuation::atmospheric_gases_itu::make(7.5);
+  const size_t m = 120;
+  std::vector<double> itu_freq(m);
+  std::vector<double> itu_elevation(m);
+  std::vector<double> itu_range(m, 1000);
+  for (size_t i = 0; i < m; i++) {
+    itu_freq[i] = freqs[(i * 7) % 3];
+    itu_elevation[i] = utils::degrees_to_radians(1 + i * 0.7);
+  }
+  const std::vector<double> res = itu->get_attenuation_batch(itu_freq,
+                                  itu_elevation, itu_range, 4);
+  BOOST_REQUIRE_EQUAL(res.size(), m);
+  for (size_t i = 0; i < m; i++) {
+    generic_attenuation::set_frequency(itu_freq[i]);
+    generic_attenuation::set_elevation_angle(itu_elevation[i]);
+    BOOST_CHECK_EQUAL(res[i], itu->get_attenuation());
+  }
+
+  BOOST_CHECK_THROW(itu->get_attenuation_batch({freqs[0]}, {0.2, 0.4}, {1000}),
+                    std::invalid_argument);
+}
+
+} /* namespace leo */
+} /* namespace gr */
@@ -0,0 +1,201 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Validates the attitude modes against the nadir angle of the geometric
+ * pointing loss and the closed form rotation of a spinning body.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/leo/antenna_pointing_loss.h>
+#include <gnuradio/leo/attitude.h>
+#include <gnuradio/leo/dipole_antenna.h>
+#include <gnuradio/leo/utils/helper.h>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+const double TOLERANCE = 1e-9;
+
+/* A satellite over the equator at 600 km, that moves eastwards */
+eci_state_t
+equatorial_state(double gs_lat, double gs_lon)
+{
+  const double r = EARTH_RADIUS + 600;
+  const double lat = utils::degrees_to_radians(gs_lat);
+  const double lon = utils::degrees_to_radians(gs_lon);
+  eci_state_t state = {
+    {r, 0, 0},
+    {0, 7.56, 0},
+    {
+      EARTH_RADIUS * std::cos(lat) * std::cos(lon),
+      EARTH_RADIUS * std::cos(lat) * std::sin(lon),
+      EARTH_RADIUS * std::sin(lat)
+    }
+  };
+  return state;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t_attitude_nadir)
+{
+  attitude::attitude_sptr att = attitude::make(ATTITUDE_NADIR);
+
+  /* The ground station right below the satellite */
+  att->update(0, equatorial_state(0, 0));
+  BOOST_CHECK_SMALL(att->get_off_boresight(), TOLERANCE);
+
+  /* Ahead of the satellite, the ground station is towards +X */
+  att->update(0, equatorial_state(0, 5));
+  BOOST_CHECK_SMALL(att->get_azimuth(), TOLERANCE);
+
+  /* North of the orbit, towards -Y */
+  att->update(0, equatorial_state(5, 0));
+  BOOST_CHECK_CLOSE(att->get_azimuth(), -M_PI / 2, TOLERANCE);
+
+  /* The same angle as the nadir pointing geometry of the pointing loss */
+  const eci_state_t s = equatorial_state(8, 3);
+  att->update(0, s);
+  const double dx = s.gs_position[0] - s.sat_position[0];
+  const double dy = s.gs_position[1] - s.sat_position[1];
+  const double dz = s.gs_position[2] - s.sat_position[2];
+  const double slant_range = std::sqrt(dx * dx + dy * dy + dz * dz);
+  const double sin_elev = -(dx * s.gs_position[0] + dy * s.gs_position[1]
+                            + dz * s.gs_position[2]) / (slant_range * EARTH_RADIUS);
+  const double elev = std::asin(sin_elev);
+  const double r = std::sqrt(EARTH_RADIUS * EARTH_RADIUS
+                             + slant_range * slant_range
+                             + 2 * EARTH_RADIUS * slant_range * std::sin(elev));
+  BOOST_CHECK_CLOSE(att->get_off_boresight(),
+                    std::asin(EARTH_RADIUS * std::cos(elev) / r), 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(t_attitude_spin)
+{
+  /* Spinning at 10 degrees/sec around the celestial pole */
+  attitude::attitude_sptr att = attitude::make(ATTITUDE_SPIN, 10);
+  eci_state_t s = {{0, 0, 0}, {0, 0, 0}, {1, 0, 0}};
+
+  for (double t = 0; t < 36; t += 1.5) {
+    att->update(t, s);
+    BOOST_CHECK_CLOSE(att->get_off_boresight(), M_PI / 2, TOLERANCE);
+    /* The body turns forwards, so the ground station turns backwards */
+    const double expected = std::remainder(-utils::degrees_to_radians(10 * t),
+                                           2 * M_PI);
+    BOOST_CHECK_SMALL(std::remainder(att->get_azimuth() - expected, 2 * M_PI),
+                      TOLERANCE);
+  }
+
+  /* The boresight towards the vernal equinox */
+  attitude::attitude_sptr equinox = attitude::make(ATTITUDE_SPIN, 10, 0, 0);
+  equinox->update(7, s);
+  BOOST_CHECK_SMALL(equinox->get_off_boresight(), TOLERANCE);
+
+  /* And towards right ascension 90 degrees, declination 30 degrees */
+  attitude::attitude_sptr tilted = attitude::make(ATTITUDE_SPIN, 0, 90, 30);
+  s.gs_position[0] = 0;
+  s.gs_position[1] = std::cos(M_PI / 6);
+  s.gs_position[2] = std::sin(M_PI / 6);
+  tilted->update(0, s);
+  BOOST_CHECK_SMALL(tilted->get_off_boresight(), 1e-7);
+}
+
+BOOST_AUTO_TEST_CASE(t_attitude_tumbling)
+{
+  attitude::attitude_sptr att = attitude::make(ATTITUDE_TUMBLING, 3, 0, 90, 42);
+  attitude::attitude_sptr same = attitude::make(ATTITUDE_TUMBLING, 3, 0, 90, 42);
+
+  /* A few time instances of the same state, in the batch layout */
+  const size_t n = 4;
+  const double time[n] = {0, 10, 45.5, 1000};
+  double sat_position[3 * n];
+  double sat_velocity[3 * n];
+  double gs_position[3 * n];
+  const eci_state_t s = equatorial_state(20, 10);
+  for (size_t i = 0; i < n; i++) {
+    for (size_t c = 0; c < 3; c++) {
+      sat_position[c * n + i] = s.sat_position[c];
+      sat_velocity[c * n + i] = s.sat_velocity[c];
+      gs_position[c * n + i] = s.gs_position[c];
+    }
+  }
+  double theta[n];
+  double phi[n];
+  att->off_boresight_batch(n, time, sat_position, sat_velocity, gs_position,
+                           theta, phi);
+
+  for (size_t i = 0; i < n; i++) {
+    same->update(time[i], s);
+    BOOST_CHECK_EQUAL(same->get_off_boresight(), theta[i]);
+    BOOST_CHECK_EQUAL(same->get_azimuth(), phi[i]);
+    BOOST_CHECK_GE(theta[i], 0);
+    BOOST_CHECK_LE(theta[i], M_PI);
+  }
+  /* The body does rotate */
+  BOOST_CHECK_GT(std::abs(theta[1] - theta[0]) + std::abs(phi[1] - phi[0]),
+                 1e-3);
+
+  /* Opposite directions are opposite in the body frame too */
+  eci_state_t opposite = s;
+  for (size_t c = 0; c < 3; c++) {
+    opposite.gs_position[c] = 2 * s.sat_position[c] - s.gs_position[c];
+  }
+  same->update(time[2], opposite);
+  BOOST_CHECK_CLOSE(same->get_off_boresight() + theta[2], M_PI, 1e-9);
+
+  /* Another seed gives another orientation */
+  attitude::attitude_sptr other = attitude::make(ATTITUDE_TUMBLING, 3, 0, 90, 7);
+  other->update(time[0], s);
+  BOOST_CHECK_NE(other->get_off_boresight(), theta[0]);
+}
+
+BOOST_AUTO_TEST_CASE(t_attitude_invalid)
+{
+  BOOST_CHECK_THROW(attitude::make(static_cast<attitude_mode_t>(5)),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(t_attitude_pointing_loss)
+{
+  const double freq = 435e6;
+  generic_antenna::generic_antenna_sptr gs_ant =
+    antenna::dipole_antenna::make(DIPOLE, freq, LINEAR_VERTICAL, 0);
+  generic_antenna::generic_antenna_sptr sat_ant =
+    antenna::dipole_antenna::make(DIPOLE, freq, LINEAR_VERTICAL, 0.1);
+  attitude::attitude_sptr att = attitude::make(ATTITUDE_NADIR);
+  generic_attenuation::generic_attenuation_sptr loss =
+    attenuation::antenna_pointing_loss::make(gs_ant, sat_ant,
+        ANTENNA_POINTING_LOSS, nullptr, att);
+
+  att->update(0, equatorial_state(10, 4));
+  BOOST_CHECK_CLOSE(loss->get_attenuation(),
+                    sat_ant->get_gain_rolloff(att->get_off_boresight()
+                        + utils::degrees_to_radians(0.1),
+                        att->get_azimuth()), TOLERANCE);
+}
+
+} /* namespace leo */
+} /* namespace gr */
@@ -0,0 +1,152 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Validates the time handling of the channel model block: the tracker must
+ * follow the rx_time tags of the input stream and a restarted flowgraph
+ * must resume the precomputed windows where it stopped.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/leo/channel_model.h>
+#include <gnuradio/leo/scenario.h>
+#include <gnuradio/top_block.h>
+#include "qa_scenarios.h"
+#include <libsgp4/TimeSpan.h>
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+BOOST_AUTO_TEST_CASE(t_channel_model_rx_time)
+{
+  const double samp_rate = 48e3;
+  const double duration_s = 10;
+  /* 2018-09-25T15:50:00.25Z, inside the UPSAT pass */
+  const uint64_t secs = 1537890600;
+  const double frac = 0.25;
+
+  scenario_t s = qa::upsat_scenario();
+  s.time_step_us = 1000;
+  generic_model::generic_model_sptr model = scenario::make_model(s);
+  tracker::tracker_sptr trk = model->get_tracker();
+
+  tag_t tag;
+  tag.offset = 0;
+  tag.key = pmt::intern("rx_time");
+  tag.value = pmt::make_tuple(pmt::from_uint64(secs), pmt::from_double(frac));
+  tag.srcid = pmt::intern("qa");
+  const std::vector<gr_complex> samples(
+    static_cast<size_t>(samp_rate * duration_s), gr_complex(1, 0));
+
+  gr::top_block_sptr tb = gr::make_top_block("qa_channel_model_rx_time");
+  gr::blocks::vector_source_c::sptr src = gr::blocks::vector_source_c::make(
+      samples, false, 1, {tag});
+  channel_model::sptr chan = channel_model::make(samp_rate, model, NOISE_NONE,
+                             false, "", LOS_SIMULATE, 1.0, TIME_RX_TAGS);
+  gr::blocks::null_sink::sptr sink = gr::blocks::null_sink::make(
+                                       sizeof(gr_complex));
+  tb->connect(src, 0, chan, 0);
+  tb->connect(chan, 0, sink, 0);
+  tb->run();
+  /* Joins the update thread, after it applies the last requested time */
+  chan->stop();
+
+  const double start_us = secs * 1e6 + frac * 1e6;
+  const double tracker_us = static_cast<double>(
+                              (trk->get_elapsed_time().Ticks() - libsgp4::UnixEpoch)
+                              / libsgp4::TicksPerMicrosecond);
+  /*
+   * The last requested time is the start of the last input buffer, so it is
+   * within a few buffers of the end of the stream
+   */
+  BOOST_CHECK_GE(tracker_us, start_us + 0.5 * duration_s * 1e6);
+  BOOST_CHECK_LE(tracker_us, start_us + duration_s * 1e6 + s.time_step_us);
+}
+
+/*
+ * Runs the UPSAT pass through a channel model that precomputes its windows,
+ * in one or two runs of the flowgraph, and returns the lines of its CSV log
+ */
+static std::vector<std::string>
+precompute_csv(const std::string &filename, size_t runs)
+{
+  const double samp_rate = 48e3;
+  /* 200 time windows of 1 ms in total */
+  const size_t nsamples = 200 * 48 / runs;
+
+  scenario_t s = qa::upsat_scenario();
+  s.obs_start = "2018-09-25T15:53:00";
+  s.time_step_us = 1000;
+  generic_model::generic_model_sptr model = scenario::make_model(s);
+
+  const std::vector<gr_complex> samples(nsamples, gr_complex(1, 0));
+  gr::top_block_sptr tb = gr::make_top_block("qa_channel_model_precompute");
+  gr::blocks::vector_source_c::sptr src = gr::blocks::vector_source_c::make(
+      samples);
+  channel_model::sptr chan = channel_model::make(samp_rate, model, NOISE_NONE,
+                             true, filename.c_str(), LOS_SIMULATE, 1.0,
+                             TIME_SIMULATED, 4);
+  gr::blocks::null_sink::sptr sink = gr::blocks::null_sink::make(
+                                       sizeof(gr_complex));
+  tb->connect(src, 0, chan, 0);
+  tb->connect(chan, 0, sink, 0);
+  for (size_t i = 0; i < runs; i++) {
+    src->rewind();
+    tb->run();
+  }
+  /* Closes the CSV log */
+  tb.reset();
+  chan.reset();
+
+  std::vector<std::string> lines;
+  std::ifstream f(filename);
+  std::string line;
+  while (std::getline(f, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+BOOST_AUTO_TEST_CASE(t_channel_model_precompute_restart)
+{
+  qa::temp_cache_dir dir;
+  const std::vector<std::string> once = precompute_csv(dir.path() + "/once.csv",
+                                        1);
+  const std::vector<std::string> twice = precompute_csv(
+      dir.path() + "/twice.csv", 2);
+
+  /*
+   * The windows computed ahead before the first run stopped must be
+   * dropped, so the second run continues right after the last applied one
+   */
+  BOOST_REQUIRE_GT(once.size(), 100);
+  BOOST_CHECK_EQUAL_COLLECTIONS(once.begin(), once.end(), twice.begin(),
+                                twice.end());
+}
+
+} // namespace leo
+} // namespace gr
@@ -0,0 +1,288 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Validates the LEO model against exact scalar references: the state of
+ * the model must be consistent with standalone evaluations of the
+ * impairments for the same geometry, and the processed signal must match a
+ * double precision rotation and scaling of the input. Any cached,
+ * interpolated or vectorized variant of the model must keep passing them.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/leo/atmospheric_gases_itu.h>
+#include <gnuradio/leo/dipole_antenna.h>
+#include <gnuradio/leo/leo_model.h>
+#include <gnuradio/leo/precipitation_itu.h>
+#include <gnuradio/leo/satellite.h>
+#include <gnuradio/leo/tracker.h>
+#include <gnuradio/leo/yagi_antenna.h>
+#include "qa_scenarios.h"
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* The ISS over the ground station of the UPSAT example at Chania */
+const char *tle_title = "ISS";
+const char *tle_1 =
+  "1 25544U 98067A   18268.52547184  .00016717  00000-0  10270-3 0  9019";
+const char *tle_2 =
+  "2 25544  51.6373 238.6885 0003885 206.9748 153.1203 15.53729445 14114";
+const double gs_lat = 35.3333;
+const double gs_lon = 25.1833;
+const double gs_alt = 0.1;
+const double freq = 435e6;
+const double samp_rate = 48e3;
+
+/* Tolerance of the quantities in dB and Hz */
+const double STATE_TOLERANCE = 1e-9;
+/* Tolerance of the signal, relative to the amplitude of the input */
+const double SIGNAL_TOLERANCE = 1e-3;
+
+/* The libSGP4 representation YYYY-MM-DD HH:MM:SS.ffffff UTC to ISO-8601 */
+std::string
+to_iso_8601(const std::string &s)
+{
+  std::string iso = s.substr(0, 19);
+  iso[10] = 'T';
+  return iso;
+}
+
+/*
+ * Builds a model observing the first high pass of the day, starting
+ * exactly at its AOS
+ */
+generic_model::generic_model_sptr
+make_model(tracker::tracker_sptr &trk,
+           impairment_enum_t precipitation = IMPAIRMENT_NONE,
+           unsigned int seed = 0, double rain_probability = 5.0,
+           double fade_dynamics = 2e-4)
+{
+  tracker t(tle_title, tle_1, tle_2, gs_lat, gs_lon, gs_alt,
+            "2018-09-25T00:00:00", "2018-09-26T00:00:00");
+  pass_details_t pass;
+  bool found = false;
+  for (const pass_details_t &p : t.generate_passlist(10)) {
+    if (p.max_elevation > 0.35) {
+      pass = p;
+      found = true;
+      break;
+    }
+  }
+  BOOST_REQUIRE(found);
+
+  generic_antenna::generic_antenna_sptr sat_ant =
+    antenna::dipole_antenna::make(DIPOLE, freq, LINEAR_VERTICAL, 0);
+  generic_antenna::generic_antenna_sptr gs_ant =
+    antenna::yagi_antenna::make(YAGI, freq, RHCP, 0.1, 2.35);
+  satellite::satellite_sptr sat = satellite::make(tle_title, tle_1, tle_2,
+                                  freq, freq, 30, sat_ant, sat_ant, 5, 290,
+                                  samp_rate);
+  trk = tracker::make(sat, gs_lat, gs_lon, gs_alt, to_iso_8601(pass.aos),
+                      to_iso_8601(pass.los), 1e6, freq, freq, 30, gs_ant,
+                      gs_ant, 1, 290, samp_rate);
+  return model::leo_model::make(trk, DOWNLINK, FREE_SPACE_PATH_LOSS,
+                                ANTENNA_POINTING_LOSS, DOPPLER_SHIFT,
+                                ATMO_GASES_ITU, precipitation, true, 7.5,
+                                20, 25, IMPAIRMENT_NONE, nullptr, nullptr,
+                                seed, rain_probability, fade_dynamics);
+}
+
+/* Reports the time of the evaluation that the models set */
+class time_probe : public generic_attenuation {
+public:
+  double
+  get_attenuation()
+  {
+    return time;
+  }
+};
+
+std::vector<gr_complex>
+random_signal(size_t n)
+{
+  std::mt19937 gen(42);
+  std::normal_distribution<float> dist(0.0f, 1.0f);
+  std::vector<gr_complex> v(n);
+  for (gr_complex &s : v) {
+    s = gr_complex(dist(gen), dist(gen));
+  }
+  return v;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t_leo_model_state_consistency)
+{
+  tracker::tracker_sptr trk;
+  generic_model::generic_model_sptr m = make_model(trk);
+  generic_attenuation::generic_attenuation_sptr atmo =
+    attenuation::atmospheric_gases_itu::make(7.5);
+
+  size_t naos = 0;
+  for (m->advance_time(0); !trk->is_observation_over(); m->advance_time(10e6)) {
+    const model_state_t s = m->get_state();
+
+    BOOST_TEST_CONTEXT("t=" << trk->get_elapsed_time().ToString()) {
+      BOOST_CHECK_EQUAL(s.elapsed_ticks, trk->get_elapsed_time().Ticks());
+      BOOST_CHECK_EQUAL(s.elevation, trk->get_elevation_degrees());
+      BOOST_CHECK_EQUAL(s.slant_range, trk->get_slant_range());
+      BOOST_CHECK_EQUAL(s.aos, s.elevation > 1.0);
+      BOOST_CHECK_EQUAL(m->aos(), s.aos);
+
+      BOOST_CHECK_SMALL(s.pathloss_attenuation
+                        - (92.45 + 20 * std::log10(s.slant_range * freq / 1e9)),
+                        STATE_TOLERANCE);
+      /* The model leaves the geometry of the attenuations to the last step */
+      BOOST_CHECK_SMALL(s.atmo_attenuation - atmo->get_attenuation(),
+                        STATE_TOLERANCE);
+      BOOST_CHECK_EQUAL(s.rainfall_attenuation, 0.0);
+      BOOST_CHECK_SMALL(s.total_attenuation
+                        - (s.pathloss_attenuation + s.atmo_attenuation
+                           + s.rainfall_attenuation + s.pointing_attenuation),
+                        STATE_TOLERANCE);
+      BOOST_CHECK_SMALL(s.doppler_shift
+                        - (-1e3 * s.velocity * freq / LIGHT_SPEED),
+                        STATE_TOLERANCE);
+    }
+    naos += s.aos;
+  }
+  BOOST_CHECK(naos > 0);
+}
+
+BOOST_AUTO_TEST_CASE(t_leo_model_signal_reference)
+{
+  tracker::tracker_sptr trk;
+  generic_model::generic_model_sptr m = make_model(trk);
+
+  /* Move close to the culmination, where the Doppler shift changes sign */
+  m->advance_time(0);
+  model_state_t s = m->get_state();
+  double max_elev = s.elevation;
+  while (!trk->is_observation_over()) {
+    m->advance_time(5e6);
+    if (m->get_state().elevation < max_elev) {
+      break;
+    }
+    s = m->get_state();
+    max_elev = s.elevation;
+  }
+  m->set_state(s);
+  BOOST_REQUIRE(s.aos);
+
+  const size_t n = 4096;
+  const std::vector<gr_complex> in = random_signal(2 * n);
+  std::vector<gr_complex> out(2 * n);
+  /* Two consecutive calls, the phase of the Doppler shift must be continuous */
+  m->generic_work(in.data(), out.data(), n, samp_rate);
+  m->generic_work(in.data() + n, out.data() + n, n, samp_rate);
+
+  const std::complex<float> step = std::polar<float>(1.0f,
+                                   static_cast<float>(2.0f * M_PI * s.doppler_shift / samp_rate));
+  const double w = std::arg(std::complex<double>(step));
+  const double gain = std::pow(10.0, -s.total_attenuation / 20.0);
+  for (size_t i = 0; i < 2 * n; i++) {
+    const std::complex<double> ref = std::complex<double>(in[i])
+                                     * std::polar(gain, w * i);
+    const double err = std::abs(std::complex<double>(out[i]) - ref)
+                       / (gain * std::abs(std::complex<double>(in[i])));
+    if (err > SIGNAL_TOLERANCE) {
+      BOOST_ERROR("sample " << i << " deviates by " << err);
+      break;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(t_leo_model_los_zeros)
+{
+  tracker::tracker_sptr trk;
+  generic_model::generic_model_sptr m = make_model(trk);
+
+  /* At the AOS the elevation is still below the 1 degree threshold */
+  m->advance_time(0);
+  BOOST_REQUIRE(!m->aos());
+
+  const std::vector<gr_complex> in = random_signal(1024);
+  std::vector<gr_complex> out(in.size(), gr_complex(1, 1));
+  m->generic_work(in.data(), out.data(), in.size(), samp_rate);
+  for (const gr_complex &o : out) {
+    BOOST_REQUIRE_EQUAL(o, gr_complex(0, 0));
+  }
+}
+
+/*
+ * The attenuation models receive the time of the tracker in seconds, so
+ * the rain fade decorrelates over the actual elapsed time
+ */
+BOOST_AUTO_TEST_CASE(t_leo_model_fade_time)
+{
+  tracker::tracker_sptr trk;
+  generic_model::generic_model_sptr m = make_model(trk);
+  time_probe probe;
+  m->advance_time(0);
+  const double t0 = probe.get_attenuation();
+  m->advance_time(10e6);
+  BOOST_CHECK_SMALL(probe.get_attenuation() - t0 - 10.0, 1e-3);
+}
+
+/*
+ * The fade of the model must follow a standalone synthesizer with the same
+ * seed and parameters, advanced by the same known interval. The interval
+ * is long relative to the time constant of the fade, so the samples differ
+ * if the model advances the fade by any other interval.
+ */
+BOOST_AUTO_TEST_CASE(t_leo_model_fade_synthesizer,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  tracker::tracker_sptr trk;
+  generic_model::generic_model_sptr m;
+  const double interval = 600;
+  size_t rain = 0;
+  for (unsigned int seed = 1; seed <= 20 && !rain; seed++) {
+    m = make_model(trk, PRECIPITATION_STATISTICAL, seed, 3.0, 1e-3);
+    generic_attenuation::generic_attenuation_sptr ref =
+      attenuation::precipitation_itu::make(25, gs_lon, gs_lat, gs_alt,
+                                           PRECIPITATION_STATISTICAL, 3.0,
+                                           1e-3, seed);
+    m->advance_time(0);
+    for (size_t k = 0; k < 50; k++) {
+      if (k) {
+        m->advance_time(interval * 1e6);
+      }
+      const model_state_t s = m->get_state();
+      /* The geometry of this step is left by the model */
+      generic_attenuation::set_time(k * interval);
+      BOOST_REQUIRE_EQUAL(s.rainfall_attenuation, ref->get_attenuation());
+      rain += s.rainfall_attenuation > 0;
+    }
+  }
+  BOOST_CHECK(rain > 0);
+}
+
+} /* namespace leo */
+} /* namespace gr */
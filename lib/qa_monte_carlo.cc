@@ -0,0 +1,176 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Validates the streaming statistics of the Monte-Carlo driver against
+ * exact two pass computations, the TLE epoch perturbation and the
+ * independence of the results from the number of threads.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/leo/monte_carlo.h>
+#include "qa_scenarios.h"
+#include "utils/running_stats.h"
+#include "utils/tle.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+const std::string tle_1 = qa::upsat_scenario().tle_1;
+const std::string tle_2 = qa::upsat_scenario().tle_2;
+
+/* The UPSAT pass with the statistical rain fade */
+scenario_t
+iss_scenario()
+{
+  scenario_t s = qa::upsat_scenario();
+  s.precipitation = PRECIPITATION_STATISTICAL;
+  return s;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t_running_stats_merge)
+{
+  std::mt19937_64 rng(1);
+  std::normal_distribution<double> normal(3, 7);
+  std::vector<double> values(10000);
+  for (double &v : values) {
+    v = normal(rng);
+  }
+
+  utils::running_stats all(-100, 100, 2000);
+  std::vector<utils::running_stats> parts(3,
+                                          utils::running_stats(-100, 100, 2000));
+  for (size_t i = 0; i < values.size(); i++) {
+    all.add(values[i]);
+    parts[i % 3].add(values[i]);
+  }
+  utils::running_stats merged(-100, 100, 2000);
+  for (const utils::running_stats &p : parts) {
+    merged.merge(p);
+  }
+
+  double mean = 0;
+  for (double v : values) {
+    mean += v;
+  }
+  mean /= values.size();
+  double var = 0;
+  for (double v : values) {
+    var += (v - mean) * (v - mean);
+  }
+  var /= values.size() - 1;
+
+  for (const utils::running_stats *s : {
+         &all, &merged
+       }) {
+    BOOST_REQUIRE_EQUAL(s->count(), values.size());
+    BOOST_CHECK_CLOSE(s->mean(), mean, 1e-9);
+    BOOST_CHECK_CLOSE(s->variance(), var, 1e-9);
+    BOOST_CHECK_EQUAL(s->min(), *std::min_element(values.begin(),
+                      values.end()));
+    BOOST_CHECK_EQUAL(s->max(), *std::max_element(values.begin(),
+                      values.end()));
+  }
+
+  /* The percentiles are accurate to the bin width */
+  std::sort(values.begin(), values.end());
+  for (double p : {
+         1.0, 5.0, 50.0, 95.0, 99.0
+       }) {
+    const double exact = values[static_cast<size_t>(p / 100 * values.size())];
+    BOOST_CHECK_SMALL(all.percentile(p) - exact, 0.1);
+    BOOST_CHECK_EQUAL(all.percentile(p), merged.percentile(p));
+  }
+  BOOST_CHECK_EQUAL(all.percentile(0), values.front());
+  BOOST_CHECK_EQUAL(all.percentile(100), values.back());
+}
+
+BOOST_AUTO_TEST_CASE(t_shift_tle_epoch)
+{
+  const std::string line(tle_1);
+  BOOST_CHECK_EQUAL(utils::tle_checksum(line), line[68] - '0');
+  BOOST_CHECK_EQUAL(shift_tle_epoch(line, 0), line);
+
+  const std::string day = shift_tle_epoch(line, 86400);
+  BOOST_CHECK_EQUAL(day.substr(18, 14), "18269.52547184");
+  BOOST_CHECK_EQUAL(day.size(), line.size());
+  BOOST_CHECK_EQUAL(utils::tle_checksum(day), day[68] - '0');
+  BOOST_CHECK_EQUAL(day.substr(32), line.substr(32, 36) + day.substr(68));
+
+  /* Across the start of the year */
+  const std::string year = shift_tle_epoch(line, -268 * 86400.0);
+  BOOST_CHECK_EQUAL(year.substr(18, 14), "17365.52547184");
+  BOOST_CHECK_EQUAL(utils::tle_checksum(year), year[68] - '0');
+
+  BOOST_CHECK_THROW(shift_tle_epoch(tle_2, 1), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(t_monte_carlo_threads,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  perturbation_t p;
+  p.rainfall_rate_sigma = 0.5;
+  p.pointing_error_sigma = 2;
+  p.tle_epoch_sigma = 5;
+
+  monte_carlo::monte_carlo_sptr serial = monte_carlo::make(iss_scenario(), p,
+                                         8, 10, 42);
+  monte_carlo::monte_carlo_sptr parallel = monte_carlo::make(iss_scenario(),
+      p, 8, 10, 42);
+  serial->run(1);
+  parallel->run(4);
+
+  BOOST_REQUIRE_EQUAL(serial->get_passes(), 8);
+  BOOST_CHECK_EQUAL(parallel->get_passes(), serial->get_passes());
+  BOOST_CHECK_EQUAL(parallel->get_outage_probability(),
+                    serial->get_outage_probability());
+
+  const link_statistics_t a = serial->get_link_margin();
+  const link_statistics_t b = parallel->get_link_margin();
+  BOOST_CHECK_EQUAL(a.count, b.count);
+  /* The realizations are merged in the same order with any thread count */
+  BOOST_CHECK_EQUAL(a.mean, b.mean);
+  BOOST_CHECK_EQUAL(a.stddev, b.stddev);
+  BOOST_CHECK_EQUAL(a.min, b.min);
+  BOOST_CHECK_EQUAL(a.max, b.max);
+  for (size_t i = 0; i < a.percentiles.size(); i++) {
+    BOOST_CHECK_EQUAL(a.percentiles[i], b.percentiles[i]);
+  }
+
+  /* The minimum of each realization is within the range of all the steps */
+  const link_statistics_t m = serial->get_min_link_margin();
+  BOOST_CHECK_EQUAL(m.count, 8);
+  BOOST_CHECK_EQUAL(m.min, a.min);
+  BOOST_CHECK_LE(m.max, a.max);
+  BOOST_CHECK(a.stddev > 0);
+}
+
+} // namespace leo
+} // namespace gr
@@ -0,0 +1,332 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Reference outputs of the ITU-R P.618 rainfall attenuation model, as
+ * produced by the exact scalar implementation for the ground station of the
+ * UPSAT example at Chania. Any cached, interpolated or vectorized variant of
+ * the model must reproduce them within TOLERANCE.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/constants.h>
+#include <gnuradio/leo/precipitation_itu.h>
+#include <gnuradio/leo/utils/helper.h>
+#include "qa_scenarios.h"
+#include "utils/itu_grid.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* Relative tolerance in percent, as BOOST_CHECK_CLOSE expects it */
+const double TOLERANCE = 1e-7;
+
+const double gs_lon = 25.1833;
+const double gs_lat = 35.3333;
+const double gs_alt = 0.1;
+
+typedef struct {
+  polarization_t polarization;
+  double freq_ghz;
+  double elevation_deg;
+  double attenuation_db;
+} rain_reference_t;
+
+/* Rainfall rate 25 mm/h */
+const rain_reference_t rain_reference[] = {
+  { RHCP, 2.4, 10, 0.016876941781973537 },
+  { RHCP, 2.4, 30, 0.018648138219395382 },
+  { RHCP, 2.4, 60, 0.025181729567626349 },
+  { RHCP, 2.4, 90, 0.0098829521143009372 },
+  { RHCP, 8.4, 10, 1.3025505694930148 },
+  { RHCP, 8.4, 30, 1.5169843513131496 },
+  { RHCP, 8.4, 60, 1.2862022312559567 },
+  { RHCP, 8.4, 90, 1.0759983457110165 },
+  { RHCP, 12, 10, 3.0634878778236669 },
+  { RHCP, 12, 30, 3.6951079579836117 },
+  { RHCP, 12, 60, 3.5480915872745005 },
+  { RHCP, 12, 90, 3.0085974634028911 },
+  { RHCP, 20, 10, 7.2584984812100943 },
+  { RHCP, 20, 30, 9.202486246552775 },
+  { RHCP, 20, 60, 10.196735382360238 },
+  { RHCP, 20, 90, 8.8749552166688197 },
+  { RHCP, 30, 10, 13.080403095524403 },
+  { RHCP, 30, 30, 32.136516518545506 },
+  { RHCP, 30, 60, 20.587467077407609 },
+  { RHCP, 30, 90, 18.227036702358838 },
+  { LINEAR_VERTICAL, 2.4, 10, 0.015028189884117388 },
+  { LINEAR_VERTICAL, 2.4, 30, 0.016775640674795686 },
+  { LINEAR_VERTICAL, 2.4, 60, 0.023002585068931457 },
+  { LINEAR_VERTICAL, 2.4, 90, 0.0089674302030509669 },
+  { LINEAR_VERTICAL, 8.4, 10, 1.1931096901069789 },
+  { LINEAR_VERTICAL, 8.4, 30, 1.3978123554763868 },
+  { LINEAR_VERTICAL, 8.4, 60, 1.1779122123836872 },
+  { LINEAR_VERTICAL, 8.4, 90, 0.98837895280013488 },
+  { LINEAR_VERTICAL, 12, 10, 2.8655682317407014 },
+  { LINEAR_VERTICAL, 12, 30, 3.468733602788499 },
+  { LINEAR_VERTICAL, 12, 60, 3.303896536161453 },
+  { LINEAR_VERTICAL, 12, 90, 2.8076491825353802 },
+  { LINEAR_VERTICAL, 20, 10, 6.7612080464194051 },
+  { LINEAR_VERTICAL, 20, 30, 8.5911599055084427 },
+  { LINEAR_VERTICAL, 20, 60, 9.3948065228373441 },
+  { LINEAR_VERTICAL, 20, 90, 8.1915670870457902 },
+  { LINEAR_VERTICAL, 30, 10, 12.26352794501822 },
+  { LINEAR_VERTICAL, 30, 30, 29.663778644422074 },
+  { LINEAR_VERTICAL, 30, 60, 19.042459998504746 },
+  { LINEAR_VERTICAL, 30, 90, 16.878977567781821 },
+  { LINEAR_HORIZONTAL, 2.4, 10, 0.019209730798104611 },
+  { LINEAR_HORIZONTAL, 2.4, 30, 0.020973950350275768 },
+  { LINEAR_HORIZONTAL, 2.4, 60, 0.027833315778147377 },
+  { LINEAR_HORIZONTAL, 2.4, 90, 0.011007790691669765 },
+  { LINEAR_HORIZONTAL, 8.4, 10, 1.4101791889014634 },
+  { LINEAR_HORIZONTAL, 8.4, 30, 1.6332141987865989 },
+  { LINEAR_HORIZONTAL, 8.4, 60, 1.3927575352376531 },
+  { LINEAR_HORIZONTAL, 8.4, 90, 1.161899574439089 },
+  { LINEAR_HORIZONTAL, 12, 10, 3.2805263610335027 },
+  { LINEAR_HORIZONTAL, 12, 30, 3.9420276702878101 },
+  { LINEAR_HORIZONTAL, 12, 60, 3.8175354128006016 },
+  { LINEAR_HORIZONTAL, 12, 90, 3.2296761495380375 },
+  { LINEAR_HORIZONTAL, 20, 10, 7.818701558697609 },
+  { LINEAR_HORIZONTAL, 20, 30, 9.8887934464096681 },
+  { LINEAR_HORIZONTAL, 20, 60, 11.113745872505561 },
+  { LINEAR_HORIZONTAL, 20, 90, 9.6544054064969842 },
+  { LINEAR_HORIZONTAL, 30, 10, 13.910194414044097 },
+  { LINEAR_HORIZONTAL, 30, 30, 34.700808288102991 },
+  { LINEAR_HORIZONTAL, 30, 60, 22.184926986661775 },
+  { LINEAR_HORIZONTAL, 30, 90, 19.618540937327374 }
+};
+
+} // namespace
+
+/* Keep the grid caches of the tests out of the user cache directory */
+using qa::temp_cache_dir;
+BOOST_TEST_GLOBAL_FIXTURE(temp_cache_dir);
+
+BOOST_AUTO_TEST_CASE(t_precipitation_custom_reference,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::precipitation_itu::make(25, gs_lon, gs_lat, gs_alt,
+                                         PRECIPITATION_CUSTOM);
+  for (const rain_reference_t &r : rain_reference) {
+    generic_attenuation::set_frequency(r.freq_ghz * 1e9);
+    generic_attenuation::set_polarization(r.polarization);
+    generic_attenuation::set_elevation_angle(
+      utils::degrees_to_radians(r.elevation_deg));
+    BOOST_TEST_CONTEXT("pol=" << r.polarization << ", f=" << r.freq_ghz
+                       << " GHz, el=" << r.elevation_deg) {
+      BOOST_CHECK_CLOSE(att->get_attenuation(), r.attenuation_db, TOLERANCE);
+    }
+  }
+}
+
+/*
+ * The batch evaluation shares the frequency dependent coefficients across
+ * the elevation angles and must agree with the scalar one
+ */
+BOOST_AUTO_TEST_CASE(t_precipitation_batch,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::precipitation_itu::make(25, gs_lon, gs_lat, gs_alt,
+                                         PRECIPITATION_CUSTOM);
+  const size_t n = sizeof(rain_reference) / sizeof(rain_reference[0]);
+  for (size_t i = 0; i < n; i += 4) {
+    const rain_reference_t &r = rain_reference[i];
+    std::vector<double> elevation;
+    for (size_t j = i; j < i + 4; j++) {
+      elevation.push_back(
+        utils::degrees_to_radians(rain_reference[j].elevation_deg));
+    }
+    generic_attenuation::set_frequency(r.freq_ghz * 1e9);
+    generic_attenuation::set_polarization(r.polarization);
+    generic_attenuation::set_elevation_angle(0.1);
+    const std::vector<double> res = att->get_attenuation_batch(elevation);
+    BOOST_TEST_CONTEXT("pol=" << r.polarization << ", f=" << r.freq_ghz) {
+      BOOST_REQUIRE_EQUAL(res.size(), 4);
+      for (size_t j = 0; j < 4; j++) {
+        BOOST_CHECK_CLOSE(res[j], rain_reference[i + j].attenuation_db,
+                          TOLERANCE);
+      }
+      /* The static elevation angle is left intact */
+      BOOST_CHECK_CLOSE(att->get_attenuation(),
+                        att->get_attenuation_batch({0.1})[0], TOLERANCE);
+    }
+  }
+}
+
+/*
+ * The statistical mode must reproduce the P.618 exceedance probabilities.
+ * The samples are drawn far apart relative to the time constant of the
+ * fade, so they are practically independent.
+ */
+BOOST_AUTO_TEST_CASE(t_precipitation_statistical_exceedance,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  const double rain_probability = 5;
+  generic_attenuation::generic_attenuation_sptr fixed =
+    attenuation::precipitation_itu::make(25, gs_lon, gs_lat, gs_alt,
+                                         PRECIPITATION_CUSTOM);
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::precipitation_itu::make(25, gs_lon, gs_lat, gs_alt,
+                                         PRECIPITATION_STATISTICAL,
+                                         rain_probability, 1.0, 1234);
+  generic_attenuation::set_frequency(12e9);
+  generic_attenuation::set_polarization(RHCP);
+  generic_attenuation::set_elevation_angle(utils::degrees_to_radians(30));
+
+  /* P.618 step 10, the latitude of the station is below 36 degrees */
+  const double a001 = fixed->get_attenuation();
+  const double p = 1;
+  const double a1 = a001 * std::pow(p / 0.01, -(0.655 + 0.033 * std::log(p)
+                                    - 0.045 * std::log(a001)));
+
+  const size_t n = 200000;
+  size_t rain = 0;
+  size_t exceeded = 0;
+  for (size_t i = 0; i < n; i++) {
+    generic_attenuation::set_time(i * 100.0);
+    const double a = att->get_attenuation();
+    rain += a > 0;
+    exceeded += a > a1;
+  }
+  BOOST_CHECK_CLOSE(100.0 * rain / n, rain_probability, 5);
+  BOOST_CHECK_CLOSE(100.0 * exceeded / n, p, 10);
+}
+
+/* The fade is time correlated and does not change without a time step */
+BOOST_AUTO_TEST_CASE(t_precipitation_statistical_correlation,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::precipitation_itu::make(25, gs_lon, gs_lat, gs_alt,
+                                         PRECIPITATION_STATISTICAL, 5, 2e-4,
+                                         1234);
+  generic_attenuation::set_frequency(12e9);
+  generic_attenuation::set_polarization(RHCP);
+  generic_attenuation::set_elevation_angle(utils::degrees_to_radians(30));
+
+  /* Lag one autocorrelation of the attenuation */
+  const size_t n = 500000;
+  double prev = 0;
+  double sum = 0;
+  double sum2 = 0;
+  double sum_lag = 0;
+  for (size_t i = 0; i < n; i++) {
+    generic_attenuation::set_time(i * 1.0);
+    const double a = att->get_attenuation();
+    BOOST_REQUIRE_EQUAL(att->get_attenuation(), a);
+    sum += a;
+    sum2 += a * a;
+    sum_lag += a * prev;
+    prev = a;
+  }
+  const double mean = sum / n;
+  const double var = sum2 / n - mean * mean;
+  BOOST_REQUIRE_GT(var, 0);
+  BOOST_CHECK_GT((sum_lag / (n - 1) - mean * mean) / var, 0.99);
+}
+
+BOOST_AUTO_TEST_CASE(t_precipitation_statistical_invalid)
+{
+  BOOST_CHECK_THROW(attenuation::precipitation_itu::make(25, gs_lon, gs_lat,
+                    gs_alt, PRECIPITATION_STATISTICAL, 10),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(attenuation::precipitation_itu::make(25, gs_lon, gs_lat,
+                    gs_alt, PRECIPITATION_STATISTICAL, 5, 0),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(t_topography,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  const std::filesystem::path dir = std::filesystem::path(gr::prefix())
+                                    / GR_LEO_REL_DATA_PATH / "ITU_RREC_P1511";
+  utils::itu_grid::sptr topo = utils::itu_grid::load(
+                                 (dir / "TOPOLAT.txt").string(),
+                                 (dir / "TOPOLON.txt").string(),
+                                 (dir / "TOPO_0DOT5.txt").string());
+  /* The same map is shared */
+  BOOST_CHECK_EQUAL(topo, utils::itu_grid::load(
+                      (dir / "TOPOLAT.txt").string(),
+                      (dir / "TOPOLON.txt").string(),
+                      (dir / "TOPO_0DOT5.txt").string()));
+  BOOST_CHECK_EQUAL(topo->rows(), 363);
+  BOOST_CHECK_EQUAL(topo->cols(), 723);
+
+  /* Grid points and their midpoint, in both longitude conventions */
+  BOOST_CHECK_CLOSE(topo->value(29.5, 91.0), 4.383, 1e-4);
+  BOOST_CHECK_CLOSE(topo->value(29.0, 91.5), 4.600, 1e-4);
+  BOOST_CHECK_CLOSE(topo->value(29.5, 91.0 - 360), 4.383, 1e-4);
+  BOOST_CHECK_CLOSE(topo->value(29.25, 91.25),
+                    (4.383 + 4.478 + 4.709 + 4.600) / 4, 1e-4);
+
+  /* The binary cache is written under the cache directory of the tests */
+  BOOST_CHECK(!std::filesystem::is_empty(
+                std::filesystem::path(std::getenv("XDG_CACHE_HOME")) / "gr-leo"));
+
+  /* The height of the P.1511 map at Madrid replaces the given altitude */
+  generic_attenuation::generic_attenuation_sptr from_map =
+    attenuation::precipitation_itu::make(25, -3.7, 40.4, 0,
+                                         PRECIPITATION_CUSTOM, 5.0, 2e-4, 0,
+                                         true);
+  generic_attenuation::generic_attenuation_sptr explicit_alt =
+    attenuation::precipitation_itu::make(25, -3.7, 40.4,
+                                         topo->value(40.4, -3.7),
+                                         PRECIPITATION_CUSTOM);
+  generic_attenuation::set_frequency(30e9);
+  generic_attenuation::set_polarization(RHCP);
+  generic_attenuation::set_elevation_angle(utils::degrees_to_radians(30));
+  BOOST_CHECK_GT(topo->value(40.4, -3.7), 0.3);
+  BOOST_CHECK_GT(from_map->get_attenuation(), 0);
+  BOOST_CHECK_EQUAL(from_map->get_attenuation(),
+                    explicit_alt->get_attenuation());
+
+  /* A station below the mean sea level keeps its given altitude */
+  generic_attenuation::generic_attenuation_sptr below_sea =
+    attenuation::precipitation_itu::make(25, -3.7, 40.4, -0.4,
+                                         PRECIPITATION_CUSTOM);
+  BOOST_CHECK_NE(below_sea->get_attenuation(), from_map->get_attenuation());
+}
+
+BOOST_AUTO_TEST_CASE(t_precipitation_no_rain,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  /* A ground station above the rain height never suffers rain attenuation */
+  generic_attenuation::generic_attenuation_sptr att =
+    attenuation::precipitation_itu::make(25, gs_lon, gs_lat, 10,
+                                         PRECIPITATION_CUSTOM);
+  generic_attenuation::set_frequency(12e9);
+  generic_attenuation::set_polarization(RHCP);
+  generic_attenuation::set_elevation_angle(utils::degrees_to_radians(30));
+  BOOST_CHECK_EQUAL(att->get_attenuation(), 0.0);
+}
+
+} /* namespace leo */
+} /* namespace gr */
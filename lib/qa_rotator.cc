@@ -0,0 +1,170 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Validates the rotator against hand computed slews and its pointing error
+ * on synthetic passes through the zenith and the north stop.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/leo/antenna_pointing_loss.h>
+#include <gnuradio/leo/dipole_antenna.h>
+#include <gnuradio/leo/rotator.h>
+#include <gnuradio/leo/yagi_antenna.h>
+#include <gnuradio/leo/utils/helper.h>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+const double TOLERANCE = 1e-9;
+
+/*
+ * Tracks a pass through the zenith that moves by 1 degree per second, from
+ * \p az0 at the horizon to the opposite azimuth, and returns the maximum
+ * pointing error of the rotator
+ */
+double
+max_error_of_pass(rotator::rotator_sptr rot, double az0)
+{
+  double max_error = 0;
+  for (double t = 0; t <= 180; t += 0.1) {
+    const double el = t <= 90 ? t : 180 - t;
+    const double az = t <= 90 ? az0 : az0 + 180;
+    rot->update(t, std::fmod(az, 360.0), el);
+    max_error = std::max(max_error, rot->get_pointing_error());
+  }
+  return max_error;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t_rotator_slew)
+{
+  rotator::rotator_sptr rot = rotator::make(6, 6, 0, 0.5);
+
+  /* The antenna starts on the satellite */
+  rot->update(0, 10, 20);
+  BOOST_CHECK_SMALL(rot->get_pointing_error(), TOLERANCE);
+  BOOST_CHECK_CLOSE(rot->get_azimuth(), 10, TOLERANCE);
+  BOOST_CHECK_CLOSE(rot->get_elevation(), 20, TOLERANCE);
+
+  /*
+   * The command of t = 0.5 s is interpolated to 25 degrees and the rotator
+   * slews by 3 degrees until t = 1 s, when the command is 40 degrees
+   */
+  rot->update(1, 40, 20);
+  BOOST_CHECK_CLOSE(rot->get_azimuth(), 13, TOLERANCE);
+  BOOST_CHECK_CLOSE(rot->get_elevation(), 20, TOLERANCE);
+  const double el = utils::degrees_to_radians(20);
+  const double daz = utils::degrees_to_radians(27);
+  BOOST_CHECK_CLOSE(rot->get_pointing_error(),
+                    utils::radians_to_degrees(std::acos(std::sin(el) * std::sin(el)
+                        + std::cos(el) * std::cos(el) * std::cos(daz))), 1e-6);
+
+  /* Then it reaches the satellite */
+  rot->update(10, 40, 20);
+  BOOST_CHECK_SMALL(rot->get_pointing_error(), 1e-6);
+
+  /* Going back in time restarts the rotator on the satellite */
+  rot->update(5, 200, 45);
+  BOOST_CHECK_SMALL(rot->get_pointing_error(), TOLERANCE);
+  BOOST_CHECK_CLOSE(rot->get_azimuth(), 200, TOLERANCE);
+}
+
+BOOST_AUTO_TEST_CASE(t_rotator_backlash)
+{
+  rotator::rotator_sptr rot = rotator::make(100, 100, 2, 0.25);
+  rot->update(0, 100, 10);
+  rot->update(1, 110, 10);
+  rot->update(2, 110, 10);
+  /* The antenna lags the motor by half the backlash */
+  BOOST_CHECK_CLOSE(rot->get_azimuth(), 109, TOLERANCE);
+  BOOST_CHECK_GT(rot->get_pointing_error(), 0.9);
+  /* And by the other half after the reversal */
+  rot->update(3, 105, 10);
+  rot->update(4, 105, 10);
+  BOOST_CHECK_CLOSE(rot->get_azimuth(), 106, TOLERANCE);
+}
+
+BOOST_AUTO_TEST_CASE(t_rotator_keyhole)
+{
+  /* Through the zenith the azimuth has to turn by 180 degrees */
+  BOOST_CHECK_GT(max_error_of_pass(rotator::make(6, 6, 0, 0.5), 90), 10);
+  /* Unless the mount flips over */
+  BOOST_CHECK_LT(max_error_of_pass(rotator::make(6, 6, 0, 0.5, 360, 180), 90),
+                 1);
+}
+
+BOOST_AUTO_TEST_CASE(t_rotator_north_stop)
+{
+  /* Northwards pass from the south, that crosses the north stop */
+  rotator::rotator_sptr rot = rotator::make(6, 6, 0, 0.5);
+  rotator::rotator_sptr overlap = rotator::make(6, 6, 0, 0.5, 450);
+  double max_error = 0;
+  double max_error_overlap = 0;
+  for (double t = 0; t <= 60; t += 0.1) {
+    const double az = std::fmod(330 + t, 360.0);
+    rot->update(t, az, 30);
+    overlap->update(t, az, 30);
+    max_error = std::max(max_error, rot->get_pointing_error());
+    max_error_overlap = std::max(max_error_overlap,
+                                 overlap->get_pointing_error());
+  }
+  BOOST_CHECK_GT(max_error, 10);
+  BOOST_CHECK_LT(max_error_overlap, 1);
+  BOOST_CHECK_GT(overlap->get_azimuth(), 360);
+}
+
+BOOST_AUTO_TEST_CASE(t_rotator_invalid)
+{
+  BOOST_CHECK_THROW(rotator::make(0, 6), std::invalid_argument);
+  BOOST_CHECK_THROW(rotator::make(6, 6, -1), std::invalid_argument);
+  BOOST_CHECK_THROW(rotator::make(6, 6, 0, 0), std::invalid_argument);
+  BOOST_CHECK_THROW(rotator::make(6, 6, 0, 1, 300), std::invalid_argument);
+  BOOST_CHECK_THROW(rotator::make(6, 6, 0, 1, 360, 200), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(t_rotator_pointing_loss)
+{
+  const double freq = 435e6;
+  generic_antenna::generic_antenna_sptr gs_ant =
+    antenna::yagi_antenna::make(YAGI, freq, RHCP, 1, 2.35);
+  generic_antenna::generic_antenna_sptr sat_ant =
+    antenna::dipole_antenna::make(DIPOLE, freq, LINEAR_VERTICAL, 0);
+  rotator::rotator_sptr rot = rotator::make(6, 6, 0, 0.5);
+  generic_attenuation::generic_attenuation_sptr loss =
+    attenuation::antenna_pointing_loss::make(gs_ant, sat_ant,
+        ANTENNA_POINTING_LOSS, rot);
+
+  rot->update(0, 10, 20);
+  rot->update(1, 40, 20);
+  BOOST_CHECK_CLOSE(loss->get_attenuation(),
+                    gs_ant->get_gain_rolloff(utils::degrees_to_radians(
+                                               1 + rot->get_pointing_error()), 0), TOLERANCE);
+}
+
+} /* namespace leo */
+} /* namespace gr */
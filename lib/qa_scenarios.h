@@ -0,0 +1,143 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Fixtures shared by the unit tests of the scenario based drivers.
+ */
+
+#ifndef INCLUDED_LEO_QA_SCENARIOS_H
+#define INCLUDED_LEO_QA_SCENARIOS_H
+
+#include <gnuradio/leo/scenario.h>
+#include "utils/itu_grid.h"
+#include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+namespace gr {
+namespace leo {
+namespace qa {
+
+/*!
+ * \brief The ISS over the ground station of the UPSAT example at Chania,
+ * for a 10 minutes pass with 1 second steps. The tests select the
+ * impairments.
+ */
+inline scenario_t
+upsat_scenario()
+{
+  scenario_t s;
+  s.name = "upsat";
+  s.tle_title = "ISS";
+  s.tle_1 =
+    "1 25544U 98067A   18268.52547184  .00016717  00000-0  10270-3 0  9019";
+  s.tle_2 =
+    "2 25544  51.6373 238.6885 0003885 206.9748 153.1203 15.53729445 14114";
+  s.gs_lat = 35.3333;
+  s.gs_lon = 25.1833;
+  s.gs_alt = 0.1;
+  s.gs_antenna.type = YAGI;
+  s.gs_antenna.polarization = RHCP;
+  s.gs_antenna.params[0] = 2.35;
+  s.obs_start = "2018-09-25T15:48:25";
+  s.obs_end = "2018-09-25T15:58:35";
+  s.time_step_us = 1e6;
+  return s;
+}
+
+/*!
+ * \brief Check for the ITU-R maps of the precipitation models. CTest reads
+ * them from the source tree, otherwise they are available only after the
+ * installation of the module.
+ */
+inline bool
+itu_maps_installed()
+{
+  const std::filesystem::path p = std::filesystem::path(utils::data_path())
+                                  / "ITU_RREC_P839" / "Lat.txt";
+  return std::filesystem::exists(p);
+}
+
+/*!
+ * \brief Precondition of the tests that need the ITU-R maps, so they are
+ * reported as skipped instead of passing without a check
+ */
+inline boost::test_tools::assertion_result
+itu_maps(boost::unit_test::test_unit_id)
+{
+  boost::test_tools::assertion_result res(itu_maps_installed());
+  res.message() << "the ITU-R maps are not available";
+  return res;
+}
+
+/*!
+ * \brief Points the cache of the ITU maps and the antenna patterns at a
+ * temporary directory, for the lifetime of the object. Use it as a global
+ * fixture, so the tests never write to the cache directory of the user.
+ */
+class temp_cache_dir {
+public:
+  temp_cache_dir()
+  {
+    std::string dir = (std::filesystem::temp_directory_path()
+                       / "gr-leo-qa-XXXXXX").string();
+    if (!mkdtemp(&dir[0])) {
+      throw std::runtime_error("Could not create a temporary cache directory");
+    }
+    d_dir = dir;
+    const char *prev = std::getenv("XDG_CACHE_HOME");
+    d_has_prev = prev != nullptr;
+    if (d_has_prev) {
+      d_prev = prev;
+    }
+    setenv("XDG_CACHE_HOME", d_dir.c_str(), 1);
+  }
+
+  ~temp_cache_dir()
+  {
+    if (d_has_prev) {
+      setenv("XDG_CACHE_HOME", d_prev.c_str(), 1);
+    }
+    else {
+      unsetenv("XDG_CACHE_HOME");
+    }
+    std::error_code ec;
+    std::filesystem::remove_all(d_dir, ec);
+  }
+
+  const std::string &
+  path() const
+  {
+    return d_dir;
+  }
+
+private:
+  std::string d_dir;
+  std::string d_prev;
+  bool d_has_prev;
+};
+
+} // namespace qa
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_QA_SCENARIOS_H */
@@ -0,0 +1,297 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Validates the parameter sweep: the grouping of the points by the cached
+ * stages they share, and the link margin against a LEO model built for
+ * each point.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/leo/sweep.h>
+#include "qa_scenarios.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* The UPSAT pass with the geometric pointing loss and the rain */
+scenario_t
+iss_scenario()
+{
+  scenario_t s = qa::upsat_scenario();
+  s.pointing = ANTENNA_POINTING_LOSS_GEOMETRIC;
+  s.precipitation = PRECIPITATION_CUSTOM;
+  return s;
+}
+
+/* Tolerance of the link margin in dB */
+const double MARGIN_TOLERANCE = 1e-6;
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t_sweep_grid)
+{
+  const std::vector<scenario_t> points = sweep::grid(iss_scenario(), {
+    {SWEEP_SAT_TX_POWER, {20, 30}},
+    {SWEEP_GS_ANTENNA, {1, 2, 3}},
+    {SWEEP_FREQUENCY, {145.8e6, 435e6}}
+  });
+  BOOST_REQUIRE_EQUAL(points.size(), 12);
+  /* The last axis varies the fastest */
+  BOOST_CHECK_EQUAL(points[0].sat_tx_power_dbm, 20);
+  BOOST_CHECK_EQUAL(points[0].gs_antenna.params[0], 1);
+  BOOST_CHECK_EQUAL(points[0].downlink_freq, 145.8e6);
+  BOOST_CHECK_EQUAL(points[1].downlink_freq, 435e6);
+  BOOST_CHECK_EQUAL(points[1].uplink_freq, 435e6);
+  BOOST_CHECK_EQUAL(points[2].gs_antenna.params[0], 2);
+  BOOST_CHECK_EQUAL(points[11].sat_tx_power_dbm, 30);
+  BOOST_CHECK_EQUAL(points[11].gs_antenna.params[0], 3);
+
+  /* The powers and the antennas share both the geometry and the attenuation */
+  sweep::sweep_sptr sw = sweep::make(points);
+  BOOST_CHECK_EQUAL(sw->get_geometry_count(), 1);
+  BOOST_CHECK_EQUAL(sw->get_attenuation_count(), 2);
+
+  sw = sweep::make(sweep::grid(iss_scenario(), {
+    {SWEEP_GS_LATITUDE, {35, 36}},
+    {SWEEP_RAINFALL_RATE, {10, 20, 30}}
+  }));
+  BOOST_CHECK_EQUAL(sw->get_geometry_count(), 2);
+  BOOST_CHECK_EQUAL(sw->get_attenuation_count(), 6);
+
+  BOOST_CHECK_THROW(sweep::grid(iss_scenario(), {{SWEEP_GS_TX_POWER, {}}}),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(sw->get_results(), std::runtime_error);
+}
+
+/* The passes of each point match those of its own tracker */
+BOOST_AUTO_TEST_CASE(t_sweep_passes)
+{
+  scenario_t base = iss_scenario();
+  base.obs_start = "2018-09-25T00:00:00";
+  base.obs_end = "2018-09-26T00:00:00";
+  const std::vector<scenario_t> points = sweep::grid(base, {
+    {SWEEP_GS_LATITUDE, {35, 50}},
+    {SWEEP_SAT_TX_POWER, {20, 30}}
+  });
+  sweep::sweep_sptr sw = sweep::make(points);
+  const std::vector<std::vector<pass_info_t>> passes = sw->get_passes(60, 3);
+  BOOST_REQUIRE_EQUAL(passes.size(), points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    const std::vector<pass_info_t> ref =
+      scenario::make_tracker(points[i])->generate_passes(60);
+    BOOST_REQUIRE(!ref.empty());
+    BOOST_REQUIRE_EQUAL(passes[i].size(), ref.size());
+    for (size_t k = 0; k < ref.size(); k++) {
+      BOOST_CHECK_EQUAL(passes[i][k].aos, ref[k].aos);
+      BOOST_CHECK_EQUAL(passes[i][k].los, ref[k].los);
+      BOOST_CHECK_EQUAL(passes[i][k].max_elevation, ref[k].max_elevation);
+    }
+  }
+  BOOST_CHECK_THROW(sw->get_passes(0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(t_sweep_matches_model,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  const std::vector<scenario_t> points = sweep::grid(iss_scenario(), {
+    {SWEEP_SAT_TX_POWER, {27, 30}},
+    {SWEEP_GS_POINTING_ERROR, {0, 5}},
+    {SWEEP_FREQUENCY, {145.8e6, 435e6}}
+  });
+  sweep::sweep_sptr sw = sweep::make(points, 10);
+  sw->run(4);
+  const std::vector<sweep_result_t> results = sw->get_results();
+
+  for (size_t i = 0; i < points.size(); i++) {
+    const std::vector<double> margin = sw->get_link_margin(i);
+    const link_timeline_t all = sw->get_timeline(i, false);
+    const link_timeline_t visible_steps = sw->get_timeline(i);
+    BOOST_REQUIRE_EQUAL(all.link_margin.size(), margin.size());
+    BOOST_CHECK_EQUAL(visible_steps.link_margin.size(),
+                      results[i].visible_steps);
+    generic_model::generic_model_sptr model = scenario::make_model(points[i]);
+    tracker::tracker_sptr trk = model->get_tracker();
+
+    size_t k = 0;
+    size_t visible = 0;
+    double min_margin = INFINITY;
+    while (!trk->is_observation_over()) {
+      BOOST_REQUIRE_LT(k, margin.size());
+      const model_state_t state = model->get_state();
+      BOOST_CHECK_EQUAL(state.aos, !std::isnan(margin[k]));
+      if (state.aos) {
+        BOOST_CHECK_SMALL(margin[k] - state.link_margin_db, MARGIN_TOLERANCE);
+        BOOST_CHECK_SMALL(all.doppler_shift[k] - state.doppler_shift, 1e-6);
+        min_margin = std::min(min_margin, state.link_margin_db);
+        visible++;
+      }
+      model->advance_time(points[i].time_step_us);
+      k++;
+    }
+    BOOST_CHECK_EQUAL(k, margin.size());
+    BOOST_CHECK_EQUAL(results[i].visible_steps, visible);
+    BOOST_CHECK_SMALL(results[i].min_link_margin - min_margin,
+                      MARGIN_TOLERANCE);
+  }
+
+  /* The transmission power shifts the link margin by the same amount */
+  for (size_t i = 0; i < points.size() / 2; i++) {
+    const sweep_result_t &lo = results[i];
+    const sweep_result_t &hi = results[i + points.size() / 2];
+    BOOST_CHECK_SMALL(hi.mean_link_margin - lo.mean_link_margin - 3, 1e-9);
+    BOOST_CHECK(hi.outage_fraction <= lo.outage_fraction);
+  }
+}
+
+/*
+ * The statistical rain fade of the sweep must follow the one of a LEO model
+ * with the same seed, so both must advance it by the same elapsed time.
+ * The observation spans a day, long relative to the time constant of the
+ * fade, and several seeds are used so that some of them rain.
+ */
+BOOST_AUTO_TEST_CASE(t_sweep_statistical_matches_model,
+                     *boost::unit_test::precondition(qa::itu_maps))
+{
+  scenario_t base = qa::upsat_scenario();
+  base.precipitation = PRECIPITATION_STATISTICAL;
+  base.obs_end = "2018-09-26T15:48:25";
+  base.time_step_us = 60e6;
+  std::vector<scenario_t> points;
+  for (unsigned int seed = 1; seed <= 8; seed++) {
+    base.seed = seed;
+    points.push_back(base);
+  }
+  sweep::sweep_sptr sw = sweep::make(points);
+  BOOST_CHECK_EQUAL(sw->get_attenuation_count(), points.size());
+  sw->run(4);
+
+  size_t rain = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    const link_timeline_t all = sw->get_timeline(i, false);
+    generic_model::generic_model_sptr model = scenario::make_model(points[i]);
+    tracker::tracker_sptr trk = model->get_tracker();
+
+    size_t k = 0;
+    while (!trk->is_observation_over()) {
+      BOOST_REQUIRE_LT(k, all.link_margin.size());
+      const model_state_t state = model->get_state();
+      if (state.aos) {
+        BOOST_CHECK_SMALL(all.attenuation[k] - state.total_attenuation,
+                          MARGIN_TOLERANCE);
+        BOOST_CHECK_SMALL(all.link_margin[k] - state.link_margin_db,
+                          MARGIN_TOLERANCE);
+        rain += state.rainfall_attenuation > 0;
+      }
+      model->advance_time(points[i].time_step_us);
+      k++;
+    }
+    BOOST_CHECK_EQUAL(k, all.link_margin.size());
+  }
+  BOOST_CHECK(rain > 0);
+}
+
+BOOST_AUTO_TEST_CASE(t_scenario_load)
+{
+  const std::filesystem::path filename =
+    std::filesystem::temp_directory_path() / "qa_scenario_load.ini";
+  {
+    std::ofstream f(filename);
+    f << "# Two satellites over one station\n"
+      << "[observation]\n"
+      << "start = 2018-09-25T15:48:25\n"
+      << "end = 2018-09-25T15:58:35 ; ten minutes\n"
+      << "time_step_us = 5e5\n"
+      << "downlink_freq = 145.8e6\n"
+      << "pointing = ANTENNA_POINTING_LOSS_GEOMETRIC\n"
+      << "precipitation = 4\n"
+      << "rain_probability = 2.5\n"
+      << "fade_dynamics = 1e-3\n"
+      << "[satellite ISS]\n"
+      << "tle1 = " << iss_scenario().tle_1 << "\n"
+      << "tle2 = " << iss_scenario().tle_2 << "\n"
+      << "antenna = dipole\n"
+      << "polarization = LINEAR_VERTICAL\n"
+      << "[satellite ISS2]\n"
+      << "tle1 = " << iss_scenario().tle_1 << "\n"
+      << "tle2 = " << iss_scenario().tle_2 << "\n"
+      << "tx_power_dbm = 33\n"
+      << "[station Chania]\n"
+      << "lat = 35.3333\n"
+      << "lon = 25.1833\n"
+      << "alt = 0.1\n"
+      << "antenna = YAGI\n"
+      << "antenna_params = 2.35\n";
+  }
+  const std::vector<scenario_t> s = scenario::load(filename.string());
+  BOOST_REQUIRE_EQUAL(s.size(), 2);
+  BOOST_CHECK_EQUAL(s[0].name, "ISS_Chania");
+  BOOST_CHECK_EQUAL(s[1].name, "ISS2_Chania");
+  BOOST_CHECK_EQUAL(s[0].obs_end, "2018-09-25T15:58:35");
+  BOOST_CHECK_EQUAL(s[0].time_step_us, 5e5);
+  BOOST_CHECK_EQUAL(s[0].downlink_freq, 145.8e6);
+  BOOST_CHECK_EQUAL(s[0].pointing, ANTENNA_POINTING_LOSS_GEOMETRIC);
+  BOOST_CHECK_EQUAL(s[1].rain_probability, 2.5);
+  BOOST_CHECK_EQUAL(s[1].fade_dynamics, 1e-3);
+  BOOST_CHECK_EQUAL(s[0].precipitation, PRECIPITATION_CUSTOM);
+  BOOST_CHECK_EQUAL(s[0].sat_antenna.type, DIPOLE);
+  BOOST_CHECK_EQUAL(s[0].sat_antenna.polarization, LINEAR_VERTICAL);
+  BOOST_CHECK_EQUAL(s[1].sat_tx_power_dbm, 33);
+  BOOST_CHECK_EQUAL(s[1].tle_2, iss_scenario().tle_2);
+  BOOST_CHECK_EQUAL(s[1].gs_lat, 35.3333);
+  BOOST_CHECK_EQUAL(s[1].gs_antenna.type, YAGI);
+  BOOST_CHECK_EQUAL(s[1].gs_antenna.params[0], 2.35);
+
+  {
+    std::ofstream f(filename);
+    f << "[observation]\n"
+      << "atmo = NO_SUCH_MODEL\n";
+  }
+  BOOST_CHECK_THROW(scenario::load(filename.string()), std::runtime_error);
+
+  {
+    std::ofstream f(filename);
+    f << "[satellite ISS]\n"
+      << "tle1 = " << iss_scenario().tle_1 << "\n"
+      << "tle2 = " << iss_scenario().tle_2 << "\n"
+      << "[station Chania]\n"
+      << "lat = 35.3333\n"
+      << "lon = 25.1833\n"
+      << "alt = auto\n";
+  }
+  const std::vector<scenario_t> topo = scenario::load(filename.string());
+  BOOST_REQUIRE_EQUAL(topo.size(), 1);
+  BOOST_CHECK(topo[0].gs_topographic_alt);
+  BOOST_CHECK(!s[0].gs_topographic_alt);
+  std::filesystem::remove(filename);
+}
+
+} // namespace leo
+} // namespace gr
@@ -0,0 +1,267 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Validates the pass prediction of the tracker against an exhaustive,
+ * one second step propagation of the same orbit. The AOS, LOS and maximum
+ * elevation of every predicted pass must agree with the exhaustive search
+ * within the tolerances below, whatever the search step of the prediction.
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/leo/tracker.h>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* The ISS over the ground station of the UPSAT example at Chania */
+const char *tle_title = "ISS";
+const char *tle_1 =
+  "1 25544U 98067A   18268.52547184  .00016717  00000-0  10270-3 0  9019";
+const char *tle_2 =
+  "2 25544  51.6373 238.6885 0003885 206.9748 153.1203 15.53729445 14114";
+const double gs_lat = 35.3333;
+const double gs_lon = 25.1833;
+const double gs_alt = 0.1;
+const char *obs_start = "2018-09-25T00:00:00";
+const char *obs_end = "2018-09-26T00:00:00";
+
+/* Tolerances of the AOS/LOS in seconds and of the maximum elevation in rad */
+const double TIME_TOLERANCE = 2.0;
+const double ELEVATION_TOLERANCE = 1e-3;
+
+typedef struct {
+  libsgp4::DateTime aos;
+  libsgp4::DateTime los;
+  double max_elevation;
+} pass_t;
+
+/* Parses the libSGP4 string representation, YYYY-MM-DD HH:MM:SS.ffffff UTC */
+libsgp4::DateTime
+parse_datetime(const std::string &s)
+{
+  int year, month, day, hour, minute, second, us;
+  BOOST_REQUIRE_EQUAL(sscanf(s.c_str(), "%d-%d-%d %d:%d:%d.%d", &year, &month,
+                             &day, &hour, &minute, &second, &us), 7);
+  return libsgp4::DateTime(year, month, day, hour, minute,
+                           second).AddMicroseconds(us);
+}
+
+std::vector<pass_t>
+predicted_passes(int time_step)
+{
+  tracker t(tle_title, tle_1, tle_2, gs_lat, gs_lon, gs_alt, obs_start,
+            obs_end);
+  std::vector<pass_t> passes;
+  for (const pass_details_t &p : t.generate_passlist(time_step)) {
+    passes.push_back({parse_datetime(p.aos), parse_datetime(p.los),
+                      p.max_elevation});
+  }
+  return passes;
+}
+
+/* The exact scalar reference: the elevation at every second */
+std::vector<pass_t>
+exhaustive_passes()
+{
+  tracker t(tle_title, tle_1, tle_2, gs_lat, gs_lon, gs_alt, obs_start,
+            obs_end);
+  std::vector<pass_t> passes;
+  const libsgp4::DateTime start = t.get_elapsed_time();
+  bool visible = false;
+  pass_t p;
+
+  for (int sec = 0; !t.is_observation_over(); sec++) {
+    t.set_elapsed_time(start.AddSeconds(sec));
+    const double elev = t.get_elevation_radians();
+    if (!visible && elev > 0.0) {
+      visible = true;
+      p.aos = t.get_elapsed_time();
+      p.max_elevation = elev;
+    }
+    else if (visible && elev < 0.0) {
+      visible = false;
+      p.los = t.get_elapsed_time();
+      passes.push_back(p);
+    }
+    else if (visible) {
+      p.max_elevation = std::max(p.max_elevation, elev);
+    }
+  }
+  if (visible) {
+    p.los = t.get_elapsed_time();
+    passes.push_back(p);
+  }
+  return passes;
+}
+
+void
+check_passes(const std::vector<pass_t> &predicted,
+             const std::vector<pass_t> &reference)
+{
+  BOOST_REQUIRE(!reference.empty());
+  BOOST_REQUIRE_EQUAL(predicted.size(), reference.size());
+  for (size_t i = 0; i < reference.size(); i++) {
+    BOOST_TEST_CONTEXT("pass " << i << " AOS " << reference[i].aos.ToString()) {
+      BOOST_CHECK_SMALL((predicted[i].aos - reference[i].aos).TotalSeconds(),
+                        TIME_TOLERANCE);
+      BOOST_CHECK_SMALL((predicted[i].los - reference[i].los).TotalSeconds(),
+                        TIME_TOLERANCE);
+      BOOST_CHECK_SMALL(predicted[i].max_elevation - reference[i].max_elevation,
+                        ELEVATION_TOLERANCE);
+      BOOST_CHECK(predicted[i].aos < predicted[i].los);
+    }
+  }
+}
+
+/* Converts the microseconds since the Unix epoch of pass_info_t */
+libsgp4::DateTime
+from_unix_us(int64_t us)
+{
+  return libsgp4::DateTime(libsgp4::UnixEpoch
+                           + us * libsgp4::TicksPerMicrosecond);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t_tracker_passlist_fine_step)
+{
+  check_passes(predicted_passes(10), exhaustive_passes());
+}
+
+BOOST_AUTO_TEST_CASE(t_tracker_passlist_coarse_step)
+{
+  check_passes(predicted_passes(60), exhaustive_passes());
+}
+
+/*
+ * The numeric passes must agree with the exhaustive search and with the
+ * string pass list, and the times and azimuths must match the geometry
+ */
+BOOST_AUTO_TEST_CASE(t_tracker_passes_numeric)
+{
+  tracker t(tle_title, tle_1, tle_2, gs_lat, gs_lon, gs_alt, obs_start,
+            obs_end);
+  const std::vector<pass_info_t> info = t.generate_passes(10);
+  std::vector<pass_t> passes;
+  for (const pass_info_t &p : info) {
+    passes.push_back({from_unix_us(p.aos), from_unix_us(p.los),
+                      p.max_elevation});
+  }
+  check_passes(passes, exhaustive_passes());
+
+  const std::vector<pass_details_t> details = t.generate_passlist(10);
+  BOOST_REQUIRE_EQUAL(details.size(), info.size());
+  for (size_t i = 0; i < info.size(); i++) {
+    const pass_info_t &p = info[i];
+    BOOST_TEST_CONTEXT("pass " << i << " AOS " << details[i].aos) {
+      BOOST_CHECK(from_unix_us(p.aos) == parse_datetime(details[i].aos));
+      BOOST_CHECK(from_unix_us(p.los) == parse_datetime(details[i].los));
+      BOOST_CHECK_EQUAL(p.max_elevation, details[i].max_elevation);
+
+      BOOST_CHECK_GE(p.max_elevation_time, p.aos);
+      BOOST_CHECK_LE(p.max_elevation_time, p.los);
+      t.set_elapsed_time(from_unix_us(p.max_elevation_time));
+      /* Only the sub-microsecond part of the time is lost */
+      BOOST_CHECK_SMALL(t.get_elevation_radians() - p.max_elevation, 1e-9);
+      t.set_elapsed_time(from_unix_us(p.aos));
+      BOOST_CHECK_EQUAL(t.get_azimuth_radians(), p.aos_azimuth);
+      t.set_elapsed_time(from_unix_us(p.los));
+      BOOST_CHECK_EQUAL(t.get_azimuth_radians(), p.los_azimuth);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(t_tracker_time_to_next_aos)
+{
+  const std::vector<pass_t> reference = exhaustive_passes();
+  BOOST_REQUIRE(!reference.empty());
+
+  tracker t(tle_title, tle_1, tle_2, gs_lat, gs_lon, gs_alt, obs_start,
+            obs_end);
+  t.generate_passlist(10);
+  const libsgp4::DateTime start = t.get_elapsed_time();
+
+  for (const pass_t &p : reference) {
+    /* One minute before the AOS */
+    const libsgp4::DateTime before = p.aos.AddSeconds(-60);
+    if (before > start) {
+      t.set_elapsed_time(before);
+      BOOST_CHECK_SMALL(t.get_time_to_next_aos_us() / 1e6 - 60.0,
+                        TIME_TOLERANCE);
+    }
+    /* In the middle of the pass */
+    t.set_elapsed_time(p.aos.AddSeconds((p.los - p.aos).TotalSeconds() / 2));
+    BOOST_CHECK_EQUAL(t.get_time_to_next_aos_us(), 0.0);
+  }
+}
+
+/*
+ * The batch geometry of a pass must match the scalar getters of a tracker
+ * that advances through the same time steps
+ */
+BOOST_AUTO_TEST_CASE(t_tracker_geometry_batch)
+{
+  tracker t(tle_title, tle_1, tle_2, gs_lat, gs_lon, gs_alt, obs_start,
+            obs_end);
+  const std::vector<pass_info_t> info = t.generate_passes(10);
+  BOOST_REQUIRE(!info.empty());
+  const libsgp4::DateTime aos = from_unix_us(info[0].aos);
+  const libsgp4::DateTime los = from_unix_us(info[0].los);
+
+  /* 10 second steps from the AOS, in seconds since the observation start */
+  const double offset = (aos - t.get_elapsed_time()).TotalSeconds();
+  const size_t n = static_cast<size_t>((los - aos).TotalSeconds() / 10) + 1;
+  std::vector<double> time(n);
+  for (size_t k = 0; k < n; k++) {
+    time[k] = offset + 10.0 * k;
+  }
+  std::vector<double> range(n);
+  std::vector<double> range_rate(n);
+  std::vector<double> azimuth(n);
+  std::vector<double> elevation(n);
+  const libsgp4::DateTime before = t.get_elapsed_time();
+  t.get_geometry_batch(time.data(), n, range.data(), range_rate.data(),
+                       azimuth.data(), elevation.data());
+  /* The batch leaves the elapsed time alone */
+  BOOST_CHECK(t.get_elapsed_time() == before);
+
+  t.set_elapsed_time(aos);
+  for (size_t k = 0; k < n; k++) {
+    BOOST_TEST_CONTEXT("t=" << t.get_elapsed_time().ToString()) {
+      BOOST_CHECK_SMALL(range[k] - t.get_slant_range(), 1e-4);
+      BOOST_CHECK_SMALL(range_rate[k] - t.get_velocity(), 1e-6);
+      BOOST_CHECK_SMALL(azimuth[k] - t.get_azimuth_degrees(), 1e-5);
+      BOOST_CHECK_SMALL(elevation[k] - t.get_elevation_degrees(), 1e-5);
+    }
+    t.advance_time(10e6);
+  }
+  /* The pass is above the horizon between its AOS and LOS */
+  BOOST_CHECK_GT(*std::max_element(elevation.begin(), elevation.end()), 0);
+}
+
+} /* namespace leo */
+} /* namespace gr */
@@ -49,6 +49,7 @@ quadrifilar_helix_antenna_impl::quadrifilar_helix_antenna_impl(antenna_t type,
   generic_antenna(QUADRIFILAR_HELIX, frequency, polarization, pointing_error),
   d_loop(loop)
 {
+  update_gain_rolloff();
   LEO_DEBUG("QUADRIFILAR HELIX");
   LEO_DEBUG("Maximum Gain: %f", get_gain());
   LEO_DEBUG("Beamwidth: %f", get_beamwidth());
@@ -67,8 +68,13 @@ quadrifilar_helix_antenna_impl::get_gain()
 double
 quadrifilar_helix_antenna_impl::get_gain_rolloff()
 {
-  double error_deg = utils::radians_to_degrees(d_pointing_error);
-  return -1.5 * (-4 + 10 * std::log10(1.256 * (1 + std::cos(d_pointing_error))));
+  return d_gain_rolloff;
+}
+
+double
+quadrifilar_helix_antenna_impl::get_gain_rolloff(double theta, double phi)
+{
+  return -1.5 * (-4 + 10 * std::log10(1.256 * (1 + std::cos(theta))));
 }
 
 double
@@ -69,6 +69,9 @@ public:
   double
   get_gain_rolloff();
 
+  double
+  get_gain_rolloff(double theta, double phi);
+
   /*!
    * \brief Get the beamwidth of the quadrifilar helix antenna. This is the implementation
    * of the parent's pure virtual function for the quadrifilar helix antenna.
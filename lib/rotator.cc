@@ -0,0 +1,236 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/leo/rotator.h>
+#include <gnuradio/leo/utils/helper.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* Longer gaps between two updates restart the rotator */
+const double max_gap_s = 60;
+
+/* The angle between two directions, given in degrees */
+double
+angle_between(double az1, double el1, double az2, double el2)
+{
+  const double a1 = utils::degrees_to_radians(az1);
+  const double e1 = utils::degrees_to_radians(el1);
+  const double a2 = utils::degrees_to_radians(az2);
+  const double e2 = utils::degrees_to_radians(el2);
+  const double x1 = std::cos(e1) * std::sin(a1);
+  const double y1 = std::cos(e1) * std::cos(a1);
+  const double z1 = std::sin(e1);
+  const double x2 = std::cos(e2) * std::sin(a2);
+  const double y2 = std::cos(e2) * std::cos(a2);
+  const double z2 = std::sin(e2);
+  const double cx = y1 * z2 - z1 * y2;
+  const double cy = z1 * x2 - x1 * z2;
+  const double cz = x1 * y2 - y1 * x2;
+  /* More accurate than the arc cosine for small angles */
+  return utils::radians_to_degrees(std::atan2(
+                                     std::sqrt(cx * cx + cy * cy + cz * cz),
+                                     x1 * x2 + y1 * y2 + z1 * z2));
+}
+
+} // namespace
+
+rotator::rotator_sptr
+rotator::make(const double max_az_rate, const double max_el_rate,
+              const double backlash, const double update_interval,
+              const double az_range, const double max_elevation)
+{
+  return rotator::rotator_sptr(
+           new rotator(max_az_rate, max_el_rate, backlash, update_interval,
+                       az_range, max_elevation));
+}
+
+rotator::rotator(const double max_az_rate, const double max_el_rate,
+                 const double backlash, const double update_interval,
+                 const double az_range, const double max_elevation) :
+  d_max_az_rate(max_az_rate),
+  d_max_el_rate(max_el_rate),
+  d_backlash(backlash),
+  d_update_interval(update_interval),
+  d_az_range(az_range),
+  d_max_elevation(max_elevation),
+  d_started(false),
+  d_time(0),
+  d_next_command(0),
+  d_target_az(0),
+  d_target_el(0),
+  d_motor_az(0),
+  d_motor_el(0),
+  d_antenna_az(0),
+  d_antenna_el(0),
+  d_command_az(0),
+  d_command_el(0),
+  d_pointing_error(0)
+{
+  if (max_az_rate <= 0 || max_el_rate <= 0) {
+    throw std::invalid_argument("rotator: the slew rates must be positive");
+  }
+  if (backlash < 0) {
+    throw std::invalid_argument("rotator: the backlash must not be negative");
+  }
+  if (update_interval <= 0) {
+    throw std::invalid_argument(
+      "rotator: the update interval must be positive");
+  }
+  if (az_range < 360) {
+    throw std::invalid_argument(
+      "rotator: the azimuth range must be at least 360 degrees");
+  }
+  if (max_elevation < 90 || max_elevation > 180) {
+    throw std::invalid_argument(
+      "rotator: the maximum elevation must be between 90 and 180 degrees");
+  }
+}
+
+rotator::~rotator()
+{
+}
+
+void
+rotator::reset()
+{
+  d_started = false;
+}
+
+void
+rotator::command(double azimuth, double elevation)
+{
+  const double el = std::clamp(elevation, 0.0, 90.0);
+  double best = std::numeric_limits<double>::infinity();
+
+  /* The direct and the flipped over position, at every azimuth turn */
+  for (int flip = 0; flip < 2; flip++) {
+    const double cmd_el = flip ? 180 - el : el;
+    if (cmd_el > d_max_elevation) {
+      continue;
+    }
+    double az = std::fmod(azimuth + (flip ? 180 : 0), 360.0);
+    if (az < 0) {
+      az += 360;
+    }
+    for (; az <= d_az_range; az += 360) {
+      const double t = std::max(std::abs(az - d_motor_az) / d_max_az_rate,
+                                std::abs(cmd_el - d_motor_el) / d_max_el_rate);
+      if (t < best) {
+        best = t;
+        d_command_az = az;
+        d_command_el = cmd_el;
+      }
+    }
+  }
+}
+
+void
+rotator::slew(double dt)
+{
+  const double max_az = d_max_az_rate * dt;
+  const double max_el = d_max_el_rate * dt;
+  d_motor_az += std::clamp(d_command_az - d_motor_az, -max_az, max_az);
+  d_motor_el += std::clamp(d_command_el - d_motor_el, -max_el, max_el);
+
+  /* The antenna follows the motor only outside of the backlash dead band */
+  const double play = d_backlash / 2;
+  d_antenna_az = std::clamp(d_antenna_az, d_motor_az - play,
+                            d_motor_az + play);
+  d_antenna_el = std::clamp(d_antenna_el, d_motor_el - play,
+                            d_motor_el + play);
+}
+
+void
+rotator::start(double time, double azimuth, double elevation)
+{
+  /* The antenna starts at the direct position of the satellite */
+  d_command_az = std::fmod(azimuth, 360.0);
+  if (d_command_az < 0) {
+    d_command_az += 360;
+  }
+  d_command_el = std::clamp(elevation, 0.0, 90.0);
+  d_motor_az = d_antenna_az = d_command_az;
+  d_motor_el = d_antenna_el = d_command_el;
+  d_time = time;
+  d_next_command = time + d_update_interval;
+  d_started = true;
+}
+
+void
+rotator::update(double time, double azimuth, double elevation)
+{
+  if (!d_started || time < d_time || time - d_time > max_gap_s) {
+    start(time, azimuth, elevation);
+  }
+  else {
+    const double t0 = d_time;
+    const double az0 = d_target_az;
+    const double el0 = d_target_el;
+    /* The shortest azimuth change, across the north if needed */
+    const double daz = std::remainder(azimuth - az0, 360.0);
+
+    while (d_next_command <= time) {
+      slew(d_next_command - d_time);
+      d_time = d_next_command;
+      const double w = (d_time - t0) / (time - t0);
+      command(az0 + w * daz, el0 + w * (elevation - el0));
+      d_next_command += d_update_interval;
+    }
+    slew(time - d_time);
+    d_time = time;
+  }
+
+  d_target_az = azimuth;
+  d_target_el = elevation;
+  d_pointing_error = angle_between(d_antenna_az, d_antenna_el, azimuth,
+                                   elevation);
+}
+
+double
+rotator::get_pointing_error() const
+{
+  return d_pointing_error;
+}
+
+double
+rotator::get_azimuth() const
+{
+  return d_antenna_az;
+}
+
+double
+rotator::get_elevation() const
+{
+  return d_antenna_el;
+}
+
+} /* namespace leo */
+} /* namespace gr */
@@ -76,7 +76,7 @@ satellite::~satellite()
 {
 }
 
-int satellite::base_unique_id = 1;
+std::atomic<int> satellite::base_unique_id(1);
 
 int
 satellite::unique_id()
@@ -0,0 +1,618 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/leo/custom_antenna.h>
+#include <gnuradio/leo/dipole_antenna.h>
+#include <gnuradio/leo/helix_antenna.h>
+#include <gnuradio/leo/leo_model.h>
+#include <gnuradio/leo/monopole_antenna.h>
+#include <gnuradio/leo/parabolic_reflector_antenna.h>
+#include <gnuradio/leo/pattern_antenna.h>
+#include <gnuradio/leo/quadrifilar_helix_antenna.h>
+#include <gnuradio/leo/satellite.h>
+#include <gnuradio/leo/scenario.h>
+#include <gnuradio/leo/yagi_antenna.h>
+#include "utils/itu_grid.h"
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace gr {
+namespace leo {
+namespace scenario {
+
+namespace {
+
+typedef struct {
+  const char *name;
+  int value;
+} enum_name_t;
+
+const enum_name_t impairment_names[] = {
+  {"IMPAIRMENT_NONE", IMPAIRMENT_NONE},
+  {"NONE", IMPAIRMENT_NONE},
+  {"ATMO_GASES_ITU", ATMO_GASES_ITU},
+  {"ATMO_GASES_REGRESSION", ATMO_GASES_REGRESSION},
+  {"ATMO_GASES_ITU_ANNEX2", ATMO_GASES_ITU_ANNEX2},
+  {"PRECIPITATION_ITU", PRECIPITATION_ITU},
+  {"PRECIPITATION_CUSTOM", PRECIPITATION_CUSTOM},
+  {"PRECIPITATION_STATISTICAL", PRECIPITATION_STATISTICAL},
+  {"FREE_SPACE_PATH_LOSS", FREE_SPACE_PATH_LOSS},
+  {"ANTENNA_POINTING_LOSS", ANTENNA_POINTING_LOSS},
+  {"ANTENNA_POINTING_LOSS_GEOMETRIC", ANTENNA_POINTING_LOSS_GEOMETRIC},
+  {"DOPPLER_SHIFT", DOPPLER_SHIFT},
+  {"TIME_COMPRESSION", TIME_COMPRESSION},
+  {nullptr, 0}
+};
+
+const enum_name_t antenna_names[] = {
+  {"YAGI", YAGI},
+  {"HELIX", HELIX},
+  {"PARABOLIC_REFLECTOR", PARABOLIC_REFLECTOR},
+  {"CANTED_TURNSTYLE", CANTED_TURNSTYLE},
+  {"CUSTOM", CUSTOM},
+  {"MONOPOLE", MONOPOLE},
+  {"DIPOLE", DIPOLE},
+  {"QUADRIFILAR_HELIX", QUADRIFILAR_HELIX},
+  {"PATTERN", PATTERN},
+  {nullptr, 0}
+};
+
+const enum_name_t polarization_names[] = {
+  {"RHCP", RHCP},
+  {"LHCP", LHCP},
+  {"LINEAR_VERTICAL", LINEAR_VERTICAL},
+  {"LINEAR_HORIZONTAL", LINEAR_HORIZONTAL},
+  {nullptr, 0}
+};
+
+const enum_name_t mode_names[] = {
+  {"UPLINK", UPLINK},
+  {"DOWNLINK", DOWNLINK},
+  {nullptr, 0}
+};
+
+/*!
+ * \brief The position in the scenario file, for the error messages
+ */
+class file_location {
+public:
+  file_location(const std::string &filename) :
+    d_filename(filename),
+    d_line(0)
+  {
+  }
+
+  void
+  next_line()
+  {
+    d_line++;
+  }
+
+  [[noreturn]] void
+  fail(const std::string &msg) const
+  {
+    std::ostringstream s;
+    s << "scenario: " << d_filename << ":" << d_line << ": " << msg;
+    throw std::runtime_error(s.str());
+  }
+
+private:
+  const std::string d_filename;
+  size_t d_line;
+};
+
+std::string
+trim(const std::string &s)
+{
+  const size_t b = s.find_first_not_of(" \t\r\n");
+  if (b == std::string::npos) {
+    return "";
+  }
+  const size_t e = s.find_last_not_of(" \t\r\n");
+  return s.substr(b, e - b + 1);
+}
+
+double
+parse_number(const std::string &value, const file_location &loc)
+{
+  char *end = nullptr;
+  const double v = std::strtod(value.c_str(), &end);
+  if (value.empty() || *end != '\0') {
+    loc.fail("Invalid number '" + value + "'");
+  }
+  return v;
+}
+
+int
+parse_enum(const std::string &value, const enum_name_t *names,
+           const file_location &loc)
+{
+  std::string upper(value);
+  for (char &c : upper) {
+    c = std::toupper(static_cast<unsigned char>(c));
+  }
+  for (const enum_name_t *n = names; n->name; n++) {
+    if (upper == n->name) {
+      return n->value;
+    }
+  }
+  char *end = nullptr;
+  const long v = std::strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0') {
+    loc.fail("Invalid enumeration '" + value + "'");
+  }
+  return static_cast<int>(v);
+}
+
+std::string
+resolve_path(const std::string &path, const std::string &filename)
+{
+  if (path.empty() || path[0] == '/') {
+    return path;
+  }
+  const size_t slash = filename.rfind('/');
+  if (slash == std::string::npos) {
+    return path;
+  }
+  return filename.substr(0, slash + 1) + path;
+}
+
+/*!
+ * \brief Set a key of the antenna, the transmitter or the receiver of a
+ * satellite or a station
+ * \return false if the key is not one of them
+ */
+bool
+set_endpoint_key(const std::string &key, const std::string &value,
+                 double &tx_power_dbm, antenna_config_t &antenna,
+                 double &noise_figure, double &noise_temp, double &rx_bw,
+                 const std::string &filename, const file_location &loc)
+{
+  if (key == "tx_power_dbm") {
+    tx_power_dbm = parse_number(value, loc);
+  }
+  else if (key == "antenna") {
+    antenna.type = static_cast<antenna_t>(parse_enum(value, antenna_names,
+                                          loc));
+  }
+  else if (key == "polarization") {
+    antenna.polarization = static_cast<polarization_t>(parse_enum(value,
+                           polarization_names, loc));
+  }
+  else if (key == "pointing_error") {
+    antenna.pointing_error = parse_number(value, loc);
+  }
+  else if (key == "antenna_params") {
+    std::string params(value);
+    for (char &c : params) {
+      if (c == ',') {
+        c = ' ';
+      }
+    }
+    std::istringstream in(params);
+    std::string p;
+    size_t i = 0;
+    while (in >> p) {
+      if (i == 3) {
+        loc.fail("At most 3 antenna parameters");
+      }
+      antenna.params[i++] = parse_number(p, loc);
+    }
+  }
+  else if (key == "pattern_file") {
+    antenna.pattern_file = resolve_path(value, filename);
+  }
+  else if (key == "noise_figure") {
+    noise_figure = parse_number(value, loc);
+  }
+  else if (key == "noise_temp") {
+    noise_temp = parse_number(value, loc);
+  }
+  else if (key == "rx_bw") {
+    rx_bw = parse_number(value, loc);
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+typedef struct {
+  std::string name;
+  scenario_t params;
+  std::string tle_file;
+} satellite_section_t;
+
+typedef struct {
+  std::string name;
+  scenario_t params;
+} station_section_t;
+
+/*!
+ * \brief Read the satellites of a TLE file, with or without title lines
+ */
+std::vector<satellite_section_t>
+load_tle_file(const satellite_section_t &section,
+              const std::string &filename)
+{
+  std::ifstream in(section.tle_file);
+  if (!in) {
+    throw std::runtime_error("scenario: Cannot open the TLE file "
+                             + section.tle_file);
+  }
+  std::vector<satellite_section_t> sats;
+  std::string title;
+  std::string line;
+  std::string line_1;
+  while (std::getline(in, line)) {
+    line = trim(line);
+    if (line.empty()) {
+      continue;
+    }
+    if (line.size() >= 69 && line.compare(0, 2, "1 ") == 0) {
+      line_1 = line;
+    }
+    else if (line.size() >= 69 && line.compare(0, 2, "2 ") == 0
+             && !line_1.empty()) {
+      satellite_section_t sat = section;
+      sat.name = title.empty() ? trim(line_1.substr(2, 5)) : title;
+      sat.params.tle_title = sat.name;
+      sat.params.tle_1 = line_1;
+      sat.params.tle_2 = line;
+      sats.push_back(sat);
+      title.clear();
+      line_1.clear();
+    }
+    else {
+      title = line.compare(0, 2, "0 ") == 0 ? trim(line.substr(2)) : line;
+    }
+  }
+  if (sats.empty()) {
+    throw std::runtime_error("scenario: No TLE in " + section.tle_file
+                             + " of " + filename);
+  }
+  return sats;
+}
+
+} // namespace
+
+generic_antenna::generic_antenna_sptr
+make_antenna(const antenna_config_t &config, double frequency)
+{
+  const double *p = config.params;
+  switch (config.type) {
+  case YAGI:
+    return antenna::yagi_antenna::make(YAGI, frequency, config.polarization,
+                                       config.pointing_error, p[0]);
+  case HELIX:
+    return antenna::helix_antenna::make(HELIX, frequency, config.polarization,
+                                        config.pointing_error,
+                                        static_cast<size_t>(p[0]), p[1], p[2]);
+  case PARABOLIC_REFLECTOR:
+    return antenna::parabolic_reflector_antenna::make(PARABOLIC_REFLECTOR,
+           frequency, config.polarization, config.pointing_error, p[0], p[1]);
+  case CUSTOM:
+    return antenna::custom_antenna::make(CUSTOM, frequency, config.polarization,
+                                         config.pointing_error, p[0], p[1],
+                                         p[2]);
+  case MONOPOLE:
+    return antenna::monopole_antenna::make(MONOPOLE, frequency,
+                                           config.polarization,
+                                           config.pointing_error);
+  case DIPOLE:
+    return antenna::dipole_antenna::make(DIPOLE, frequency, config.polarization,
+                                         config.pointing_error);
+  case QUADRIFILAR_HELIX:
+    return antenna::quadrifilar_helix_antenna::make(QUADRIFILAR_HELIX,
+           frequency, config.polarization, config.pointing_error, p[0]);
+  case PATTERN:
+    return antenna::pattern_antenna::make(PATTERN, frequency,
+                                          config.polarization,
+                                          config.pointing_error,
+                                          config.pattern_file);
+  default:
+    throw std::invalid_argument("scenario: Unsupported antenna type");
+  }
+}
+
+tracker::tracker_sptr
+make_tracker(const scenario_t &scenario)
+{
+  const scenario_t &s = scenario;
+  generic_antenna::generic_antenna_sptr sat_tx_ant =
+    make_antenna(s.sat_antenna, s.downlink_freq);
+  generic_antenna::generic_antenna_sptr sat_rx_ant =
+    make_antenna(s.sat_antenna, s.uplink_freq);
+  generic_antenna::generic_antenna_sptr gs_tx_ant =
+    make_antenna(s.gs_antenna, s.uplink_freq);
+  generic_antenna::generic_antenna_sptr gs_rx_ant =
+    make_antenna(s.gs_antenna, s.downlink_freq);
+
+  satellite::satellite_sptr sat = satellite::make(s.tle_title, s.tle_1,
+                                  s.tle_2, s.downlink_freq, s.uplink_freq,
+                                  s.sat_tx_power_dbm, sat_tx_ant, sat_rx_ant,
+                                  s.sat_noise_figure, s.sat_noise_temp,
+                                  s.sat_rx_bw);
+  const double gs_alt = s.gs_topographic_alt
+                        ? utils::topographic_altitude(s.gs_lat, s.gs_lon)
+                        : s.gs_alt;
+  return tracker::make(sat, s.gs_lat, s.gs_lon, gs_alt, s.obs_start,
+                       s.obs_end, s.time_step_us, s.uplink_freq,
+                       s.downlink_freq, s.gs_tx_power_dbm, gs_tx_ant,
+                       gs_rx_ant, s.gs_noise_figure, s.gs_noise_temp,
+                       s.gs_rx_bw);
+}
+
+generic_model::generic_model_sptr
+make_model(const scenario_t &scenario, tracker::tracker_sptr tracker)
+{
+  const scenario_t &s = scenario;
+  if (!tracker) {
+    tracker = make_tracker(s);
+  }
+  return model::leo_model::make(tracker, s.mode, s.fspl, s.pointing,
+                                s.doppler, s.atmo, s.precipitation, true,
+                                s.surface_watervap_density, s.temperature,
+                                s.rainfall_rate, IMPAIRMENT_NONE, nullptr,
+                                nullptr, s.seed, s.rain_probability,
+                                s.fade_dynamics, s.gs_topographic_alt);
+}
+
+std::vector<scenario_t>
+load(const std::string &filename)
+{
+  std::ifstream in(filename);
+  if (!in) {
+    throw std::runtime_error("scenario: Cannot open " + filename);
+  }
+
+  enum {
+    SECTION_NONE, SECTION_OBSERVATION, SECTION_SATELLITE, SECTION_STATION
+  } section = SECTION_NONE;
+  scenario_t base;
+  std::vector<satellite_section_t> satellites;
+  std::vector<station_section_t> stations;
+  file_location loc(filename);
+  std::string line;
+
+  while (std::getline(in, line)) {
+    loc.next_line();
+    const size_t comment = line.find_first_of("#;");
+    if (comment != std::string::npos) {
+      line.erase(comment);
+    }
+    line = trim(line);
+    if (line.empty()) {
+      continue;
+    }
+
+    if (line[0] == '[') {
+      if (line.back() != ']') {
+        loc.fail("Invalid section header");
+      }
+      std::istringstream header(line.substr(1, line.size() - 2));
+      std::string kind;
+      std::string name;
+      header >> kind;
+      std::getline(header, name);
+      name = trim(name);
+      if (kind == "observation") {
+        section = SECTION_OBSERVATION;
+      }
+      else if (kind == "satellite" || kind == "station") {
+        if (name.empty()) {
+          loc.fail("Missing " + kind + " name");
+        }
+        if (kind == "satellite") {
+          section = SECTION_SATELLITE;
+          satellites.push_back(satellite_section_t());
+          satellites.back().name = name;
+          satellites.back().params.tle_title = name;
+        }
+        else {
+          section = SECTION_STATION;
+          stations.push_back(station_section_t());
+          stations.back().name = name;
+        }
+      }
+      else {
+        loc.fail("Unknown section '" + kind + "'");
+      }
+      continue;
+    }
+
+    const size_t eq = line.find('=');
+    if (eq == std::string::npos) {
+      loc.fail("Expected key = value");
+    }
+    const std::string key = trim(line.substr(0, eq));
+    const std::string value = trim(line.substr(eq + 1));
+
+    if (section == SECTION_OBSERVATION) {
+      scenario_t &s = base;
+      if (key == "start") {
+        s.obs_start = value;
+      }
+      else if (key == "end") {
+        s.obs_end = value;
+      }
+      else if (key == "time_step_us") {
+        s.time_step_us = parse_number(value, loc);
+      }
+      else if (key == "uplink_freq") {
+        s.uplink_freq = parse_number(value, loc);
+      }
+      else if (key == "downlink_freq") {
+        s.downlink_freq = parse_number(value, loc);
+      }
+      else if (key == "mode") {
+        s.mode = static_cast<link_mode_t>(parse_enum(value, mode_names, loc));
+      }
+      else if (key == "fspl") {
+        s.fspl = static_cast<impairment_enum_t>(parse_enum(value,
+                                                impairment_names, loc));
+      }
+      else if (key == "pointing") {
+        s.pointing = static_cast<impairment_enum_t>(parse_enum(value,
+                     impairment_names, loc));
+      }
+      else if (key == "doppler") {
+        s.doppler = static_cast<impairment_enum_t>(parse_enum(value,
+                    impairment_names, loc));
+      }
+      else if (key == "atmo") {
+        s.atmo = static_cast<impairment_enum_t>(parse_enum(value,
+                                                impairment_names, loc));
+      }
+      else if (key == "precipitation") {
+        s.precipitation = static_cast<impairment_enum_t>(parse_enum(value,
+                          impairment_names, loc));
+      }
+      else if (key == "surface_watervap_density") {
+        s.surface_watervap_density = parse_number(value, loc);
+      }
+      else if (key == "temperature") {
+        s.temperature = parse_number(value, loc);
+      }
+      else if (key == "rainfall_rate") {
+        s.rainfall_rate = parse_number(value, loc);
+      }
+      else if (key == "rain_probability") {
+        s.rain_probability = parse_number(value, loc);
+      }
+      else if (key == "fade_dynamics") {
+        s.fade_dynamics = parse_number(value, loc);
+      }
+      else if (key == "seed") {
+        s.seed = static_cast<unsigned int>(parse_number(value, loc));
+      }
+      else {
+        loc.fail("Unknown observation key '" + key + "'");
+      }
+    }
+    else if (section == SECTION_SATELLITE) {
+      satellite_section_t &sat = satellites.back();
+      scenario_t &s = sat.params;
+      if (key == "tle1") {
+        s.tle_1 = value;
+      }
+      else if (key == "tle2") {
+        s.tle_2 = value;
+      }
+      else if (key == "tle_file") {
+        sat.tle_file = resolve_path(value, filename);
+      }
+      else if (!set_endpoint_key(key, value, s.sat_tx_power_dbm,
+                                 s.sat_antenna, s.sat_noise_figure,
+                                 s.sat_noise_temp, s.sat_rx_bw, filename,
+                                 loc)) {
+        loc.fail("Unknown satellite key '" + key + "'");
+      }
+    }
+    else if (section == SECTION_STATION) {
+      scenario_t &s = stations.back().params;
+      if (key == "lat") {
+        s.gs_lat = parse_number(value, loc);
+      }
+      else if (key == "lon") {
+        s.gs_lon = parse_number(value, loc);
+      }
+      else if (key == "alt") {
+        s.gs_topographic_alt = value == "auto";
+        if (!s.gs_topographic_alt) {
+          s.gs_alt = parse_number(value, loc);
+        }
+      }
+      else if (!set_endpoint_key(key, value, s.gs_tx_power_dbm,
+                                 s.gs_antenna, s.gs_noise_figure,
+                                 s.gs_noise_temp, s.gs_rx_bw, filename,
+                                 loc)) {
+        loc.fail("Unknown station key '" + key + "'");
+      }
+    }
+    else {
+      loc.fail("Key outside of a section");
+    }
+  }
+
+  if (base.obs_start.empty() || base.obs_end.empty()) {
+    throw std::runtime_error("scenario: " + filename
+                             + ": Missing observation start or end");
+  }
+  if (satellites.empty() || stations.empty()) {
+    throw std::runtime_error("scenario: " + filename
+                             + ": At least one satellite and one station are needed");
+  }
+
+  std::vector<satellite_section_t> sats;
+  for (const satellite_section_t &sat : satellites) {
+    if (!sat.tle_file.empty()) {
+      const std::vector<satellite_section_t> f = load_tle_file(sat, filename);
+      sats.insert(sats.end(), f.begin(), f.end());
+    }
+    else if (sat.params.tle_1.empty() || sat.params.tle_2.empty()) {
+      throw std::runtime_error("scenario: " + filename + ": Satellite "
+                               + sat.name + " has no TLE");
+    }
+    else {
+      sats.push_back(sat);
+    }
+  }
+
+  std::vector<scenario_t> scenarios;
+  scenarios.reserve(sats.size() * stations.size());
+  for (const satellite_section_t &sat : sats) {
+    for (const station_section_t &gs : stations) {
+      scenario_t s(base);
+      const scenario_t &p = sat.params;
+      const scenario_t &g = gs.params;
+      s.name = sat.name + "_" + gs.name;
+      s.tle_title = p.tle_title;
+      s.tle_1 = p.tle_1;
+      s.tle_2 = p.tle_2;
+      s.sat_tx_power_dbm = p.sat_tx_power_dbm;
+      s.sat_antenna = p.sat_antenna;
+      s.sat_noise_figure = p.sat_noise_figure;
+      s.sat_noise_temp = p.sat_noise_temp;
+      s.sat_rx_bw = p.sat_rx_bw;
+      s.gs_lat = g.gs_lat;
+      s.gs_lon = g.gs_lon;
+      s.gs_alt = g.gs_alt;
+      s.gs_tx_power_dbm = g.gs_tx_power_dbm;
+      s.gs_antenna = g.gs_antenna;
+      s.gs_noise_figure = g.gs_noise_figure;
+      s.gs_noise_temp = g.gs_noise_temp;
+      s.gs_rx_bw = g.gs_rx_bw;
+      scenarios.push_back(s);
+    }
+  }
+  return scenarios;
+}
+
+} // namespace scenario
+} // namespace leo
+} // namespace gr
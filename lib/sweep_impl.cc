@@ -0,0 +1,527 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "sweep_impl.h"
+#include "utils/parallel_for.h"
+#include <gnuradio/leo/antenna_pointing_loss.h>
+#include <gnuradio/leo/atmospheric_gases_itu.h>
+#include <gnuradio/leo/atmospheric_gases_itu_annex2.h>
+#include <gnuradio/leo/atmospheric_gases_regression.h>
+#include <gnuradio/leo/free_space_path_loss.h>
+#include <gnuradio/leo/log.h>
+#include <gnuradio/leo/precipitation_itu.h>
+#include <gnuradio/leo/utils/helper.h>
+#include <libsgp4/TimeSpan.h>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace gr {
+namespace leo {
+
+namespace {
+
+/* The elevation in degrees above which the LEO model reports AOS */
+const double AOS_ELEVATION = 1.0;
+
+double
+link_frequency(const scenario_t &s)
+{
+  return s.mode == UPLINK ? s.uplink_freq : s.downlink_freq;
+}
+
+} // namespace
+
+sweep::sweep_sptr
+sweep::make(const std::vector<scenario_t> &points, double outage_threshold_db)
+{
+  return sweep::sweep_sptr(new sweep_impl(points, outage_threshold_db));
+}
+
+void
+sweep::set_param(scenario_t &scenario, sweep_param_t param, double value)
+{
+  switch (param) {
+  case SWEEP_SAT_TX_POWER:
+    scenario.sat_tx_power_dbm = value;
+    break;
+  case SWEEP_GS_TX_POWER:
+    scenario.gs_tx_power_dbm = value;
+    break;
+  case SWEEP_SAT_ANTENNA:
+    scenario.sat_antenna.params[0] = value;
+    break;
+  case SWEEP_GS_ANTENNA:
+    scenario.gs_antenna.params[0] = value;
+    break;
+  case SWEEP_GS_POINTING_ERROR:
+    scenario.gs_antenna.pointing_error = value;
+    break;
+  case SWEEP_NOISE_FIGURE:
+    if (scenario.mode == UPLINK) {
+      scenario.sat_noise_figure = value;
+    }
+    else {
+      scenario.gs_noise_figure = value;
+    }
+    break;
+  case SWEEP_FREQUENCY:
+    scenario.uplink_freq = value;
+    scenario.downlink_freq = value;
+    break;
+  case SWEEP_RAINFALL_RATE:
+    scenario.rainfall_rate = value;
+    break;
+  case SWEEP_GS_LATITUDE:
+    scenario.gs_lat = value;
+    break;
+  case SWEEP_GS_LONGITUDE:
+    scenario.gs_lon = value;
+    break;
+  case SWEEP_GS_ALTITUDE:
+    scenario.gs_alt = value;
+    scenario.gs_topographic_alt = false;
+    break;
+  default:
+    throw std::invalid_argument("sweep: Invalid sweep parameter");
+  }
+}
+
+std::vector<scenario_t>
+sweep::grid(const scenario_t &base, const std::vector<sweep_axis_t> &axes)
+{
+  std::vector<scenario_t> points(1, base);
+  for (const sweep_axis_t &axis : axes) {
+    if (axis.values.empty()) {
+      throw std::invalid_argument("sweep: Empty sweep axis");
+    }
+    std::vector<scenario_t> next;
+    next.reserve(points.size() * axis.values.size());
+    for (const scenario_t &p : points) {
+      for (double v : axis.values) {
+        next.push_back(p);
+        set_param(next.back(), axis.param, v);
+      }
+    }
+    points.swap(next);
+  }
+  return points;
+}
+
+sweep_impl::sweep_impl(const std::vector<scenario_t> &points,
+                       double outage_threshold_db) :
+  d_points(points),
+  d_outage_threshold_db(outage_threshold_db),
+  d_point_attenuation(points.size()),
+  d_results(points.size()),
+  d_computed(false)
+{
+  if (points.empty()) {
+    throw std::invalid_argument("sweep: No sweep points");
+  }
+
+  /* Group the points by the inputs of each cached stage */
+  std::map<std::string, size_t> geometries;
+  std::map<std::string, size_t> attenuations;
+  for (size_t i = 0; i < points.size(); i++) {
+    if (!(points[i].time_step_us > 0)) {
+      throw std::invalid_argument("sweep: Invalid time step");
+    }
+    auto g = geometries.emplace(geometry_key(points[i]), d_geometries.size());
+    if (g.second) {
+      d_geometries.push_back(geometry_timeline());
+      d_geometries.back().point = i;
+    }
+    auto a = attenuations.emplace(attenuation_key(points[i]),
+                                  d_attenuations.size());
+    if (a.second) {
+      d_attenuations.push_back(attenuation_timeline());
+      d_attenuations.back().point = i;
+      d_attenuations.back().geometry = g.first->second;
+    }
+    d_point_attenuation[i] = a.first->second;
+  }
+}
+
+sweep_impl::~sweep_impl()
+{
+}
+
+std::string
+sweep_impl::geometry_key(const scenario_t &s)
+{
+  std::ostringstream key;
+  key.precision(17);
+  key << s.tle_1 << '\n' << s.tle_2 << '\n' << s.gs_lat << ' ' << s.gs_lon
+      << ' ' << s.gs_alt << ' ' << s.gs_topographic_alt << ' ' << s.obs_start
+      << ' ' << s.obs_end << ' ' << s.time_step_us;
+  return key.str();
+}
+
+std::string
+sweep_impl::attenuation_key(const scenario_t &s)
+{
+  std::ostringstream key;
+  key.precision(17);
+  key << geometry_key(s) << '\n' << link_frequency(s) << ' '
+      << s.gs_antenna.polarization << ' ' << s.fspl << ' ' << s.atmo << ' '
+      << s.precipitation << ' ' << s.surface_watervap_density << ' '
+      << s.temperature << ' ' << s.rainfall_rate;
+  /* Only the statistical rain fade is random */
+  if (s.precipitation == PRECIPITATION_STATISTICAL) {
+    key << ' ' << s.rain_probability << ' ' << s.fade_dynamics << ' '
+        << s.seed;
+  }
+  return key.str();
+}
+
+void
+sweep_impl::compute_geometry(geometry_timeline &g) const
+{
+  const scenario_t &s = d_points[g.point];
+  tracker::tracker_sptr trk = scenario::make_tracker(s);
+
+  /* The same time steps as a LEO model of the scenario */
+  const int64_t start = trk->get_elapsed_time().Ticks();
+  std::vector<double> time;
+  g.ticks.clear();
+  while (!trk->is_observation_over()) {
+    const int64_t t = trk->get_elapsed_time().Ticks();
+    g.ticks.push_back(t);
+    time.push_back(static_cast<double>(t - start) / libsgp4::TicksPerSecond);
+    trk->advance_time(s.time_step_us);
+  }
+
+  const size_t n = time.size();
+  g.slant_range.resize(n);
+  g.range_rate.resize(n);
+  g.azimuth.resize(n);
+  g.elevation.resize(n);
+  trk->get_geometry_batch(time.data(), n, g.slant_range.data(),
+                          g.range_rate.data(), g.azimuth.data(),
+                          g.elevation.data());
+}
+
+void
+sweep_impl::compute_attenuation(attenuation_timeline &a) const
+{
+  const scenario_t &s = d_points[a.point];
+  const geometry_timeline &g = d_geometries[a.geometry];
+
+  generic_attenuation::generic_attenuation_sptr atmo;
+  generic_attenuation::generic_attenuation_sptr precipitation;
+  generic_attenuation::generic_attenuation_sptr fspl;
+  switch (s.atmo) {
+  case ATMO_GASES_ITU:
+    atmo = attenuation::atmospheric_gases_itu::make(
+             s.surface_watervap_density);
+    break;
+  case ATMO_GASES_REGRESSION:
+    atmo = attenuation::atmospheric_gases_regression::make(
+             s.surface_watervap_density, s.temperature);
+    break;
+  case ATMO_GASES_ITU_ANNEX2:
+    atmo = attenuation::atmospheric_gases_itu_annex2::make(
+             s.surface_watervap_density, s.temperature);
+    break;
+  case IMPAIRMENT_NONE:
+    break;
+  default:
+    throw std::runtime_error("Invalid atmospheric gases attenuation!");
+  }
+  switch (s.precipitation) {
+  case PRECIPITATION_ITU:
+  case PRECIPITATION_CUSTOM:
+  case PRECIPITATION_STATISTICAL:
+    precipitation = attenuation::precipitation_itu::make(s.rainfall_rate,
+                    s.gs_lon, s.gs_lat, s.gs_alt, s.precipitation,
+                    s.rain_probability, s.fade_dynamics, s.seed,
+                    s.gs_topographic_alt);
+    break;
+  case IMPAIRMENT_NONE:
+    break;
+  default:
+    throw std::runtime_error("Invalid precipitation attenuation!");
+  }
+  switch (s.fspl) {
+  case FREE_SPACE_PATH_LOSS:
+    fspl = attenuation::free_space_path_loss::make();
+    break;
+  case IMPAIRMENT_NONE:
+    break;
+  default:
+    throw std::runtime_error("Invalid free-space path loss enumeration!");
+  }
+
+  /*
+   * The rain fade process evolves with time, so it is advanced through the
+   * whole observation, as in the LEO model. The rest only need the visible
+   * time steps.
+   */
+  const bool every_step = s.precipitation == PRECIPITATION_STATISTICAL;
+  const size_t n = g.ticks.size();
+  a.loss.assign(n, std::numeric_limits<double>::quiet_NaN());
+  generic_attenuation::set_frequency(link_frequency(s));
+  generic_attenuation::set_polarization(s.gs_antenna.polarization);
+  for (size_t k = 0; k < n; k++) {
+    const bool visible = g.elevation[k] > AOS_ELEVATION;
+    if (!visible && !every_step) {
+      continue;
+    }
+    generic_attenuation::set_elevation_angle(
+      utils::degrees_to_radians(g.elevation[k]));
+    generic_attenuation::set_slant_range(g.slant_range[k]);
+    generic_attenuation::set_time(static_cast<double>(g.ticks[k])
+                                  / libsgp4::TicksPerSecond);
+
+    /* The same order of summation as the LEO model */
+    double loss = 0;
+    if (atmo) {
+      loss += atmo->get_attenuation();
+    }
+    if (precipitation) {
+      loss += precipitation->get_attenuation();
+    }
+    if (fspl) {
+      loss += fspl->get_attenuation();
+    }
+    if (visible) {
+      a.loss[k] = loss;
+    }
+  }
+}
+
+sweep_result_t
+sweep_impl::evaluate(size_t point, std::vector<double> *margin,
+                     std::vector<double> *loss) const
+{
+  const scenario_t &s = d_points[point];
+  const attenuation_timeline &a = d_attenuations[d_point_attenuation[point]];
+  const geometry_timeline &g = d_geometries[a.geometry];
+  const bool uplink = s.mode == UPLINK;
+  const double freq = link_frequency(s);
+
+  generic_antenna::generic_antenna_sptr gs_antenna =
+    scenario::make_antenna(s.gs_antenna, freq);
+  generic_antenna::generic_antenna_sptr sat_antenna =
+    scenario::make_antenna(s.sat_antenna, freq);
+  const double sat_gain = sat_antenna->get_gain();
+  const double gs_gain = gs_antenna->get_gain();
+  const double tx_power_dbw = (uplink ? s.gs_tx_power_dbm :
+                               s.sat_tx_power_dbm) - 30;
+  const double noise_temp = uplink ? s.sat_noise_temp : s.gs_noise_temp;
+  const double noise_figure = uplink ? s.sat_noise_figure :
+                              s.gs_noise_figure;
+  const double rx_bw = uplink ? s.sat_rx_bw : s.gs_rx_bw;
+  const double noise_floor = 10 * log10(1.38e-23 * noise_temp * 1e3)
+                             + noise_figure + 10 * log10(rx_bw) - 30.0;
+
+  generic_attenuation::generic_attenuation_sptr pointing;
+  switch (s.pointing) {
+  case ANTENNA_POINTING_LOSS:
+  case ANTENNA_POINTING_LOSS_GEOMETRIC:
+    pointing = attenuation::antenna_pointing_loss::make(gs_antenna,
+               sat_antenna, s.pointing);
+    break;
+  case IMPAIRMENT_NONE:
+    break;
+  default:
+    throw std::runtime_error("Invalid antenna pointing loss enumeration!");
+  }
+  /* Only the geometric pointing loss depends on the time step */
+  const bool geometric = s.pointing == ANTENNA_POINTING_LOSS_GEOMETRIC;
+  double pointing_loss = (pointing && !geometric) ?
+                         pointing->get_attenuation() : 0;
+
+  const size_t n = g.ticks.size();
+  if (margin) {
+    margin->assign(n, std::numeric_limits<double>::quiet_NaN());
+  }
+  if (loss) {
+    loss->assign(n, std::numeric_limits<double>::quiet_NaN());
+  }
+  sweep_result_t res;
+  res.min_link_margin = std::numeric_limits<double>::quiet_NaN();
+  res.mean_link_margin = std::numeric_limits<double>::quiet_NaN();
+  res.max_link_margin = std::numeric_limits<double>::quiet_NaN();
+  double sum = 0;
+  uint64_t out = 0;
+  for (size_t k = 0; k < n; k++) {
+    if (std::isnan(a.loss[k])) {
+      continue;
+    }
+    if (geometric) {
+      generic_attenuation::set_elevation_angle(
+        utils::degrees_to_radians(g.elevation[k]));
+      generic_attenuation::set_slant_range(g.slant_range[k]);
+      pointing_loss = pointing->get_attenuation();
+    }
+    /* The same evaluation as link_margin::calc_link_margin() */
+    const double total = a.loss[k] + pointing_loss;
+    const double lm = tx_power_dbw - total + sat_gain + gs_gain - noise_floor;
+    if (margin) {
+      (*margin)[k] = lm;
+    }
+    if (loss) {
+      (*loss)[k] = total;
+    }
+    if (res.visible_steps == 0) {
+      res.min_link_margin = lm;
+      res.max_link_margin = lm;
+    }
+    res.visible_steps++;
+    res.min_link_margin = std::min(res.min_link_margin, lm);
+    res.max_link_margin = std::max(res.max_link_margin, lm);
+    sum += lm;
+    if (lm < d_outage_threshold_db) {
+      out++;
+    }
+  }
+  if (res.visible_steps) {
+    res.mean_link_margin = sum / res.visible_steps;
+    res.outage_fraction = static_cast<double>(out) / res.visible_steps;
+  }
+  return res;
+}
+
+void
+sweep_impl::run(size_t nthreads)
+{
+  utils::parallel_for(d_geometries.size(),
+                      utils::worker_count(d_geometries.size(), nthreads),
+  [this](size_t i, size_t) {
+    compute_geometry(d_geometries[i]);
+  });
+  utils::parallel_for(d_attenuations.size(),
+                      utils::worker_count(d_attenuations.size(), nthreads),
+  [this](size_t i, size_t) {
+    compute_attenuation(d_attenuations[i]);
+  });
+  utils::parallel_for(d_points.size(),
+                      utils::worker_count(d_points.size(), nthreads),
+  [this](size_t i, size_t) {
+    d_results[i] = evaluate(i, nullptr, nullptr);
+  });
+  d_computed = true;
+  LEO_DEBUG("sweep: %zu points, %zu geometries, %zu attenuation timelines",
+            d_points.size(), d_geometries.size(), d_attenuations.size());
+}
+
+std::vector<std::vector<pass_info_t>>
+sweep_impl::get_passes(int pass_step, size_t nthreads) const
+{
+  if (pass_step <= 0) {
+    throw std::invalid_argument("sweep: Invalid pass step");
+  }
+  std::vector<std::vector<pass_info_t>> geometry_passes(d_geometries.size());
+  utils::parallel_for(d_geometries.size(),
+                      utils::worker_count(d_geometries.size(), nthreads),
+  [&](size_t i, size_t) {
+    geometry_passes[i] = scenario::make_tracker(
+                           d_points[d_geometries[i].point])->generate_passes(pass_step);
+  });
+
+  std::vector<std::vector<pass_info_t>> passes(d_points.size());
+  for (size_t i = 0; i < d_points.size(); i++) {
+    passes[i] =
+      geometry_passes[d_attenuations[d_point_attenuation[i]].geometry];
+  }
+  return passes;
+}
+
+std::vector<sweep_result_t>
+sweep_impl::get_results() const
+{
+  if (!d_computed) {
+    throw std::runtime_error("sweep: The sweep has not run yet");
+  }
+  return d_results;
+}
+
+void
+sweep_impl::check_computed(size_t point) const
+{
+  if (!d_computed) {
+    throw std::runtime_error("sweep: The sweep has not run yet");
+  }
+  if (point >= d_points.size()) {
+    throw std::out_of_range("sweep: Invalid sweep point");
+  }
+}
+
+std::vector<double>
+sweep_impl::get_link_margin(size_t point) const
+{
+  check_computed(point);
+  std::vector<double> margin;
+  evaluate(point, &margin, nullptr);
+  return margin;
+}
+
+link_timeline_t
+sweep_impl::get_timeline(size_t point, bool visible_only) const
+{
+  check_computed(point);
+  const scenario_t &s = d_points[point];
+  const geometry_timeline &g =
+    d_geometries[d_attenuations[d_point_attenuation[point]].geometry];
+  std::vector<double> margin;
+  std::vector<double> loss;
+  evaluate(point, &margin, &loss);
+
+  const double freq = link_frequency(s);
+  link_timeline_t tl;
+  for (size_t k = 0; k < g.ticks.size(); k++) {
+    if (visible_only && std::isnan(margin[k])) {
+      continue;
+    }
+    tl.time.push_back((g.ticks[k] - libsgp4::UnixEpoch)
+                      / libsgp4::TicksPerMicrosecond);
+    tl.azimuth.push_back(g.azimuth[k]);
+    tl.elevation.push_back(g.elevation[k]);
+    tl.slant_range.push_back(g.slant_range[k]);
+    /* The same Doppler shift as the LEO model */
+    tl.doppler_shift.push_back((-1e3 * g.range_rate[k] * freq) / LIGHT_SPEED);
+    tl.attenuation.push_back(loss[k]);
+    tl.link_margin.push_back(margin[k]);
+  }
+  return tl;
+}
+
+size_t
+sweep_impl::get_geometry_count() const
+{
+  return d_geometries.size();
+}
+
+size_t
+sweep_impl::get_attenuation_count() const
+{
+  return d_attenuations.size();
+}
+
+} // namespace leo
+} // namespace gr
@@ -0,0 +1,113 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_SWEEP_IMPL_H
+#define INCLUDED_LEO_SWEEP_IMPL_H
+
+#include <gnuradio/leo/sweep.h>
+#include <cstdint>
+#include <string>
+
+namespace gr {
+namespace leo {
+
+class sweep_impl : public sweep {
+
+public:
+  sweep_impl(const std::vector<scenario_t> &points, double outage_threshold_db);
+
+  ~sweep_impl();
+
+  void
+  run(size_t nthreads);
+
+  std::vector<sweep_result_t>
+  get_results() const;
+
+  std::vector<double>
+  get_link_margin(size_t point) const;
+
+  link_timeline_t
+  get_timeline(size_t point, bool visible_only) const;
+
+  std::vector<std::vector<pass_info_t>>
+  get_passes(int pass_step, size_t nthreads) const;
+
+  size_t
+  get_geometry_count() const;
+
+  size_t
+  get_attenuation_count() const;
+
+private:
+  /*!
+   * \brief The geometry of the time steps of an observation
+   */
+  struct geometry_timeline {
+    size_t point;
+    std::vector<int64_t> ticks;
+    std::vector<double> slant_range;
+    std::vector<double> range_rate;
+    std::vector<double> azimuth;
+    std::vector<double> elevation;
+  };
+
+  /*!
+   * \brief The sum of the atmospheric, the precipitation and the path loss
+   * attenuation of the visible time steps of a geometry
+   */
+  struct attenuation_timeline {
+    size_t point;
+    size_t geometry;
+    std::vector<double> loss;
+  };
+
+  const std::vector<scenario_t> d_points;
+  const double d_outage_threshold_db;
+  std::vector<geometry_timeline> d_geometries;
+  std::vector<attenuation_timeline> d_attenuations;
+  std::vector<size_t> d_point_attenuation;
+  std::vector<sweep_result_t> d_results;
+  bool d_computed;
+
+  static std::string
+  geometry_key(const scenario_t &s);
+
+  static std::string
+  attenuation_key(const scenario_t &s);
+
+  void
+  compute_geometry(geometry_timeline &g) const;
+
+  void
+  compute_attenuation(attenuation_timeline &a) const;
+
+  sweep_result_t
+  evaluate(size_t point, std::vector<double> *margin,
+           std::vector<double> *loss) const;
+
+  void
+  check_computed(size_t point) const;
+};
+
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_SWEEP_IMPL_H */
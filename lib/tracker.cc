@@ -25,6 +25,7 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/leo/log.h>
 #include <gnuradio/leo/tracker.h>
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
@@ -32,6 +33,12 @@
 namespace gr {
 namespace leo {
 
+/*
+ * The step of the pass search of get_time_to_next_aos_us() in seconds, short
+ * enough to not miss the low elevation passes that last a couple of minutes
+ */
+static const int NEXT_AOS_SEARCH_STEP = 10;
+
 tracker::tracker_sptr
 tracker::make(satellite::satellite_sptr satellite_info, const double gs_lat,
               const double gs_lon, const double gs_alt,
@@ -83,7 +90,8 @@ tracker::tracker(satellite::satellite_sptr satellite_info,
                  const double noise_figure,
                  const double noise_temp,
                  const double rx_bw)
-    : d_time_resolution_us(time_resolution_us),
+    : d_passlist_generated(false),
+      d_time_resolution_us(time_resolution_us),
       d_observer(gs_lat, gs_lon, gs_alt),
       d_satellite(satellite_info),
       d_tle(libsgp4::Tle(d_satellite->get_tle_title(),
@@ -103,7 +111,8 @@ tracker::tracker(satellite::satellite_sptr satellite_info,
       d_tx_power_dbm(tx_power_dbm),
       d_noise_figure(noise_figure),
       d_noise_temp(noise_temp),
-      d_rx_bw(rx_bw)
+      d_rx_bw(rx_bw),
+      d_look_valid(false)
 
 {
   if (d_obs_end <= d_obs_start) {
@@ -118,6 +127,7 @@ tracker::tracker(const std::string &tle_title, const std::string &tle_1,
                  const std::string &tle_2, const double gs_lat,
                  const double gs_lon, const double gs_alt,
                  const std::string &obs_start, const std::string &obs_end) :
+  d_passlist_generated(false),
   d_time_resolution_us(300e3),
   d_observer(gs_lat, gs_lon, gs_alt),
   d_tle_title(tle_title),
@@ -136,7 +146,8 @@ tracker::tracker(const std::string &tle_title, const std::string &tle_1,
   d_rx_bw(0),
   d_gs_alt(gs_alt),
   d_gs_lat(gs_lat),
-  d_gs_lon(gs_lon)
+  d_gs_lon(gs_lon),
+  d_look_valid(false)
 {
   if (d_obs_end <= d_obs_start) {
     throw std::runtime_error("Invalid observation timeframe");
@@ -151,7 +162,7 @@ tracker::~tracker()
 {
 }
 
-int tracker::base_unique_id = 1;
+std::atomic<int> tracker::base_unique_id(1);
 
 int
 tracker::unique_id()
@@ -168,7 +179,8 @@ tracker::get_satellite_info()
 double tracker::find_max_elevation(libsgp4::Observer& observer,
                                    libsgp4::SGP4& sgp4,
                                    const libsgp4::DateTime& aos,
-                                   const libsgp4::DateTime& los)
+                                   const libsgp4::DateTime& los,
+                                   libsgp4::DateTime *max_time)
 {
 
   bool running;
@@ -178,6 +190,7 @@ double tracker::find_max_elevation(libsgp4::Observer& observer,
   libsgp4::DateTime time1(aos);        //! start time of search period
   libsgp4::DateTime time2(los);        //! end time of search period
   double max_elevation; //! max elevation
+  libsgp4::DateTime max_elevation_time(aos);
 
   running = true;
 
@@ -196,6 +209,7 @@ double tracker::find_max_elevation(libsgp4::Observer& observer,
          * still going up
          */
         max_elevation = topo.elevation;
+        max_elevation_time = current_time;
         /*
          * move time along
          */
@@ -234,6 +248,9 @@ double tracker::find_max_elevation(libsgp4::Observer& observer,
   }
   while (time_step > 1.0);
 
+  if (max_time) {
+    *max_time = max_elevation_time;
+  }
   return max_elevation;
 }
 
@@ -317,10 +334,29 @@ tracker::find_crossing_point_time(libsgp4::Observer& observer,
   return middle_time;
 }
 
-std::vector<pass_details_t>
-tracker::generate_passlist(const int time_step)
+pass_info_t
+tracker::add_pass(const libsgp4::DateTime &aos, const libsgp4::DateTime &los)
 {
-  pass_details_t pd;
+  pass_info_t p;
+  libsgp4::DateTime max_time;
+
+  p.max_elevation = find_max_elevation(d_observer, d_sgp4, aos, los,
+                                       &max_time);
+  p.aos = (aos.Ticks() - libsgp4::UnixEpoch) / libsgp4::TicksPerMicrosecond;
+  p.los = (los.Ticks() - libsgp4::UnixEpoch) / libsgp4::TicksPerMicrosecond;
+  p.max_elevation_time = (max_time.Ticks() - libsgp4::UnixEpoch)
+                         / libsgp4::TicksPerMicrosecond;
+  p.aos_azimuth = d_observer.GetLookAngle(d_sgp4.FindPosition(aos)).azimuth;
+  p.los_azimuth = d_observer.GetLookAngle(d_sgp4.FindPosition(los)).azimuth;
+
+  d_pass_windows.push_back(std::make_pair(aos, los));
+  return p;
+}
+
+std::vector<pass_info_t>
+tracker::generate_passes(const int time_step)
+{
+  std::vector<pass_info_t> passes;
   libsgp4::DateTime aos_time;
   libsgp4::DateTime los_time;
 
@@ -329,7 +365,7 @@ tracker::generate_passlist(const int time_step)
   libsgp4::DateTime previous_time(d_obs_start);
   libsgp4::DateTime current_time(d_obs_start);
 
-  d_passlist.clear();
+  d_pass_windows.clear();
 
   while (current_time < d_obs_end) {
     bool end_of_pass = false;
@@ -376,11 +412,7 @@ tracker::generate_passlist(const int time_step)
                                           previous_time, current_time,
                                           false);
 
-      pd = {aos_time.ToString(), los_time.ToString(), find_max_elevation(d_observer, d_sgp4, aos_time,
-            los_time)
-           };
-
-      d_passlist.push_back(pd);
+      passes.push_back(add_pass(aos_time, los_time));
     }
 
     /*
@@ -414,11 +446,23 @@ tracker::generate_passlist(const int time_step)
      * satellite still above horizon at end of search period, so use end
      * time as los
      */
-    pd = {aos_time.ToString(), los_time.ToString(), find_max_elevation(d_observer, d_sgp4, aos_time,
-          d_obs_end)
-         };
+    passes.push_back(add_pass(aos_time, d_obs_end));
+  }
+  d_passlist_generated = true;
+  return passes;
+}
 
-    d_passlist.push_back(pd);
+std::vector<pass_details_t>
+tracker::generate_passlist(const int time_step)
+{
+  const std::vector<pass_info_t> passes = generate_passes(time_step);
+
+  d_passlist.clear();
+  for (size_t i = 0; i < passes.size(); i++) {
+    d_passlist.push_back({d_pass_windows[i].first.ToString(),
+                          d_pass_windows[i].second.ToString(),
+                          passes[i].max_elevation
+                         });
   }
 
   if (d_passlist.begin() == d_passlist.end()) {
@@ -443,38 +487,104 @@ tracker::generate_passlist(const int time_step)
   return d_passlist;
 }
 
+double
+tracker::get_time_to_next_aos_us()
+{
+  if (!d_passlist_generated) {
+    generate_passes(NEXT_AOS_SEARCH_STEP);
+  }
+
+  for (const auto &w : d_pass_windows) {
+    if (d_obs_elapsed < w.second) {
+      if (d_obs_elapsed >= w.first) {
+        return 0.0;
+      }
+      return (w.first - d_obs_elapsed).TotalSeconds() * 1e6;
+    }
+  }
+  return std::max(0.0, (d_obs_end - d_obs_elapsed).TotalSeconds() * 1e6);
+}
+
+const libsgp4::CoordTopocentric &
+tracker::look_angle()
+{
+  if (!d_look_valid || d_look_time != d_obs_elapsed) {
+    libsgp4::Eci eci = d_sgp4.FindPosition(d_obs_elapsed);
+    d_look = d_observer.GetLookAngle(eci);
+    d_sat_position = eci.Position();
+    d_sat_velocity = eci.Velocity();
+    d_look_time = d_obs_elapsed;
+    d_look_valid = true;
+  }
+  return d_look;
+}
+
 double
 tracker::get_slant_range()
 {
-  libsgp4::Eci eci = d_sgp4.FindPosition(get_elapsed_time());
-  libsgp4::CoordTopocentric topo = d_observer.GetLookAngle(eci);
-  return topo.range;
+  return look_angle().range;
 }
 
 double
 tracker::get_elevation_degrees()
 {
-  libsgp4::Eci eci = d_sgp4.FindPosition(get_elapsed_time());
-  libsgp4::CoordTopocentric topo = d_observer.GetLookAngle(eci);
-  return libsgp4::Util::RadiansToDegrees(topo.elevation);
+  return libsgp4::Util::RadiansToDegrees(look_angle().elevation);
 }
 
 double
 tracker::get_elevation_radians()
 {
-  libsgp4::Eci eci = d_sgp4.FindPosition(get_elapsed_time());
-  libsgp4::CoordTopocentric topo = d_observer.GetLookAngle(eci);
-  return topo.elevation;
+  return look_angle().elevation;
+}
+
+double
+tracker::get_azimuth_degrees()
+{
+  return libsgp4::Util::RadiansToDegrees(look_angle().azimuth);
+}
+
+double
+tracker::get_azimuth_radians()
+{
+  return look_angle().azimuth;
 }
 
 double
 tracker::get_velocity()
 {
-  double elevation;
+  return look_angle().range_rate;
+}
+
+void
+tracker::get_geometry_batch(const double *time, size_t n, double *range,
+                            double *range_rate, double *azimuth,
+                            double *elevation) const
+{
+  /* A private observer, as the look angle updates its cached position */
+  libsgp4::Observer observer(d_observer.GetLocation());
+  for (size_t i = 0; i < n; i++) {
+    const libsgp4::Eci eci = d_sgp4.FindPosition(
+                               d_obs_start.AddMicroseconds(time[i] * 1e6));
+    const libsgp4::CoordTopocentric topo = observer.GetLookAngle(eci);
+    range[i] = topo.range;
+    range_rate[i] = topo.range_rate;
+    azimuth[i] = libsgp4::Util::RadiansToDegrees(topo.azimuth);
+    elevation[i] = libsgp4::Util::RadiansToDegrees(topo.elevation);
+  }
+}
 
-  libsgp4::Eci eci = d_sgp4.FindPosition(get_elapsed_time());
-  libsgp4::CoordTopocentric topo = d_observer.GetLookAngle(eci);
-  return topo.range_rate;
+eci_state_t
+tracker::get_eci_state()
+{
+  look_angle();
+  const libsgp4::Vector gs = libsgp4::Eci(d_obs_elapsed,
+                                          d_observer.GetLocation()).Position();
+  eci_state_t state = {
+    {d_sat_position.x, d_sat_position.y, d_sat_position.z},
+    {d_sat_velocity.x, d_sat_velocity.y, d_sat_velocity.z},
+    {gs.x, gs.y, gs.z}
+  };
+  return state;
 }
 
 libsgp4::DateTime tracker::parse_ISO_8601_UTC(const std::string& datetime)
@@ -565,6 +675,12 @@ tracker::advance_time(double us)
   d_obs_elapsed = d_obs_elapsed.AddMicroseconds(us);
 }
 
+void
+tracker::set_elapsed_time(const libsgp4::DateTime &t)
+{
+  d_obs_elapsed = t;
+}
+
 libsgp4::DateTime tracker::get_elapsed_time() { return d_obs_elapsed; }
 
 bool
@@ -0,0 +1,456 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "itu_grid.h"
+#include <gnuradio/constants.h>
+#include <gnuradio/leo/log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'L', 'E', 'O', 'G', 'R', 'I', 'D', '2'};
+
+/*
+ * The header of the binary cache, followed by rows x cols floats. It holds
+ * the sizes and the modification times of up to three source files.
+ */
+typedef struct {
+  char magic[8];
+  uint64_t source_size[3];
+  int64_t source_mtime[3];
+  uint64_t rows;
+  uint64_t cols;
+  double lat0;
+  double dlat;
+  double lon0;
+  double dlon;
+} cache_header_t;
+
+std::string
+read_file(const std::string &path)
+{
+  std::ifstream f(path, std::ios::binary);
+  if (!f.is_open()) {
+    throw std::runtime_error("itu_grid: could not open " + path);
+  }
+  return std::string(std::istreambuf_iterator<char>(f),
+                     std::istreambuf_iterator<char>());
+}
+
+/* Parse the whitespace separated numbers of a text, row by row */
+std::vector<std::vector<double>>
+parse_rows(const std::string &text)
+{
+  std::vector<std::vector<double>> rows;
+  const char *p = text.c_str();
+  const char *end = p + text.size();
+  while (p < end) {
+    const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    if (!eol) {
+      eol = end;
+    }
+    std::vector<double> row;
+    char *next;
+    for (double v = std::strtod(p, &next); next != p && next <= eol;
+         v = std::strtod(p, &next)) {
+      row.push_back(v);
+      p = next;
+    }
+    if (!row.empty()) {
+      rows.push_back(std::move(row));
+    }
+    p = eol + 1;
+  }
+  return rows;
+}
+
+std::filesystem::path
+cache_dir()
+{
+  const char *xdg = std::getenv("XDG_CACHE_HOME");
+  if (xdg && *xdg) {
+    return std::filesystem::path(xdg) / "gr-leo";
+  }
+  const char *home = std::getenv("HOME");
+  if (home && *home) {
+    return std::filesystem::path(home) / ".cache" / "gr-leo";
+  }
+  return std::filesystem::temp_directory_path() / "gr-leo";
+}
+
+} // namespace
+
+itu_grid::sptr
+itu_grid::load(const std::string &lat_file, const std::string &lon_file,
+               const std::string &values_file)
+{
+  return load_cached(values_file, &itu_grid::parse_map,
+  {lat_file, lon_file, values_file});
+}
+
+itu_grid::sptr
+itu_grid::load_table(const std::string &file)
+{
+  return load_cached(file, &itu_grid::parse_table, {file});
+}
+
+itu_grid::sptr
+itu_grid::load_cached(const std::string &source,
+                      void (itu_grid::*parse_fn)(const std::vector<std::string> &),
+                      const std::vector<std::string> &files)
+{
+  static std::mutex mtx;
+  static std::map<std::string, sptr> grids;
+
+  std::lock_guard<std::mutex> lock(mtx);
+  auto it = grids.find(source);
+  if (it != grids.end()) {
+    return it->second;
+  }
+
+  static_assert(sizeof(cache_header_t::source_size)
+                == sizeof(source_stamp_t::size), "Invalid cache header");
+  if (files.size() > MAX_SOURCES) {
+    throw std::invalid_argument("itu_grid: too many source files");
+  }
+  source_stamp_t stamp = {};
+  for (size_t i = 0; i < files.size(); i++) {
+    stamp.size[i] = std::filesystem::file_size(files[i]);
+    stamp.mtime[i] =
+      std::filesystem::last_write_time(files[i]).time_since_epoch().count();
+  }
+
+  const std::filesystem::path src(source);
+  std::ostringstream name;
+  name << src.stem().string() << "-" << std::hex
+       << std::hash<std::string>()(std::filesystem::absolute(src).string())
+       << ".grid";
+  const std::string cache = (cache_dir() / name.str()).string();
+
+  std::shared_ptr<itu_grid> grid(new itu_grid());
+  if (!grid->map_cache(cache, stamp)) {
+    (grid.get()->*parse_fn)(files);
+    grid->write_cache(cache, stamp);
+  }
+  grids[source] = grid;
+  return grid;
+}
+
+itu_grid::itu_grid() :
+  d_rows(0),
+  d_cols(0),
+  d_lat0(0),
+  d_dlat(0),
+  d_lon0(0),
+  d_dlon(0),
+  d_values(nullptr),
+  d_map(nullptr),
+  d_map_len(0)
+{
+}
+
+itu_grid::~itu_grid()
+{
+#ifndef _WIN32
+  if (d_map) {
+    munmap(d_map, d_map_len);
+  }
+#endif
+}
+
+size_t
+itu_grid::rows() const
+{
+  return d_rows;
+}
+
+size_t
+itu_grid::cols() const
+{
+  return d_cols;
+}
+
+double
+itu_grid::max() const
+{
+  return *std::max_element(d_values, d_values + d_rows * d_cols);
+}
+
+/* The latitude, longitude and values files of an ITU map */
+void
+itu_grid::parse_map(const std::vector<std::string> &files)
+{
+  const std::string &values_file = files[2];
+  const std::vector<std::vector<double>> lat = parse_rows(read_file(files[0]));
+  const std::vector<std::vector<double>> lon = parse_rows(read_file(files[1]));
+  const std::vector<std::vector<double>> val =
+                                        parse_rows(read_file(values_file));
+
+  if (lat.size() < 2 || lon.empty() || lon[0].size() < 2
+      || val.size() != lat.size()) {
+    throw std::runtime_error("itu_grid: invalid map " + values_file);
+  }
+  d_rows = val.size();
+  d_cols = lon[0].size();
+  d_lat0 = lat[0][0];
+  d_dlat = lat[1][0] - lat[0][0];
+  d_lon0 = lon[0][0];
+  d_dlon = lon[0][1] - lon[0][0];
+
+  d_storage.resize(d_rows * d_cols);
+  for (size_t i = 0; i < d_rows; i++) {
+    if (val[i].size() != d_cols) {
+      throw std::runtime_error("itu_grid: invalid map " + values_file);
+    }
+    std::copy(val[i].begin(), val[i].end(), d_storage.begin() + i * d_cols);
+  }
+  d_values = d_storage.data();
+}
+
+void
+itu_grid::parse_table(const std::vector<std::string> &files)
+{
+  const std::string &file = files[0];
+  std::string text = read_file(file);
+  std::replace(text.begin(), text.end(), ',', ' ');
+
+  /* Comments and headers are dropped by the number parser */
+  std::vector<double> rc;
+  std::vector<double> cc;
+  std::vector<double> vals;
+  for (const std::vector<double> &row : parse_rows(text)) {
+    if (row.size() < 3) {
+      continue;
+    }
+    rc.push_back(row[0]);
+    cc.push_back(row[1]);
+    vals.push_back(row[2]);
+  }
+
+  std::vector<double> r(rc);
+  std::vector<double> c(cc);
+  std::sort(r.begin(), r.end());
+  r.erase(std::unique(r.begin(), r.end()), r.end());
+  std::sort(c.begin(), c.end());
+  c.erase(std::unique(c.begin(), c.end()), c.end());
+  if (r.size() < 2 || c.size() < 2 || r.size() * c.size() != vals.size()) {
+    throw std::runtime_error("itu_grid: " + file
+                             + " does not hold a complete regular grid");
+  }
+
+  d_lat0 = r[0];
+  d_dlat = (r.back() - r[0]) / (r.size() - 1);
+  d_lon0 = c[0];
+  d_dlon = (c.back() - c[0]) / (c.size() - 1);
+  d_rows = r.size();
+  /* Close a periodic column coordinate */
+  const bool wrap = std::abs(c.back() + d_dlon - c[0] - 360) < 1e-6;
+  d_cols = c.size() + (wrap ? 1 : 0);
+
+  d_storage.assign(d_rows * d_cols, 0.0f);
+  for (size_t k = 0; k < vals.size(); k++) {
+    const size_t i = std::lround((rc[k] - d_lat0) / d_dlat);
+    const size_t j = std::lround((cc[k] - d_lon0) / d_dlon);
+    if (std::abs(d_lat0 + i * d_dlat - rc[k]) > 1e-6 * std::abs(d_dlat)
+        || std::abs(d_lon0 + j * d_dlon - cc[k]) > 1e-6 * std::abs(d_dlon)) {
+      throw std::runtime_error("itu_grid: " + file
+                               + " does not hold a regular grid");
+    }
+    d_storage[i * d_cols + j] = vals[k];
+  }
+  if (wrap) {
+    for (size_t i = 0; i < d_rows; i++) {
+      d_storage[i * d_cols + d_cols - 1] = d_storage[i * d_cols];
+    }
+  }
+  d_values = d_storage.data();
+}
+
+bool
+itu_grid::map_cache(const std::string &path, const source_stamp_t &stamp)
+{
+#ifndef _WIN32
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0
+      || static_cast<size_t>(st.st_size) < sizeof(cache_header_t)) {
+    close(fd);
+    return false;
+  }
+  void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+
+  const cache_header_t *hdr = static_cast<const cache_header_t *>(map);
+  if (std::memcmp(hdr->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+      || !std::equal(stamp.size, stamp.size + MAX_SOURCES, hdr->source_size)
+      || !std::equal(stamp.mtime, stamp.mtime + MAX_SOURCES, hdr->source_mtime)
+      || static_cast<size_t>(st.st_size) != sizeof(cache_header_t)
+      + hdr->rows * hdr->cols * sizeof(float)) {
+    munmap(map, st.st_size);
+    return false;
+  }
+  d_map = map;
+  d_map_len = st.st_size;
+  d_rows = hdr->rows;
+  d_cols = hdr->cols;
+  d_lat0 = hdr->lat0;
+  d_dlat = hdr->dlat;
+  d_lon0 = hdr->lon0;
+  d_dlon = hdr->dlon;
+  d_values = reinterpret_cast<const float *>(hdr + 1);
+  return true;
+#else
+  (void) path;
+  (void) stamp;
+  return false;
+#endif
+}
+
+/*
+ * The cache is written to a temporary file that is then renamed, so
+ * concurrent processes never see a partial cache. Failures are not fatal,
+ * the map is parsed again the next time.
+ */
+void
+itu_grid::write_cache(const std::string &path,
+                      const source_stamp_t &stamp) const
+{
+  std::error_code ec;
+  std::filesystem::create_directories(
+    std::filesystem::path(path).parent_path(), ec);
+
+  cache_header_t hdr;
+  std::memcpy(hdr.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  std::copy(stamp.size, stamp.size + MAX_SOURCES, hdr.source_size);
+  std::copy(stamp.mtime, stamp.mtime + MAX_SOURCES, hdr.source_mtime);
+  hdr.rows = d_rows;
+  hdr.cols = d_cols;
+  hdr.lat0 = d_lat0;
+  hdr.dlat = d_dlat;
+  hdr.lon0 = d_lon0;
+  hdr.dlon = d_dlon;
+
+  const std::string tmp = path + ".tmp" + std::to_string(
+#ifndef _WIN32
+                            getpid()
+#else
+                            0
+#endif
+                          );
+  {
+    std::ofstream f(tmp, std::ios::binary);
+    f.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    f.write(reinterpret_cast<const char *>(d_values),
+            d_rows * d_cols * sizeof(float));
+    if (!f.good()) {
+      LEO_DEBUG("Could not write the ITU map cache %s", path.c_str());
+      f.close();
+      std::filesystem::remove(tmp, ec);
+      return;
+    }
+  }
+  std::filesystem::rename(tmp, path, ec);
+  if (ec) {
+    LEO_DEBUG("Could not write the ITU map cache %s", path.c_str());
+    std::filesystem::remove(tmp, ec);
+  }
+}
+
+double
+itu_grid::value(double lat, double lon) const
+{
+  /* Bring the longitude within the span of the grid */
+  const double span = std::abs(d_dlon) * (d_cols - 1);
+  const double lon_min = std::min(d_lon0, d_lon0 + d_dlon * (d_cols - 1));
+  if (span >= 360) {
+    lon = lon_min + std::fmod(std::fmod(lon - lon_min, 360.0) + 360.0, 360.0);
+  }
+
+  const double r = std::min(std::max((lat - d_lat0) / d_dlat, 0.0),
+                            d_rows - 1.0);
+  const double c = std::min(std::max((lon - d_lon0) / d_dlon, 0.0),
+                            d_cols - 1.0);
+  const size_t i = std::min(static_cast<size_t>(r), d_rows - 2);
+  const size_t j = std::min(static_cast<size_t>(c), d_cols - 2);
+  const double wr = r - i;
+  const double wc = c - j;
+
+  const float *v0 = d_values + i * d_cols + j;
+  const float *v1 = v0 + d_cols;
+  return (1 - wr) * ((1 - wc) * v0[0] + wc * v0[1])
+         + wr * ((1 - wc) * v1[0] + wc * v1[1]);
+}
+
+std::string
+data_path()
+{
+  const char *dir = std::getenv("GR_LEO_DATA_DIR");
+  if (dir && *dir) {
+    return dir;
+  }
+  return (std::filesystem::path(gr::prefix())
+          / GR_LEO_REL_DATA_PATH).lexically_normal().string();
+}
+
+double
+topographic_altitude(double lat, double lon)
+{
+  const std::filesystem::path dir = std::filesystem::path(data_path())
+                                    / "ITU_RREC_P1511";
+  itu_grid::sptr topo = itu_grid::load((dir / "TOPOLAT.txt").string(),
+                                       (dir / "TOPOLON.txt").string(),
+                                       (dir / "TOPO_0DOT5.txt").string());
+  return topo->value(lat, lon);
+}
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
@@ -0,0 +1,167 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_ITU_GRID_H
+#define INCLUDED_LEO_UTILS_ITU_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief A regular latitude/longitude grid of an ITU-R digital map.
+ *
+ * \details
+ * The ITU maps are distributed as three text files with the same layout:
+ * the latitude and the longitude of each grid point and the values
+ * themselves. The grid is parsed once and stored in a binary cache file
+ * under the user cache directory, that later runs memory map instead of
+ * parsing the text again. The cache is rebuilt when the size or the
+ * modification time of any of the files changes. Grids are shared by all the users of the same
+ * map in the process.
+ *
+ * Any other regular grid with a periodic column coordinate in degrees,
+ * like the (theta, phi) radiation pattern of an antenna, can be loaded from
+ * a table of triples with the same caching.
+ */
+class itu_grid {
+public:
+  typedef std::shared_ptr<const itu_grid> sptr;
+
+  /*!
+   * \brief Get the grid of a map, loading it on the first request
+   * \param lat_file the latitude file of the map
+   * \param lon_file the longitude file of the map
+   * \param values_file the values file of the map
+   */
+  static sptr
+  load(const std::string &lat_file, const std::string &lon_file,
+       const std::string &values_file);
+
+  /*!
+   * \brief Get the grid of a table, loading it on the first request
+   *
+   * \details
+   * Each line of the table holds the row coordinate, the column coordinate
+   * and the value of a grid point, separated by commas or whitespace.
+   * Empty lines, lines starting with # and lines that do not start with a
+   * number, like a header, are skipped. The points may be in any order, but
+   * they must cover a regular grid. If the column coordinate covers 360
+   * degrees without its end point, the first column is repeated at the end.
+   *
+   * \param file the table file
+   */
+  static sptr
+  load_table(const std::string &file);
+
+  ~itu_grid();
+
+  /*!
+   * \brief Bilinear interpolation of the map
+   * \param lat the latitude in degrees
+   * \param lon the longitude in degrees, in either the [-180, 180] or the
+   * [0, 360] range
+   */
+  double
+  value(double lat, double lon) const;
+
+  size_t
+  rows() const;
+
+  size_t
+  cols() const;
+
+  /*!
+   * \brief Get the maximum value of the grid
+   */
+  double
+  max() const;
+
+private:
+  size_t d_rows;
+  size_t d_cols;
+  double d_lat0;
+  double d_dlat;
+  double d_lon0;
+  double d_dlon;
+  const float *d_values;
+  std::vector<float> d_storage;
+  void *d_map;
+  size_t d_map_len;
+
+  /*
+   * The sizes and the modification times of the source files of a grid,
+   * that the cache is checked against
+   */
+  static const size_t MAX_SOURCES = 3;
+  typedef struct {
+    uint64_t size[MAX_SOURCES];
+    int64_t mtime[MAX_SOURCES];
+  } source_stamp_t;
+
+  itu_grid();
+
+  static sptr
+  load_cached(const std::string &source,
+              void (itu_grid::*parse_fn)(const std::vector<std::string> &),
+              const std::vector<std::string> &files);
+
+  void
+  parse_map(const std::vector<std::string> &files);
+
+  void
+  parse_table(const std::vector<std::string> &files);
+
+  bool
+  map_cache(const std::string &path, const source_stamp_t &stamp);
+
+  void
+  write_cache(const std::string &path, const source_stamp_t &stamp) const;
+};
+
+/*!
+ * \brief Get the directory of the ITU-R maps. It is the GR_LEO_DATA_DIR
+ * environment variable if set, e.g. to the data directory of the source
+ * tree, or the installed data directory of the module otherwise.
+ */
+std::string
+data_path();
+
+/*!
+ * \brief Get the altitude of a point from the topography of the ITU-R
+ * P.1511 recommendation
+ * \param lat the latitude in degrees
+ * \param lon the longitude in degrees
+ * \return the altitude above the mean sea level in km
+ */
+double
+topographic_altitude(double lat, double lon);
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_ITU_GRID_H */
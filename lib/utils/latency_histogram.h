@@ -0,0 +1,181 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_LATENCY_HISTOGRAM_H
+#define INCLUDED_LEO_UTILS_LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief Log-linear histogram of durations.
+ *
+ * \details
+ * Each power of two is split into 8 linear buckets, so any recorded value
+ * is reported with a relative error below 12.5%, using a constant amount of
+ * memory and without any allocation while recording. There is a single
+ * writer, but the counters may be read concurrently.
+ */
+class latency_histogram {
+public:
+  /*!
+   * \brief Records the lifetime of the object into a histogram
+   */
+  class scoped_timer {
+  public:
+    explicit scoped_timer(latency_histogram &hist) :
+      d_hist(hist),
+      d_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~scoped_timer()
+    {
+      d_hist.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - d_start).count());
+    }
+
+  private:
+    latency_histogram &d_hist;
+    const std::chrono::steady_clock::time_point d_start;
+  };
+
+  latency_histogram() :
+    d_buckets(NBUCKETS)
+  {
+    reset();
+  }
+
+  /*!
+   * \brief Record a duration
+   * \param ns the duration in nanoseconds
+   */
+  void
+  record(int64_t ns)
+  {
+    std::atomic<uint64_t> &b = d_buckets[index(ns < 0 ? 0 : ns)];
+    b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  void
+  reset()
+  {
+    for (std::atomic<uint64_t> &b : d_buckets) {
+      b.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief Get the number of recorded durations
+   */
+  uint64_t
+  count() const
+  {
+    uint64_t n = 0;
+    for (const std::atomic<uint64_t> &b : d_buckets) {
+      n += b.load(std::memory_order_relaxed);
+    }
+    return n;
+  }
+
+  /*!
+   * \brief Estimate percentiles of the recorded durations
+   * \param percentiles the requested percentiles in the range [0, 100]
+   * \return the durations in microseconds. All zeros if nothing has been
+   * recorded yet.
+   */
+  std::vector<double>
+  percentiles(const std::vector<double> &percentiles) const
+  {
+    std::vector<uint64_t> counts(NBUCKETS);
+    uint64_t total = 0;
+    for (size_t i = 0; i < NBUCKETS; i++) {
+      counts[i] = d_buckets[i].load(std::memory_order_relaxed);
+      total += counts[i];
+    }
+
+    std::vector<double> res(percentiles.size(), 0.0);
+    if (total == 0) {
+      return res;
+    }
+    for (size_t j = 0; j < percentiles.size(); j++) {
+      const double target = percentiles[j] / 100.0 * total;
+      uint64_t cumulative = 0;
+      size_t i = 0;
+      for (; i < NBUCKETS - 1; i++) {
+        cumulative += counts[i];
+        if (cumulative >= target && cumulative > 0) {
+          break;
+        }
+      }
+      res[j] = midpoint(i) / 1e3;
+    }
+    return res;
+  }
+
+private:
+  static constexpr size_t SUB_BITS = 3;
+  static constexpr size_t SUB = 1 << SUB_BITS;
+  static constexpr size_t NBUCKETS = SUB + (64 - SUB_BITS) * SUB;
+
+  std::vector<std::atomic<uint64_t>> d_buckets;
+
+  static size_t
+  index(uint64_t v)
+  {
+    if (v < SUB) {
+      return v;
+    }
+#ifdef __GNUC__
+    size_t e = 63 - __builtin_clzll(v);
+#else
+    size_t e = 0;
+    while (v >> (e + 1)) {
+      e++;
+    }
+#endif
+    size_t sub = (v >> (e - SUB_BITS)) & (SUB - 1);
+    return SUB + (e - SUB_BITS) * SUB + sub;
+  }
+
+  static double
+  midpoint(size_t idx)
+  {
+    if (idx < SUB) {
+      return idx;
+    }
+    const size_t e = (idx - SUB) / SUB + SUB_BITS;
+    const size_t sub = (idx - SUB) % SUB;
+    const double width = static_cast<double>(1ULL << (e - SUB_BITS));
+    return static_cast<double>(1ULL << e) + (sub + 0.5) * width;
+  }
+};
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_LATENCY_HISTOGRAM_H */
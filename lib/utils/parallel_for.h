@@ -0,0 +1,103 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_PARALLEL_FOR_H
+#define INCLUDED_LEO_UTILS_PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief Get the number of threads to use for a number of independent tasks
+ * \param ntasks the number of tasks
+ * \param nthreads the requested number of threads, 0 for the number of
+ * hardware threads
+ */
+inline size_t
+worker_count(size_t ntasks, size_t nthreads)
+{
+  if (nthreads == 0) {
+    nthreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  return std::max<size_t>(1, std::min(nthreads, ntasks));
+}
+
+/*!
+ * \brief Run fn(i, worker) for every i in [0, n) on a pool of threads.
+ *
+ * \details
+ * The tasks are handed out one at a time, so tasks of uneven cost are
+ * balanced across the workers. The calling thread is worker 0. If a task
+ * throws, the remaining tasks are abandoned and the first exception is
+ * rethrown once all the workers have stopped.
+ *
+ * \param n the number of tasks
+ * \param workers the number of threads, as returned by worker_count()
+ * \param fn the task, called with the task index and the worker index
+ */
+template <typename F>
+void
+parallel_for(size_t n, size_t workers, F fn)
+{
+  std::vector<std::exception_ptr> errors(workers);
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+
+  auto worker = [&](size_t w) {
+    try {
+      size_t i;
+      while (!failed.load(std::memory_order_relaxed)
+             && (i = next.fetch_add(1, std::memory_order_relaxed)) < n) {
+        fn(i, w);
+      }
+    }
+    catch (...) {
+      errors[w] = std::current_exception();
+      failed = true;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t w = 1; w < workers; w++) {
+    threads.emplace_back(worker, w);
+  }
+  worker(0);
+  for (std::thread &th : threads) {
+    th.join();
+  }
+  for (const std::exception_ptr &e : errors) {
+    if (e) {
+      std::rethrow_exception(e);
+    }
+  }
+}
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_PARALLEL_FOR_H */
@@ -0,0 +1,173 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "polyphase_resampler.h"
+#include <gnuradio/leo/api.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+polyphase_resampler::polyphase_resampler(size_t nfilters, size_t ntaps) :
+  d_nfilters(nfilters),
+  d_ntaps(ntaps),
+  d_taps((nfilters + 1) * ntaps),
+  d_buf(ntaps - 1, gr_complex(0.0, 0.0)),
+  d_pos(0.0),
+  d_ratio(1.0),
+  d_ratio_step(0.0),
+  d_target_ratio(1.0),
+  d_slew_remaining(0)
+{
+  if (nfilters < 1 || ntaps < 2) {
+    throw std::invalid_argument("Invalid polyphase resampler size");
+  }
+
+  /*
+   * Keep a small margin below the Nyquist frequency, so the transition band
+   * of the short filters does not alias back into the signal
+   */
+  const double bandwidth = 0.9;
+  const double center = ntaps / 2.0 - 1;
+
+  for (size_t k = 0; k <= d_nfilters; k++) {
+    const double mu = static_cast<double>(k) / d_nfilters;
+    float *taps = &d_taps[k * d_ntaps];
+    double sum = 0.0;
+    for (size_t j = 0; j < d_ntaps; j++) {
+      const double x = j - center - mu;
+      const double sinc = (x == 0.0) ? 1.0
+                          : std::sin(MATH_PI * bandwidth * x) / (MATH_PI * bandwidth * x);
+      /* Blackman window centered at the fractional delay */
+      const double w = 0.42 + 0.5 * std::cos(2 * MATH_PI * x / d_ntaps)
+                       + 0.08 * std::cos(4 * MATH_PI * x / d_ntaps);
+      taps[j] = static_cast<float>(bandwidth * sinc * w);
+      sum += taps[j];
+    }
+    /* Unity DC gain for every fractional delay */
+    for (size_t j = 0; j < d_ntaps; j++) {
+      taps[j] = static_cast<float>(taps[j] / sum);
+    }
+  }
+}
+
+polyphase_resampler::~polyphase_resampler()
+{
+}
+
+void
+polyphase_resampler::set_ratio(double ratio, size_t nsamples)
+{
+  d_target_ratio = ratio;
+  if (nsamples == 0) {
+    d_ratio = ratio;
+    d_ratio_step = 0.0;
+    d_slew_remaining = 0;
+  }
+  else {
+    d_ratio_step = (ratio - d_ratio) / nsamples;
+    d_slew_remaining = nsamples;
+  }
+}
+
+double
+polyphase_resampler::get_ratio() const
+{
+  return d_ratio;
+}
+
+void
+polyphase_resampler::reset(double ratio)
+{
+  std::fill(d_buf.begin(), d_buf.end(), gr_complex(0.0, 0.0));
+  d_pos = 0.0;
+  set_ratio(ratio, 0);
+}
+
+size_t
+polyphase_resampler::ninput_required(size_t noutput) const
+{
+  if (noutput == 0) {
+    return 0;
+  }
+  const double ratio = std::max(d_ratio, d_target_ratio);
+  return static_cast<size_t>(d_pos + (noutput - 1) * ratio) + 1;
+}
+
+size_t
+polyphase_resampler::resample(gr_complex *out, size_t noutput,
+                              const gr_complex *in, size_t ninput,
+                              size_t &consumed)
+{
+  const size_t history = d_ntaps - 1;
+  size_t produced = 0;
+  gr_complex y0;
+  gr_complex y1;
+
+  d_buf.insert(d_buf.end(), in, in + ninput);
+
+  while (produced < noutput) {
+    const size_t idx = static_cast<size_t>(d_pos);
+    if (idx + d_ntaps > d_buf.size()) {
+      break;
+    }
+    const double phase = (d_pos - idx) * d_nfilters;
+    const size_t k = static_cast<size_t>(phase);
+    const float frac = static_cast<float>(phase - k);
+
+    volk_32fc_32f_dot_prod_32fc(&y0, &d_buf[idx], &d_taps[k * d_ntaps],
+                                d_ntaps);
+    volk_32fc_32f_dot_prod_32fc(&y1, &d_buf[idx], &d_taps[(k + 1) * d_ntaps],
+                                d_ntaps);
+    out[produced++] = y0 + frac * (y1 - y0);
+
+    d_pos += d_ratio;
+    if (d_slew_remaining) {
+      d_ratio += d_ratio_step;
+      if (--d_slew_remaining == 0) {
+        d_ratio = d_target_ratio;
+      }
+    }
+  }
+
+  /*
+   * Drop the samples that are not needed anymore, keeping only the
+   * history of the filter for the next call
+   */
+  consumed = std::min(static_cast<size_t>(d_pos), ninput);
+  std::copy(d_buf.begin() + consumed, d_buf.begin() + consumed + history,
+            d_buf.begin());
+  d_buf.resize(history);
+  d_pos -= consumed;
+
+  return produced;
+}
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
@@ -0,0 +1,129 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_POLYPHASE_RESAMPLER_H
+#define INCLUDED_LEO_UTILS_POLYPHASE_RESAMPLER_H
+
+#include <gnuradio/gr_complex.h>
+#include <vector>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief Arbitrary ratio resampler based on a polyphase filterbank.
+ *
+ * \details
+ * The filterbank holds a windowed-sinc interpolator for each one of
+ * \p nfilters equally spaced fractional delays. Each output sample is
+ * computed from the two filters that surround the current fractional read
+ * position, with a linear interpolation between their outputs, so no
+ * trigonometric functions are evaluated after construction.
+ *
+ * The resampling ratio is expressed in input samples per output sample and
+ * may vary continuously. A new ratio is reached by slewing linearly from the
+ * current one over a requested number of output samples.
+ */
+class polyphase_resampler {
+public:
+  /*!
+   * \param nfilters The number of filters (fractional delays) of the bank
+   * \param ntaps The number of taps of each filter
+   */
+  polyphase_resampler(size_t nfilters = 32, size_t ntaps = 16);
+
+  ~polyphase_resampler();
+
+  /*!
+   * \brief Slew the resampling ratio towards a new value.
+   * \param ratio The new ratio in input samples per output sample
+   * \param nsamples The number of output samples over which the current
+   * ratio linearly reaches the new one. If 0 the ratio changes immediately.
+   */
+  void
+  set_ratio(double ratio, size_t nsamples);
+
+  /*!
+   * \brief Get the current resampling ratio.
+   * \return the ratio in input samples per output sample
+   */
+  double
+  get_ratio() const;
+
+  /*!
+   * \brief Clear the filter history and set the ratio without slewing.
+   * \param ratio The ratio in input samples per output sample
+   */
+  void
+  reset(double ratio);
+
+  /*!
+   * \brief Get the number of new input samples that are required in order to
+   * produce \p noutput samples.
+   */
+  size_t
+  ninput_required(size_t noutput) const;
+
+  /*!
+   * \brief Resample the input signal.
+   * \param out Pointer to the output buffer
+   * \param noutput The maximum number of output samples to produce
+   * \param in Pointer to the input buffer
+   * \param ninput The number of available input samples
+   * \param consumed The number of input samples that have been consumed
+   * \return the number of output samples produced
+   */
+  size_t
+  resample(gr_complex *out, size_t noutput, const gr_complex *in,
+           size_t ninput, size_t &consumed);
+
+private:
+  const size_t d_nfilters;
+  const size_t d_ntaps;
+
+  /*!
+   * \brief The taps of the nfilters + 1 filters, stored contiguously.
+   * The extra filter corresponds to a delay of a whole sample, so the
+   * interpolation between two adjacent filters never wraps around.
+   */
+  std::vector<float> d_taps;
+
+  /*!
+   * \brief The filter history followed by the input samples of the
+   * current call
+   */
+  std::vector<gr_complex> d_buf;
+
+  /*!
+   * \brief Read position of the first tap inside d_buf
+   */
+  double d_pos;
+  double d_ratio;
+  double d_ratio_step;
+  double d_target_ratio;
+  size_t d_slew_remaining;
+};
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_POLYPHASE_RESAMPLER_H */
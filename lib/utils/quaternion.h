@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_QUATERNION_H
+#define INCLUDED_LEO_UTILS_QUATERNION_H
+
+#include <cmath>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief A unit quaternion that represents a rotation.
+ *
+ * \details
+ * The functions are inline and branch free, so loops over arrays of
+ * vectors that use them can be vectorized by the compiler.
+ */
+struct quaternion {
+  double w;
+  double x;
+  double y;
+  double z;
+};
+
+/*!
+ * \brief The rotation by \p angle radians around the unit vector
+ * (\p ux, \p uy, \p uz)
+ */
+inline quaternion
+quaternion_from_axis_angle(double ux, double uy, double uz, double angle)
+{
+  const double s = std::sin(angle / 2);
+  return {std::cos(angle / 2), ux * s, uy * s, uz * s};
+}
+
+/*!
+ * \brief The composition of the rotations, \p b is applied first
+ */
+inline quaternion
+quaternion_multiply(const quaternion &a, const quaternion &b)
+{
+  return {
+    a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+    a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+    a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+    a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w
+  };
+}
+
+/*!
+ * \brief Rotate the vector \p v in place by the inverse of \p q, i.e.
+ * express a vector of the reference frame in the frame that \p q rotates to.
+ */
+inline void
+quaternion_rotate_inverse(const quaternion &q, double v[3])
+{
+  /* v' = v + 2 r x (r x v + w v), with r the vector part of the conjugate */
+  const double rx = -q.x;
+  const double ry = -q.y;
+  const double rz = -q.z;
+  const double tx = 2 * (ry * v[2] - rz * v[1]);
+  const double ty = 2 * (rz * v[0] - rx * v[2]);
+  const double tz = 2 * (rx * v[1] - ry * v[0]);
+  const double x = v[0] + q.w * tx + (ry * tz - rz * ty);
+  const double y = v[1] + q.w * ty + (rz * tx - rx * tz);
+  const double z = v[2] + q.w * tz + (rx * ty - ry * tx);
+  v[0] = x;
+  v[1] = y;
+  v[2] = z;
+}
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_QUATERNION_H */
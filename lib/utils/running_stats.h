@@ -0,0 +1,191 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_RUNNING_STATS_H
+#define INCLUDED_LEO_UTILS_RUNNING_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief Streaming statistics of a sequence of values.
+ *
+ * \details
+ * The mean and the variance are updated with the Welford recurrence and
+ * the percentiles are estimated from a fixed histogram over [lo, hi),
+ * with values outside the range counted in the edge bins. The memory is
+ * constant, no matter how many values are recorded. Accumulators with the
+ * same histogram range can be merged, so each thread may keep its own
+ * and combine them at the end.
+ */
+class running_stats {
+public:
+  running_stats(double lo, double hi, size_t bins) :
+    d_lo(lo),
+    d_bin_width((hi - lo) / bins),
+    d_hist(bins, 0)
+  {
+    if (!(hi > lo) || bins == 0) {
+      throw std::invalid_argument("running_stats: Invalid histogram range");
+    }
+    reset();
+  }
+
+  void
+  reset()
+  {
+    d_count = 0;
+    d_mean = 0;
+    d_m2 = 0;
+    d_min = std::numeric_limits<double>::infinity();
+    d_max = -std::numeric_limits<double>::infinity();
+    std::fill(d_hist.begin(), d_hist.end(), 0);
+  }
+
+  void
+  add(double x)
+  {
+    d_count++;
+    const double delta = x - d_mean;
+    d_mean += delta / d_count;
+    d_m2 += delta * (x - d_mean);
+    d_min = std::min(d_min, x);
+    d_max = std::max(d_max, x);
+    d_hist[bin(x)]++;
+  }
+
+  /*!
+   * \brief Combine the values of another accumulator into this one
+   */
+  void
+  merge(const running_stats &other)
+  {
+    if (other.d_hist.size() != d_hist.size() || other.d_lo != d_lo
+        || other.d_bin_width != d_bin_width) {
+      throw std::invalid_argument("running_stats: Incompatible histograms");
+    }
+    if (other.d_count == 0) {
+      return;
+    }
+    const uint64_t n = d_count + other.d_count;
+    const double delta = other.d_mean - d_mean;
+    d_mean += delta * other.d_count / n;
+    d_m2 += other.d_m2 + delta * delta * d_count / n * other.d_count;
+    d_count = n;
+    d_min = std::min(d_min, other.d_min);
+    d_max = std::max(d_max, other.d_max);
+    for (size_t i = 0; i < d_hist.size(); i++) {
+      d_hist[i] += other.d_hist[i];
+    }
+  }
+
+  uint64_t
+  count() const
+  {
+    return d_count;
+  }
+
+  double
+  mean() const
+  {
+    return d_count ? d_mean : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  /*!
+   * \brief Get the sample variance
+   */
+  double
+  variance() const
+  {
+    return d_count > 1 ? d_m2 / (d_count - 1) : 0.0;
+  }
+
+  double
+  min() const
+  {
+    return d_count ? d_min : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  double
+  max() const
+  {
+    return d_count ? d_max : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  /*!
+   * \brief Estimate a percentile, interpolating linearly inside the bin
+   * \param p the percentile in the range [0, 100]
+   * \return the estimate, limited to the minimum and the maximum value.
+   * NaN if nothing has been recorded yet.
+   */
+  double
+  percentile(double p) const
+  {
+    if (d_count == 0) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double target = std::min(std::max(p, 0.0), 100.0) / 100.0 * d_count;
+    uint64_t cumulative = 0;
+    size_t i = 0;
+    for (; i < d_hist.size() - 1; i++) {
+      if (cumulative + d_hist[i] >= target && d_hist[i] > 0) {
+        break;
+      }
+      cumulative += d_hist[i];
+    }
+    const double frac = d_hist[i] ? (target - cumulative) / d_hist[i] : 0.0;
+    const double x = d_lo + (i + frac) * d_bin_width;
+    return std::min(std::max(x, d_min), d_max);
+  }
+
+private:
+  double d_lo;
+  double d_bin_width;
+  std::vector<uint64_t> d_hist;
+  uint64_t d_count;
+  double d_mean;
+  double d_m2;
+  double d_min;
+  double d_max;
+
+  size_t
+  bin(double x) const
+  {
+    const double i = std::floor((x - d_lo) / d_bin_width);
+    if (!(i > 0)) {
+      return 0;
+    }
+    return std::min(static_cast<size_t>(i), d_hist.size() - 1);
+  }
+};
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_RUNNING_STATS_H */
@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_SEQLOCK_H
+#define INCLUDED_LEO_UTILS_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief Single writer, multiple reader sequence lock for trivially copyable
+ * objects.
+ *
+ * \details
+ * The writer never waits and the readers never block the writer. A reader
+ * that races with a write detects it through the sequence counter and
+ * retries a bounded number of times, so the signal processing thread can
+ * keep its previous copy instead of waiting.
+ *
+ * The payload is stored as relaxed atomic words, so concurrent accesses are
+ * well defined.
+ */
+template <typename T>
+class seqlock {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "seqlock requires a trivially copyable type");
+
+public:
+  seqlock() : d_seq(0)
+  {
+    for (size_t i = 0; i < NWORDS; i++) {
+      d_words[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief Publish a new value. Only one thread may call this method.
+   */
+  void
+  store(const T &val)
+  {
+    uint64_t words[NWORDS] = {0};
+    std::memcpy(words, &val, sizeof(T));
+
+    const uint32_t seq = d_seq.load(std::memory_order_relaxed);
+    d_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < NWORDS; i++) {
+      d_words[i].store(words[i], std::memory_order_relaxed);
+    }
+    d_seq.store(seq + 2, std::memory_order_release);
+  }
+
+  /*!
+   * \brief Try to read a consistent copy of the last published value.
+   * \param val the destination of the copy. It is left untouched on failure.
+   * \param retries the number of attempts before giving up
+   * \return true if a consistent copy was obtained and a value has ever
+   * been published, false otherwise
+   */
+  bool
+  try_load(T &val, size_t retries = 4) const
+  {
+    uint64_t words[NWORDS];
+    for (size_t r = 0; r < retries; r++) {
+      const uint32_t seq0 = d_seq.load(std::memory_order_acquire);
+      if (seq0 & 1) {
+        continue;
+      }
+      for (size_t i = 0; i < NWORDS; i++) {
+        words[i] = d_words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (d_seq.load(std::memory_order_relaxed) == seq0) {
+        if (seq0 == 0) {
+          return false;
+        }
+        std::memcpy(&val, words, sizeof(T));
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  static constexpr size_t NWORDS = (sizeof(T) + sizeof(uint64_t) - 1) /
+                                   sizeof(uint64_t);
+
+  std::atomic<uint32_t> d_seq;
+  std::atomic<uint64_t> d_words[NWORDS];
+};
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_SEQLOCK_H */
@@ -0,0 +1,106 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_SPSC_QUEUE_H
+#define INCLUDED_LEO_UTILS_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief Bounded, lock-free, single producer single consumer queue.
+ *
+ * \details
+ * The storage is allocated once at construction. Neither push() nor pop()
+ * ever block, they just report whether the queue was full or empty.
+ */
+template <typename T>
+class spsc_queue {
+public:
+  /*!
+   * \param capacity the maximum number of queued elements
+   */
+  explicit spsc_queue(size_t capacity) :
+    d_buf(capacity + 1),
+    d_head(0),
+    d_tail(0)
+  {
+  }
+
+  /*!
+   * \brief Producer side. Appends a copy of \p val.
+   * \return false if the queue is full
+   */
+  bool
+  push(const T &val)
+  {
+    const size_t tail = d_tail.load(std::memory_order_relaxed);
+    const size_t next = (tail + 1) % d_buf.size();
+    if (next == d_head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    d_buf[tail] = val;
+    d_tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * \brief Consumer side. Removes the oldest element into \p val.
+   * \return false if the queue is empty
+   */
+  bool
+  pop(T &val)
+  {
+    const size_t head = d_head.load(std::memory_order_relaxed);
+    if (head == d_tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    val = d_buf[head];
+    d_head.store((head + 1) % d_buf.size(), std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * \brief Drop all the queued elements. It is safe only when neither the
+   * producer nor the consumer are active.
+   */
+  void
+  clear()
+  {
+    d_head.store(0, std::memory_order_relaxed);
+    d_tail.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::vector<T> d_buf;
+  std::atomic<size_t> d_head;
+  std::atomic<size_t> d_tail;
+};
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_SPSC_QUEUE_H */
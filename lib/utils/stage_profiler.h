@@ -0,0 +1,149 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_STAGE_PROFILER_H
+#define INCLUDED_LEO_UTILS_STAGE_PROFILER_H
+
+#include <gnuradio/leo/leo_types.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+ * The instrumentation is compiled in only if LEO_PROFILING is set, through
+ * the ENABLE_PROFILING CMake option. Otherwise LEO_PROFILE() expands to
+ * nothing and the statistics are always empty.
+ */
+#ifndef LEO_PROFILING
+#define LEO_PROFILING 0
+#endif
+
+#define LEO_PROFILE_CAT_(A, B) A##B
+#define LEO_PROFILE_CAT(A, B) LEO_PROFILE_CAT_(A, B)
+
+#if LEO_PROFILING
+#define LEO_PROFILE(PROFILER, STAGE)                                           \
+        gr::leo::utils::stage_profiler::scope                                 \
+        LEO_PROFILE_CAT(leo_profile_scope_, __LINE__)(PROFILER, STAGE)
+#else
+#define LEO_PROFILE(PROFILER, STAGE)
+#endif
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief Accumulates the number of invocations and the time spent in a
+ * fixed set of named processing stages.
+ *
+ * \details
+ * Each stage is a pair of relaxed atomic counters, so the stages may be
+ * updated from different threads and read at any time.
+ */
+class stage_profiler {
+public:
+  /*!
+   * \brief Times a scope and accounts it to a stage
+   */
+  class scope {
+  public:
+    scope(stage_profiler &prof, size_t stage) :
+      d_prof(prof),
+      d_stage(stage),
+      d_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~scope()
+    {
+      d_prof.add(d_stage, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - d_start).count());
+    }
+
+  private:
+    stage_profiler &d_prof;
+    const size_t d_stage;
+    const std::chrono::steady_clock::time_point d_start;
+  };
+
+  /*!
+   * \param names the name of each stage. The stage identifiers used with
+   * LEO_PROFILE() are the indices of this vector.
+   */
+  explicit stage_profiler(const std::vector<std::string> &names) :
+    d_names(names),
+    d_calls(names.size()),
+    d_ns(names.size())
+  {
+    reset();
+  }
+
+  void
+  add(size_t stage, int64_t ns)
+  {
+    d_calls[stage].fetch_add(1, std::memory_order_relaxed);
+    d_ns[stage].fetch_add(ns, std::memory_order_relaxed);
+  }
+
+  void
+  reset()
+  {
+    for (size_t i = 0; i < d_names.size(); i++) {
+      d_calls[i].store(0, std::memory_order_relaxed);
+      d_ns[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief Get the statistics of the stages that have been invoked
+   * at least once
+   */
+  std::map<std::string, stage_stats_t>
+  get_stats() const
+  {
+    std::map<std::string, stage_stats_t> stats;
+    for (size_t i = 0; i < d_names.size(); i++) {
+      const uint64_t calls = d_calls[i].load(std::memory_order_relaxed);
+      if (calls == 0) {
+        continue;
+      }
+      stage_stats_t s;
+      s.calls = calls;
+      s.total_us = d_ns[i].load(std::memory_order_relaxed) / 1e3;
+      stats[d_names[i]] = s;
+    }
+    return stats;
+  }
+
+private:
+  const std::vector<std::string> d_names;
+  std::vector<std::atomic<uint64_t>> d_calls;
+  std::vector<std::atomic<int64_t>> d_ns;
+};
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_STAGE_PROFILER_H */
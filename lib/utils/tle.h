@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * gr-leo: SatNOGS GNU Radio Out-Of-Tree Module
+ *
+ *  Copyright (C) 2018, Libre Space Foundation <https://libre.space/>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_LEO_UTILS_TLE_H
+#define INCLUDED_LEO_UTILS_TLE_H
+
+#include <string>
+
+namespace gr {
+namespace leo {
+namespace utils {
+
+/*!
+ * \brief Compute the checksum of a TLE line: the sum of its first 68 digits
+ * modulo 10, with the minus signs counting as 1
+ * \param line the TLE line, at least 68 characters long
+ */
+inline int
+tle_checksum(const std::string &line)
+{
+  int sum = 0;
+  for (size_t i = 0; i < 68; i++) {
+    if (line[i] >= '0' && line[i] <= '9') {
+      sum += line[i] - '0';
+    }
+    else if (line[i] == '-') {
+      sum++;
+    }
+  }
+  return sum % 10;
+}
+
+} // namespace utils
+} // namespace leo
+} // namespace gr
+
+#endif /* INCLUDED_LEO_UTILS_TLE_H */
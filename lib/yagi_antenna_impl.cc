@@ -49,6 +49,10 @@ yagi_antenna_impl::yagi_antenna_impl(antenna_t type, double frequency,
   d_boom_length(boom_length)
 {
   d_optimum_elements = find_optimum_elements();
+  d_gain = find_gain();
+  d_beamwidth = std::sqrt(40000 / std::pow(10, d_gain / 10));
+  d_rolloff_scale = 79.76 / d_beamwidth;
+  update_gain_rolloff();
   LEO_DEBUG("Yagi");
   LEO_DEBUG("Maximum Gain: %f", get_gain());
   LEO_DEBUG("Beamwidth: %f", get_beamwidth());
@@ -60,6 +64,12 @@ yagi_antenna_impl::~yagi_antenna_impl()
 
 double
 yagi_antenna_impl::get_gain()
+{
+  return d_gain;
+}
+
+double
+yagi_antenna_impl::find_gain()
 {
   for (size_t i = 0; i < d_yagi_performance.size(); i++) {
     if (std::get<0> (d_yagi_performance[i]) > d_boom_length) {
@@ -72,8 +82,14 @@ yagi_antenna_impl::get_gain()
 double
 yagi_antenna_impl::get_gain_rolloff()
 {
-  double error_deg = utils::radians_to_degrees(d_pointing_error);
-  double tmp = 2 * error_deg * (79.76 / get_beamwidth());
+  return d_gain_rolloff;
+}
+
+double
+yagi_antenna_impl::get_gain_rolloff(double theta, double phi)
+{
+  double error_deg = utils::radians_to_degrees(theta);
+  double tmp = 2 * error_deg * d_rolloff_scale;
   if (error_deg > 0) {
     return -10
            * std::log10(
@@ -89,7 +105,7 @@ yagi_antenna_impl::get_gain_rolloff()
 double
 yagi_antenna_impl::get_beamwidth()
 {
-  return sqrt(40000 / std::pow(10, get_gain() / 10));
+  return d_beamwidth;
 }
 
 double
@@ -70,6 +70,9 @@ public:
   double
   get_gain_rolloff();
 
+  double
+  get_gain_rolloff(double theta, double phi);
+
   /*!
    * \brief Get the beamwidth of the yagi antenna. This is the implementation
    * of the parent's pure virtual function for the yagi antenna.
@@ -117,6 +120,10 @@ private:
 
   double d_boom_length;
   size_t d_optimum_elements;
+  double d_gain;
+  double d_beamwidth;
+  /* Scales twice the pointing error in degrees to the roll-off argument */
+  double d_rolloff_scale;
 
   /*!
    * \brief Find the optimum number of elemets based on the lookup table d_yagi_performance
@@ -127,6 +134,14 @@ private:
   double
   find_optimum_elements();
 
+  /*!
+   * \brief Find the maximum gain based on the lookup table d_yagi_performance.
+   *
+   * \return the gain in dBiC.
+   */
+  double
+  find_gain();
+
 };
 } // namespace antenna
 } // namespace leo
@@ -37,7 +37,10 @@ void bind_antenna_pointing_loss(py::module& m)
         .def_static("make",
              &antenna_pointing_loss::make,
              py::arg("tracker_antenna"),
-             py::arg("satellite_antenna"))
+             py::arg("satellite_antenna"),
+             py::arg("mode") = ::gr::leo::ANTENNA_POINTING_LOSS,
+             py::arg("rotator") = nullptr,
+             py::arg("attitude") = nullptr)
 
         ;
 }
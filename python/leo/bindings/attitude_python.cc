@@ -0,0 +1,85 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(attitude.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(0)                                                    */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/leo/attitude.h>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+void bind_attitude(py::module& m)
+{
+
+    using attitude = ::gr::leo::attitude;
+
+    py::class_<attitude, std::shared_ptr<attitude>>(m, "attitude")
+
+        .def_static("make",
+             &attitude::make,
+             py::arg("mode"),
+             py::arg("rate") = 0,
+             py::arg("axis_ra") = 0,
+             py::arg("axis_dec") = 90,
+             py::arg("seed") = 0)
+
+        .def("update",
+             &attitude::update,
+             py::arg("time"),
+             py::arg("state"))
+
+        .def("off_boresight_batch",
+             [](const attitude &a, const std::vector<double> &time,
+                const std::vector<double> &sat_position,
+                const std::vector<double> &sat_velocity,
+                const std::vector<double> &gs_position) {
+                 const size_t n = time.size();
+                 if (sat_position.size() != 3 * n
+                     || sat_velocity.size() != 3 * n
+                     || gs_position.size() != 3 * n) {
+                     throw std::invalid_argument(
+                         "attitude: the vectors must hold 3 * len(time) elements");
+                 }
+                 std::vector<double> theta(n);
+                 std::vector<double> phi(n);
+                 a.off_boresight_batch(n, time.data(), sat_position.data(),
+                                       sat_velocity.data(), gs_position.data(),
+                                       theta.data(), phi.data());
+                 return std::make_pair(theta, phi);
+             },
+             py::arg("time"),
+             py::arg("sat_position"),
+             py::arg("sat_velocity"),
+             py::arg("gs_position"))
+
+        .def("get_off_boresight",
+             &attitude::get_off_boresight)
+
+        .def("get_azimuth",
+             &attitude::get_azimuth)
+
+        .def("get_mode",
+             &attitude::get_mode)
+        ;
+
+}
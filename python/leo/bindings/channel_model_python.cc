@@ -32,7 +32,6 @@ void bind_channel_model(py::module& m)
 
 
     py::class_<channel_model,
-          gr::sync_block,
           gr::block,
           gr::basic_block,
           std::shared_ptr<channel_model>>(m, "channel_model")
@@ -43,7 +42,27 @@ void bind_channel_model(py::module& m)
              py::arg("model"),
              py::arg("noise_type"),
              py::arg("store_csv"),
-             py::arg("filename"))
+             py::arg("filename"),
+             py::arg("los_mode") = gr::leo::LOS_SIMULATE,
+             py::arg("time_scale") = 1.0,
+             py::arg("time_source") = gr::leo::TIME_SIMULATED,
+             py::arg("precompute_windows") = 0)
+
+        .def("work_latency_percentiles",
+             &channel_model::work_latency_percentiles,
+             py::arg("percentiles"))
+
+        .def("work_latency_count",
+             &channel_model::work_latency_count)
+
+        .def("reset_work_latency",
+             &channel_model::reset_work_latency)
+
+        .def("get_stats",
+             &channel_model::get_stats)
+
+        .def("reset_stats",
+             &channel_model::reset_stats)
 
         ;
 
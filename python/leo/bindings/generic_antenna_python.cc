@@ -57,10 +57,12 @@ void bind_generic_antenna(py::module& m)
              &generic_antenna::get_beamwidth)
 
         .def("get_gain_rolloff",
-             &generic_antenna::get_gain_rolloff)
+             py::overload_cast<>(&generic_antenna::get_gain_rolloff))
 
         .def("get_gain_rolloff",
-             &generic_antenna::get_gain_rolloff)
+             py::overload_cast<double, double>(&generic_antenna::get_gain_rolloff),
+             py::arg("theta"),
+             py::arg("phi"))
 
         ;
 
@@ -18,6 +18,7 @@
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -25,7 +26,30 @@ namespace py = pybind11;
 
 #include <gnuradio/leo/satellite.h>
 #include <gnuradio/leo/generic_attenuation.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
 
+namespace {
+
+using double_array =
+    py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+/* Broadcasts a single element array to n elements */
+const double* broadcast(const double_array& a, size_t n, std::vector<double>& storage)
+{
+    if (static_cast<size_t>(a.size()) == n) {
+        return a.data();
+    }
+    if (a.size() != 1) {
+        throw std::invalid_argument(
+            "get_attenuation_batch: the arrays must have the same size or a single element");
+    }
+    storage.assign(n, *a.data());
+    return storage.data();
+}
+
+} // namespace
 
 void bind_generic_attenuation(py::module& m)
 {
@@ -53,9 +77,43 @@ void bind_generic_attenuation(py::module& m)
              &generic_attenuation::set_frequency,
              py::arg("freq"))
 
+        .def_static("set_time",
+             &generic_attenuation::set_time,
+             py::arg("t"))
+
         .def("get_attenuation",
              &generic_attenuation::get_attenuation)
 
+        .def("get_attenuation_batch",
+             py::overload_cast<const std::vector<double>&>(
+                 &generic_attenuation::get_attenuation_batch),
+             py::arg("elevation"))
+
+        .def("get_attenuation_batch",
+             [](generic_attenuation& att,
+                const double_array& frequency,
+                const double_array& elevation,
+                const double_array& slant_range,
+                size_t nthreads) {
+                 const size_t n = static_cast<size_t>(std::max(
+                     { frequency.size(), elevation.size(), slant_range.size() }));
+                 std::vector<double> f_storage, e_storage, r_storage;
+                 const double* f = broadcast(frequency, n, f_storage);
+                 const double* e = broadcast(elevation, n, e_storage);
+                 const double* r = broadcast(slant_range, n, r_storage);
+                 py::array_t<double> out(n);
+                 double* o = out.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     att.get_attenuation_batch(o, f, e, r, n, nthreads);
+                 }
+                 return out;
+             },
+             py::arg("frequency"),
+             py::arg("elevation"),
+             py::arg("slant_range"),
+             py::arg("nthreads") = 0)
+
         ;
 
 }
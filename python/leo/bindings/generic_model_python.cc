@@ -40,10 +40,37 @@ void bind_generic_model(py::module& m)
              py::arg("noutput_items"),
              py::arg("samp_rate"))
 
+        .def("forecast",
+             &generic_model::forecast,
+             py::arg("noutput_items"))
+
+        .def("set_time_scale",
+             &generic_model::set_time_scale,
+             py::arg("time_scale"))
+
+        .def("get_time_scale",
+             &generic_model::get_time_scale)
+
         .def("advance_time",
              &generic_model::advance_time,
              py::arg("us"))
 
+        .def("update_state",
+             &generic_model::update_state)
+
+        .def("get_stats",
+             &generic_model::get_stats)
+
+        .def("reset_stats",
+             &generic_model::reset_stats)
+
+        .def("get_state",
+             &generic_model::get_state)
+
+        .def("set_state",
+             &generic_model::set_state,
+             py::arg("state"))
+
         .def("unique_id",
              &generic_model::unique_id)
 
@@ -46,7 +46,14 @@ void bind_leo_model(py::module& m)
              py::arg("enable_link_margin"),
              py::arg("surface_watervap_density") = 75,
              py::arg("temperature") = 0,
-             py::arg("rainfall_rate") = 25)
+             py::arg("rainfall_rate") = 25,
+             py::arg("time_compression_enum") = gr::leo::IMPAIRMENT_NONE,
+             py::arg("rotator") = nullptr,
+             py::arg("attitude") = nullptr,
+             py::arg("seed") = 0,
+             py::arg("rain_probability") = 5.0,
+             py::arg("fade_dynamics") = 2e-4,
+             py::arg("topographic_altitude") = false)
 
         ;
 }
@@ -18,16 +18,23 @@
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 namespace py = pybind11;
 
 #include <gnuradio/leo/leo_types.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 void bind_leo_types(py::module& m)
 {
+    /* pass_info_t is returned as a NumPy structured array */
+    PYBIND11_NUMPY_DTYPE(gr::leo::pass_info_t, aos, los, max_elevation_time,
+                         max_elevation, aos_azimuth, los_azimuth);
+
     py::class_<gr::leo::pass_details_t, std::shared_ptr<gr::leo::pass_details_t>>(
         m, "pass_details_t")
         .def(py::init<>())
@@ -40,6 +47,57 @@ void bind_leo_types(py::module& m)
              }
          );
 
+    py::class_<gr::leo::stage_stats_t>(m, "stage_stats_t")
+        .def(py::init<>())
+        .def_readwrite("calls", &gr::leo::stage_stats_t::calls)
+        .def_readwrite("total_us", &gr::leo::stage_stats_t::total_us)
+        .def("__repr__",
+             [](const gr::leo::stage_stats_t &s) {
+                 return "stage_stats_t(calls=" + std::to_string(s.calls) + ", total_us=" + std::to_string(s.total_us) + ")";
+             }
+         );
+
+    py::class_<gr::leo::eci_state_t>(m, "eci_state_t")
+        .def(py::init<>())
+        .def_property("sat_position",
+             [](const gr::leo::eci_state_t &s) {
+                 return std::vector<double>(s.sat_position, s.sat_position + 3);
+             },
+             [](gr::leo::eci_state_t &s, const std::vector<double> &v) {
+                 std::copy_n(v.begin(), std::min<size_t>(v.size(), 3), s.sat_position);
+             })
+        .def_property("sat_velocity",
+             [](const gr::leo::eci_state_t &s) {
+                 return std::vector<double>(s.sat_velocity, s.sat_velocity + 3);
+             },
+             [](gr::leo::eci_state_t &s, const std::vector<double> &v) {
+                 std::copy_n(v.begin(), std::min<size_t>(v.size(), 3), s.sat_velocity);
+             })
+        .def_property("gs_position",
+             [](const gr::leo::eci_state_t &s) {
+                 return std::vector<double>(s.gs_position, s.gs_position + 3);
+             },
+             [](gr::leo::eci_state_t &s, const std::vector<double> &v) {
+                 std::copy_n(v.begin(), std::min<size_t>(v.size(), 3), s.gs_position);
+             });
+
+    py::class_<gr::leo::model_state_t>(m, "model_state_t")
+        .def(py::init<>())
+        .def_readwrite("aos", &gr::leo::model_state_t::aos)
+        .def_readwrite("elapsed_ticks", &gr::leo::model_state_t::elapsed_ticks)
+        .def_readwrite("slant_range", &gr::leo::model_state_t::slant_range)
+        .def_readwrite("elevation", &gr::leo::model_state_t::elevation)
+        .def_readwrite("velocity", &gr::leo::model_state_t::velocity)
+        .def_readwrite("doppler_shift", &gr::leo::model_state_t::doppler_shift)
+        .def_readwrite("pathloss_attenuation", &gr::leo::model_state_t::pathloss_attenuation)
+        .def_readwrite("atmo_attenuation", &gr::leo::model_state_t::atmo_attenuation)
+        .def_readwrite("rainfall_attenuation", &gr::leo::model_state_t::rainfall_attenuation)
+        .def_readwrite("pointing_attenuation", &gr::leo::model_state_t::pointing_attenuation)
+        .def_readwrite("total_attenuation", &gr::leo::model_state_t::total_attenuation)
+        .def_readwrite("link_margin_db", &gr::leo::model_state_t::link_margin_db)
+        .def_readwrite("noise_floor", &gr::leo::model_state_t::noise_floor)
+        .def_readwrite("time_compression_ratio", &gr::leo::model_state_t::time_compression_ratio);
+
     py::enum_<gr::leo::impairment_enum_t>(m, "impairment_enum_t")
         .value("IMPAIRMENT_NONE", gr::leo::impairment_enum_t::IMPAIRMENT_NONE)
         .value("ATMO_GASES_ITU", gr::leo::impairment_enum_t::ATMO_GASES_ITU)
@@ -49,6 +107,10 @@ void bind_leo_types(py::module& m)
         .value("FREE_SPACE_PATH_LOSS", gr::leo::impairment_enum_t::FREE_SPACE_PATH_LOSS)
         .value("ANTENNA_POINTING_LOSS", gr::leo::impairment_enum_t::ANTENNA_POINTING_LOSS)
         .value("DOPPLER_SHIFT", gr::leo::impairment_enum_t::DOPPLER_SHIFT)
+        .value("TIME_COMPRESSION", gr::leo::impairment_enum_t::TIME_COMPRESSION)
+        .value("ATMO_GASES_ITU_ANNEX2", gr::leo::impairment_enum_t::ATMO_GASES_ITU_ANNEX2)
+        .value("PRECIPITATION_STATISTICAL", gr::leo::impairment_enum_t::PRECIPITATION_STATISTICAL)
+        .value("ANTENNA_POINTING_LOSS_GEOMETRIC", gr::leo::impairment_enum_t::ANTENNA_POINTING_LOSS_GEOMETRIC)
         .export_values();
 
     py::enum_<gr::leo::noise_t>(m, "noise_t")
@@ -72,6 +134,13 @@ void bind_leo_types(py::module& m)
         .value("MONOPOLE", gr::leo::antenna_t::MONOPOLE)
         .value("DIPOLE", gr::leo::antenna_t::DIPOLE)
         .value("QUADRIFILAR_HELIX", gr::leo::antenna_t::QUADRIFILAR_HELIX)
+        .value("PATTERN", gr::leo::antenna_t::PATTERN)
+        .export_values();
+
+    py::enum_<gr::leo::attitude_mode_t>(m, "attitude_mode_t")
+        .value("ATTITUDE_NADIR", gr::leo::attitude_mode_t::ATTITUDE_NADIR)
+        .value("ATTITUDE_SPIN", gr::leo::attitude_mode_t::ATTITUDE_SPIN)
+        .value("ATTITUDE_TUMBLING", gr::leo::attitude_mode_t::ATTITUDE_TUMBLING)
         .export_values();
 
     py::enum_<gr::leo::link_mode_t>(m, "link_mode_t")
@@ -79,9 +148,49 @@ void bind_leo_types(py::module& m)
         .value("DOWNLINK", gr::leo::link_mode_t::DOWNLINK)
         .export_values();
 
+    py::enum_<gr::leo::los_mode_t>(m, "los_mode_t")
+        .value("LOS_SIMULATE", gr::leo::los_mode_t::LOS_SIMULATE)
+        .value("LOS_ZEROS", gr::leo::los_mode_t::LOS_ZEROS)
+        .value("LOS_SKIP", gr::leo::los_mode_t::LOS_SKIP)
+        .export_values();
+
+    py::enum_<gr::leo::time_source_t>(m, "time_source_t")
+        .value("TIME_SIMULATED", gr::leo::time_source_t::TIME_SIMULATED)
+        .value("TIME_WALL_CLOCK", gr::leo::time_source_t::TIME_WALL_CLOCK)
+        .value("TIME_RX_TAGS", gr::leo::time_source_t::TIME_RX_TAGS)
+        .export_values();
+
+    py::enum_<gr::leo::log_level_t>(m, "log_level_t")
+        .value("LOG_LEVEL_TRACE", gr::leo::log_level_t::LOG_LEVEL_TRACE)
+        .value("LOG_LEVEL_DEBUG", gr::leo::log_level_t::LOG_LEVEL_DEBUG)
+        .value("LOG_LEVEL_INFO", gr::leo::log_level_t::LOG_LEVEL_INFO)
+        .value("LOG_LEVEL_WARN", gr::leo::log_level_t::LOG_LEVEL_WARN)
+        .value("LOG_LEVEL_ERROR", gr::leo::log_level_t::LOG_LEVEL_ERROR)
+        .value("LOG_LEVEL_OFF", gr::leo::log_level_t::LOG_LEVEL_OFF)
+        .export_values();
+
+    py::enum_<gr::leo::sweep_param_t>(m, "sweep_param_t")
+        .value("SWEEP_SAT_TX_POWER", gr::leo::sweep_param_t::SWEEP_SAT_TX_POWER)
+        .value("SWEEP_GS_TX_POWER", gr::leo::sweep_param_t::SWEEP_GS_TX_POWER)
+        .value("SWEEP_SAT_ANTENNA", gr::leo::sweep_param_t::SWEEP_SAT_ANTENNA)
+        .value("SWEEP_GS_ANTENNA", gr::leo::sweep_param_t::SWEEP_GS_ANTENNA)
+        .value("SWEEP_GS_POINTING_ERROR",
+               gr::leo::sweep_param_t::SWEEP_GS_POINTING_ERROR)
+        .value("SWEEP_NOISE_FIGURE", gr::leo::sweep_param_t::SWEEP_NOISE_FIGURE)
+        .value("SWEEP_FREQUENCY", gr::leo::sweep_param_t::SWEEP_FREQUENCY)
+        .value("SWEEP_RAINFALL_RATE", gr::leo::sweep_param_t::SWEEP_RAINFALL_RATE)
+        .value("SWEEP_GS_LATITUDE", gr::leo::sweep_param_t::SWEEP_GS_LATITUDE)
+        .value("SWEEP_GS_LONGITUDE", gr::leo::sweep_param_t::SWEEP_GS_LONGITUDE)
+        .value("SWEEP_GS_ALTITUDE", gr::leo::sweep_param_t::SWEEP_GS_ALTITUDE)
+        .export_values();
+
     py::implicitly_convertible<int, gr::leo::impairment_enum_t>();
     py::implicitly_convertible<int, gr::leo::noise_t>();
     py::implicitly_convertible<int, gr::leo::polarization_t>();
     py::implicitly_convertible<int, gr::leo::antenna_t>();
+    py::implicitly_convertible<int, gr::leo::attitude_mode_t>();
     py::implicitly_convertible<int, gr::leo::link_mode_t>();
+    py::implicitly_convertible<int, gr::leo::los_mode_t>();
+    py::implicitly_convertible<int, gr::leo::time_source_t>();
+    py::implicitly_convertible<int, gr::leo::sweep_param_t>();
 }
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(log.h)                                         */
+/* BINDTOOL_HEADER_FILE_HASH(0)                                                    */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/leo/log.h>
+
+void bind_log(py::module& m)
+{
+
+    using logging = ::gr::leo::logging;
+
+    py::class_<logging>(m, "logging")
+
+        .def_static("set_level",
+             &logging::set_level,
+             py::arg("level"))
+
+        .def_static("get_level",
+             &logging::get_level)
+
+        .def_static("set_rate_limit",
+             &logging::set_rate_limit,
+             py::arg("messages_per_sec"))
+
+        .def_static("get_rate_limit",
+             &logging::get_rate_limit)
+
+        .def_static("set_forward",
+             &logging::set_forward,
+             py::arg("forward"))
+
+        .def_static("set_ring_buffer",
+             &logging::set_ring_buffer,
+             py::arg("nrecords"))
+
+        .def_static("dump_ring_buffer",
+             &logging::dump_ring_buffer,
+             py::arg("filename") = "")
+
+        ;
+
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(monte_carlo.h)                                     */
+/* BINDTOOL_HEADER_FILE_HASH(0)                                                    */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/leo/monte_carlo.h>
+
+void bind_monte_carlo(py::module& m)
+{
+
+    using perturbation_t = ::gr::leo::perturbation_t;
+    using link_statistics_t = ::gr::leo::link_statistics_t;
+    using monte_carlo = ::gr::leo::monte_carlo;
+
+    py::class_<perturbation_t>(m, "perturbation_t")
+        .def(py::init<>())
+        .def_readwrite("rainfall_rate_sigma",
+                       &perturbation_t::rainfall_rate_sigma)
+        .def_readwrite("pointing_error_sigma",
+                       &perturbation_t::pointing_error_sigma)
+        .def_readwrite("tle_epoch_sigma", &perturbation_t::tle_epoch_sigma);
+
+    py::class_<link_statistics_t>(m, "link_statistics_t")
+        .def_readonly("count", &link_statistics_t::count)
+        .def_readonly("mean", &link_statistics_t::mean)
+        .def_readonly("stddev", &link_statistics_t::stddev)
+        .def_readonly("min", &link_statistics_t::min)
+        .def_readonly("max", &link_statistics_t::max)
+        .def_readonly("percentiles", &link_statistics_t::percentiles);
+
+    py::class_<monte_carlo, std::shared_ptr<monte_carlo>>(m, "monte_carlo")
+
+        .def_static("make",
+             &monte_carlo::make,
+             py::arg("scenario"),
+             py::arg("perturbation"),
+             py::arg("realizations"),
+             py::arg("outage_threshold_db") = 0,
+             py::arg("seed") = 0)
+
+        .def("run",
+             &monte_carlo::run,
+             py::arg("nthreads") = 0,
+             py::call_guard<py::gil_scoped_release>())
+
+        .def("get_passes",
+             &monte_carlo::get_passes)
+
+        .def("get_link_margin",
+             &monte_carlo::get_link_margin,
+             py::arg("percentiles") = std::vector<double>{5, 50, 95})
+
+        .def("get_min_link_margin",
+             &monte_carlo::get_min_link_margin,
+             py::arg("percentiles") = std::vector<double>{5, 50, 95})
+
+        .def("get_outage_fraction",
+             &monte_carlo::get_outage_fraction,
+             py::arg("percentiles") = std::vector<double>{5, 50, 95})
+
+        .def("get_outage_probability",
+             &monte_carlo::get_outage_probability)
+        ;
+
+    m.def("shift_tle_epoch",
+          &::gr::leo::shift_tle_epoch,
+          py::arg("tle_1"),
+          py::arg("seconds"));
+}
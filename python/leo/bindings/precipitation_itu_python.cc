@@ -40,7 +40,11 @@ void bind_precipitation_itu(py::module& m)
              py::arg("tracker_longtitude"),
              py::arg("tracker_latitude"),
              py::arg("tracker_altitude"),
-             py::arg("mode"))
+             py::arg("mode"),
+             py::arg("rain_probability") = 5.0,
+             py::arg("fade_dynamics") = 2e-4,
+             py::arg("seed") = 0,
+             py::arg("topographic_altitude") = false)
 
         ;
 }
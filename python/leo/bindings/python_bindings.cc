@@ -22,6 +22,7 @@ namespace py = pybind11;
 /**************************************/
 // BINDING_FUNCTION_PROTOTYPES(
 void bind_leo_types(py::module& m);
+void bind_log(py::module& m);
 void bind_generic_antenna(py::module& m);
 void bind_yagi_antenna(py::module& m);
 void bind_custom_antenna(py::module& m);
@@ -30,11 +31,15 @@ void bind_dipole_antenna(py::module& m);
 void bind_monopole_antenna(py::module& m);
 void bind_parabolic_reflector_antenna(py::module& m);
 void bind_quadrifilar_helix_antenna(py::module& m);
+void bind_pattern_antenna(py::module& m);
 void bind_satellite(py::module& m);
 void bind_tracker(py::module& m);
+void bind_rotator(py::module& m);
+void bind_attitude(py::module& m);
 void bind_generic_attenuation(py::module& m);
 void bind_atmospheric_gases_itu(py::module& m);
 void bind_atmospheric_gases_regression(py::module& m);
+void bind_atmospheric_gases_itu_annex2(py::module& m);
 void bind_free_space_path_loss(py::module& m);
 void bind_precipitation_itu(py::module& m);
 void bind_generic_noise(py::module& m);
@@ -44,6 +49,9 @@ void bind_link_margin(py::module& m);
 void bind_generic_model(py::module& m);
 void bind_leo_model(py::module& m);
 void bind_channel_model(py::module& m);
+void bind_scenario(py::module& m);
+void bind_monte_carlo(py::module& m);
+void bind_sweep(py::module& m);
 // ) END BINDING_FUNCTION_PROTOTYPES
 
 
@@ -73,6 +81,7 @@ PYBIND11_MODULE(leo_python, m)
     /**************************************/
     // BINDING_FUNCTION_CALLS(
     bind_leo_types(m);
+    bind_log(m);
     bind_generic_antenna(m);
     bind_yagi_antenna(m);
     bind_custom_antenna(m);
@@ -81,11 +90,15 @@ PYBIND11_MODULE(leo_python, m)
     bind_monopole_antenna(m);
     bind_parabolic_reflector_antenna(m);
     bind_quadrifilar_helix_antenna(m);
+    bind_pattern_antenna(m);
     bind_satellite(m);
     bind_tracker(m);
+    bind_rotator(m);
+    bind_attitude(m);
     bind_generic_attenuation(m);
     bind_atmospheric_gases_itu(m);
     bind_atmospheric_gases_regression(m);
+    bind_atmospheric_gases_itu_annex2(m);
     bind_free_space_path_loss(m);
     bind_precipitation_itu(m);
     bind_generic_noise(m);
@@ -95,5 +108,8 @@ PYBIND11_MODULE(leo_python, m)
     bind_generic_model(m);
     bind_leo_model(m);
     bind_channel_model(m);
+    bind_scenario(m);
+    bind_monte_carlo(m);
+    bind_sweep(m);
     // ) END BINDING_FUNCTION_CALLS
 }
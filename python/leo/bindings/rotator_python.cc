@@ -0,0 +1,63 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(rotator.h)                                         */
+/* BINDTOOL_HEADER_FILE_HASH(0)                                                    */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/leo/rotator.h>
+
+void bind_rotator(py::module& m)
+{
+
+    using rotator = ::gr::leo::rotator;
+
+    py::class_<rotator, std::shared_ptr<rotator>>(m, "rotator")
+
+        .def_static("make",
+             &rotator::make,
+             py::arg("max_az_rate"),
+             py::arg("max_el_rate"),
+             py::arg("backlash") = 0,
+             py::arg("update_interval") = 1,
+             py::arg("az_range") = 360,
+             py::arg("max_elevation") = 90)
+
+        .def("update",
+             &rotator::update,
+             py::arg("time"),
+             py::arg("azimuth"),
+             py::arg("elevation"))
+
+        .def("reset",
+             &rotator::reset)
+
+        .def("get_pointing_error",
+             &rotator::get_pointing_error)
+
+        .def("get_azimuth",
+             &rotator::get_azimuth)
+
+        .def("get_elevation",
+             &rotator::get_elevation)
+        ;
+
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(scenario.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(0)                                                    */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/leo/scenario.h>
+#include <stdexcept>
+#include <vector>
+
+void bind_scenario(py::module& m)
+{
+
+    using antenna_config_t = ::gr::leo::antenna_config_t;
+    using scenario_t = ::gr::leo::scenario_t;
+
+    py::class_<antenna_config_t>(m, "antenna_config_t")
+        .def(py::init<>())
+        .def_readwrite("type", &antenna_config_t::type)
+        .def_readwrite("polarization", &antenna_config_t::polarization)
+        .def_readwrite("pointing_error", &antenna_config_t::pointing_error)
+        .def_property("params",
+             [](const antenna_config_t &c) {
+                 return std::vector<double>(c.params, c.params + 3);
+             },
+             [](antenna_config_t &c, const std::vector<double> &p) {
+                 if (p.size() > 3) {
+                     throw std::invalid_argument(
+                         "antenna_config_t: at most 3 parameters");
+                 }
+                 for (size_t i = 0; i < 3; i++) {
+                     c.params[i] = i < p.size() ? p[i] : 0.0;
+                 }
+             })
+        .def_readwrite("pattern_file", &antenna_config_t::pattern_file);
+
+    py::class_<scenario_t>(m, "scenario_t")
+        .def(py::init<>())
+        .def_readwrite("name", &scenario_t::name)
+        .def_readwrite("tle_title", &scenario_t::tle_title)
+        .def_readwrite("tle_1", &scenario_t::tle_1)
+        .def_readwrite("tle_2", &scenario_t::tle_2)
+        .def_readwrite("sat_tx_power_dbm", &scenario_t::sat_tx_power_dbm)
+        .def_readwrite("sat_antenna", &scenario_t::sat_antenna)
+        .def_readwrite("sat_noise_figure", &scenario_t::sat_noise_figure)
+        .def_readwrite("sat_noise_temp", &scenario_t::sat_noise_temp)
+        .def_readwrite("sat_rx_bw", &scenario_t::sat_rx_bw)
+        .def_readwrite("gs_lat", &scenario_t::gs_lat)
+        .def_readwrite("gs_lon", &scenario_t::gs_lon)
+        .def_readwrite("gs_alt", &scenario_t::gs_alt)
+        .def_readwrite("gs_topographic_alt", &scenario_t::gs_topographic_alt)
+        .def_readwrite("gs_tx_power_dbm", &scenario_t::gs_tx_power_dbm)
+        .def_readwrite("gs_antenna", &scenario_t::gs_antenna)
+        .def_readwrite("gs_noise_figure", &scenario_t::gs_noise_figure)
+        .def_readwrite("gs_noise_temp", &scenario_t::gs_noise_temp)
+        .def_readwrite("gs_rx_bw", &scenario_t::gs_rx_bw)
+        .def_readwrite("obs_start", &scenario_t::obs_start)
+        .def_readwrite("obs_end", &scenario_t::obs_end)
+        .def_readwrite("time_step_us", &scenario_t::time_step_us)
+        .def_readwrite("uplink_freq", &scenario_t::uplink_freq)
+        .def_readwrite("downlink_freq", &scenario_t::downlink_freq)
+        .def_readwrite("mode", &scenario_t::mode)
+        .def_readwrite("fspl", &scenario_t::fspl)
+        .def_readwrite("pointing", &scenario_t::pointing)
+        .def_readwrite("doppler", &scenario_t::doppler)
+        .def_readwrite("atmo", &scenario_t::atmo)
+        .def_readwrite("precipitation", &scenario_t::precipitation)
+        .def_readwrite("surface_watervap_density",
+                       &scenario_t::surface_watervap_density)
+        .def_readwrite("temperature", &scenario_t::temperature)
+        .def_readwrite("rainfall_rate", &scenario_t::rainfall_rate)
+        .def_readwrite("rain_probability", &scenario_t::rain_probability)
+        .def_readwrite("fade_dynamics", &scenario_t::fade_dynamics)
+        .def_readwrite("seed", &scenario_t::seed);
+
+    py::module m_scenario = m.def_submodule("scenario");
+
+    m_scenario.def("make_antenna",
+                   &::gr::leo::scenario::make_antenna,
+                   py::arg("config"),
+                   py::arg("frequency"));
+
+    m_scenario.def("make_tracker",
+                   &::gr::leo::scenario::make_tracker,
+                   py::arg("scenario"));
+
+    m_scenario.def("make_model",
+                   &::gr::leo::scenario::make_model,
+                   py::arg("scenario"),
+                   py::arg("tracker") = nullptr);
+
+    m_scenario.def("load",
+                   &::gr::leo::scenario::load,
+                   py::arg("filename"));
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(sweep.h)                                           */
+/* BINDTOOL_HEADER_FILE_HASH(0)                                                    */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/leo/sweep.h>
+#include <algorithm>
+#include <vector>
+
+void bind_sweep(py::module& m)
+{
+
+    using sweep_axis_t = ::gr::leo::sweep_axis_t;
+    using sweep_result_t = ::gr::leo::sweep_result_t;
+    using link_timeline_t = ::gr::leo::link_timeline_t;
+    using sweep = ::gr::leo::sweep;
+
+    py::class_<sweep_axis_t>(m, "sweep_axis_t")
+        .def(py::init<>())
+        .def(py::init([](gr::leo::sweep_param_t param,
+                         const std::vector<double> &values) {
+                 return sweep_axis_t{param, values};
+             }),
+             py::arg("param"),
+             py::arg("values"))
+        .def_readwrite("param", &sweep_axis_t::param)
+        .def_readwrite("values", &sweep_axis_t::values);
+
+    py::class_<sweep_result_t>(m, "sweep_result_t")
+        .def_readonly("visible_steps", &sweep_result_t::visible_steps)
+        .def_readonly("min_link_margin", &sweep_result_t::min_link_margin)
+        .def_readonly("mean_link_margin", &sweep_result_t::mean_link_margin)
+        .def_readonly("max_link_margin", &sweep_result_t::max_link_margin)
+        .def_readonly("outage_fraction", &sweep_result_t::outage_fraction);
+
+    py::class_<link_timeline_t>(m, "link_timeline_t")
+        .def_readonly("time", &link_timeline_t::time)
+        .def_readonly("azimuth", &link_timeline_t::azimuth)
+        .def_readonly("elevation", &link_timeline_t::elevation)
+        .def_readonly("slant_range", &link_timeline_t::slant_range)
+        .def_readonly("doppler_shift", &link_timeline_t::doppler_shift)
+        .def_readonly("attenuation", &link_timeline_t::attenuation)
+        .def_readonly("link_margin", &link_timeline_t::link_margin);
+
+    py::class_<sweep, std::shared_ptr<sweep>>(m, "sweep")
+
+        .def_static("make",
+             &sweep::make,
+             py::arg("points"),
+             py::arg("outage_threshold_db") = 0)
+
+        .def_static("grid",
+             &sweep::grid,
+             py::arg("base"),
+             py::arg("axes"))
+
+        .def_static("set_param",
+             &sweep::set_param,
+             py::arg("scenario"),
+             py::arg("param"),
+             py::arg("value"))
+
+        .def("run",
+             &sweep::run,
+             py::arg("nthreads") = 0,
+             py::call_guard<py::gil_scoped_release>())
+
+        .def("get_results",
+             &sweep::get_results)
+
+        .def("get_link_margin",
+             &sweep::get_link_margin,
+             py::arg("point"))
+
+        .def("get_timeline",
+             &sweep::get_timeline,
+             py::arg("point"),
+             py::arg("visible_only") = true)
+
+        .def("get_passes",
+             [](const sweep& s, int pass_step, size_t nthreads) {
+                 std::vector<std::vector<gr::leo::pass_info_t>> passes;
+                 {
+                     py::gil_scoped_release release;
+                     passes = s.get_passes(pass_step, nthreads);
+                 }
+                 /* A structured array of pass_info_t per point */
+                 py::list out;
+                 for (const std::vector<gr::leo::pass_info_t>& p : passes) {
+                     py::array_t<gr::leo::pass_info_t> a(p.size());
+                     std::copy(p.begin(), p.end(), a.mutable_data());
+                     out.append(a);
+                 }
+                 return out;
+             },
+             py::arg("pass_step") = 60,
+             py::arg("nthreads") = 0)
+
+        .def("get_geometry_count",
+             &sweep::get_geometry_count)
+
+        .def("get_attenuation_count",
+             &sweep::get_attenuation_count)
+        ;
+}
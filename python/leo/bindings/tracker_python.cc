@@ -18,6 +18,7 @@
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -25,6 +26,38 @@ namespace py = pybind11;
 
 #include <gnuradio/leo/satellite.h>
 #include <gnuradio/leo/tracker.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+using time_array =
+    py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+/*
+ * Returns the range, range rate, azimuth and elevation arrays of the
+ * times, computed with the GIL released
+ */
+py::tuple geometry_batch(const gr::leo::tracker& t, const time_array& time)
+{
+    const size_t n = time.size();
+    py::array_t<double> range(n);
+    py::array_t<double> range_rate(n);
+    py::array_t<double> azimuth(n);
+    py::array_t<double> elevation(n);
+    const double* in = time.data();
+    double* r = range.mutable_data();
+    double* rr = range_rate.mutable_data();
+    double* az = azimuth.mutable_data();
+    double* el = elevation.mutable_data();
+    {
+        py::gil_scoped_release release;
+        t.get_geometry_batch(in, n, r, rr, az, el);
+    }
+    return py::make_tuple(range, range_rate, azimuth, elevation);
+}
+
+} // namespace
 
 void bind_tracker(py::module& m)
 {
@@ -71,6 +104,23 @@ void bind_tracker(py::module& m)
              &tracker::generate_passlist,
              py::arg("time_step"))
 
+        .def("generate_passes",
+             [](tracker& t, int time_step) {
+                 /*
+                  * The GIL is kept, since the search moves the tracker and
+                  * the tracker is not thread-safe
+                  */
+                 const std::vector<gr::leo::pass_info_t> passes =
+                     t.generate_passes(time_step);
+                 py::array_t<gr::leo::pass_info_t> out(passes.size());
+                 std::copy(passes.begin(), passes.end(), out.mutable_data());
+                 return out;
+             },
+             py::arg("time_step"))
+
+        .def("get_time_to_next_aos_us",
+             &tracker::get_time_to_next_aos_us)
+
         .def("get_satellite_info",
              &tracker::get_satellite_info)
 
@@ -83,9 +133,37 @@ void bind_tracker(py::module& m)
         .def("get_elevation_radians",
              &tracker::get_elevation_radians)
 
+        .def("get_azimuth_degrees",
+             &tracker::get_azimuth_degrees)
+
+        .def("get_azimuth_radians",
+             &tracker::get_azimuth_radians)
+
         .def("get_velocity",
              &tracker::get_velocity)
 
+        .def("get_eci_state",
+             &tracker::get_eci_state)
+
+        .def("get_geometry_batch",
+             [](const tracker& t, const time_array& time) {
+                 return geometry_batch(t, time);
+             },
+             py::arg("time"))
+
+        .def("get_geometry_batch",
+             [](const tracker& t, double start, double step, size_t count) {
+                 time_array time(count);
+                 double* p = time.mutable_data();
+                 for (size_t i = 0; i < count; i++) {
+                     p[i] = start + i * step;
+                 }
+                 return geometry_batch(t, time);
+             },
+             py::arg("start"),
+             py::arg("step"),
+             py::arg("count"))
+
         .def("get_time_resolution_us",
              &tracker::get_time_resolution_us)
 